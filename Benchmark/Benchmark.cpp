@@ -0,0 +1,511 @@
+﻿// opRaiseEvent のベンチマーク
+//
+// ループバックの仮想サーバ (NetworkSystem::CreateLoopbackNetwork) に接続した 2 つの SivPhoton を同じルームに入れ、
+// 送信側の opRaiseEvent から受信側の customEventAction までを、型と大きさごとに計測します。ネットワークも Photon のサーバも使いません。
+// 結果は JSON でコンソールと benchmark.json に出力します。
+//
+// - ns_per_op: 送信・配送・受信 (customEventAction の呼び出し) にかかった 1 イベントあたりの時間
+// - bytes_per_op: 1 イベントあたりのパック形式のバイト数 (NetworkStats::sentEvents, Photon のプロトコルのヘッダは含まない)
+// - allocs_per_op: 1 イベントあたりの operator new の呼び出し回数 (送信側と受信側の合計)
+// - delivered: 受信側で customEventAction が呼ばれた回数 (ops と一致しない場合は計測が正しくありません)
+//
+// ループバックの仮想サーバはバイト列のみを運ぶため、すべてのイベントはパック形式で送受信されます。
+// Photon の Hashtable で送る旧形式と、SivCustomType (Photon の CUSTOM 型) で送る Point, Vec2, Rect, Circle の受信経路は計測しません。
+//
+// ビルド方法: Main.cpp の代わりにこのファイルと NetworkSystem.cpp をプロジェクトに追加し、SIVPHOTON_BENCHMARK を定義してビルドします。
+// このファイルは Main() と、割り当て回数を数えるためのグローバルな operator new を定義するため、SIVPHOTON_BENCHMARK を定義しない場合は何もしません。
+
+# if defined(SIVPHOTON_BENCHMARK)
+
+# include "../NetworkSystem.hpp"
+# include <atomic>
+# include <chrono>
+# include <cstdlib>
+# include <new>
+
+namespace
+{
+	std::atomic<uint64> g_allocations{ 0 };
+}
+
+void* operator new(const std::size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+namespace
+{
+	/// @brief ユーザ定義型のイベントの計測に使う型
+	struct BenchmarkUnit
+	{
+		static constexpr uint32 TypeID = NetworkSystem::MakeTypeID(U"Benchmark.Unit");
+
+		int32 id = 0;
+
+		Vec2 pos{ 0, 0 };
+
+		String name;
+
+		template <class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(id, pos, name);
+		}
+	};
+
+	/// @brief 計測に使うイベントコード
+	constexpr uint8 BenchmarkEventCode = 1;
+
+	/// @brief 何イベントごとに送信側と受信側の update() を呼ぶか
+	constexpr size_t BatchSize = 64;
+
+	/// @brief 1 つの計測で送る要素数の目安 (要素数の少ないイベントほど多く送る)
+	constexpr size_t TargetElements = (1 << 20);
+
+	constexpr size_t MaxOperations = (1 << 14);
+
+	class BenchmarkClient : public SivPhoton
+	{
+	public:
+
+		using SivPhoton::SivPhoton;
+
+		bool connected = false;
+
+		size_t playersInRoom = 0;
+
+		void connectReturn(const int32 errorCode, const String&, const String&, const String&) override
+		{
+			connected = (errorCode == 0);
+		}
+
+		void joinRoomEventAction(int32, const Array<int32>& playerIDs, bool) override
+		{
+			playersInRoom = playerIDs.size();
+		}
+
+		/// @brief customEventAction が呼ばれた回数
+		uint64 delivered = 0;
+
+		using SivPhoton::customEventAction;
+
+		// std::span, GridView を受け取る customEventAction の既定の実装は、Array, Grid にコピーして以下を呼ぶ
+
+		void customEventAction(int32, int32, const int32) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const double) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const float) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const bool) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const String&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<int32>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<double>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<float>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<bool>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<String>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<int32>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<double>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<float>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<bool>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<String>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Point&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Vec2&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Rect&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Circle&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<Point>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<Vec2>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<Rect>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Array<Circle>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<Point>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<Vec2>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<Rect>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const Grid<Circle>&) override
+		{
+			++delivered;
+		}
+
+		void customEventAction(int32, int32, const NetworkSystem::SerializedValue&) override
+		{
+			++delivered;
+		}
+	};
+
+	class BenchmarkSession
+	{
+	public:
+
+		BenchmarkSession()
+			: m_network{ NetworkSystem::CreateLoopbackNetwork() }
+			, m_sender{ m_network }
+			, m_receiver{ m_network } {}
+
+		[[nodiscard]]
+		bool open()
+		{
+			m_sender.connect(U"sender");
+			m_receiver.connect(U"receiver");
+
+			if (not pumpUntil([&]() { return (m_sender.connected && m_receiver.connected); }))
+			{
+				return false;
+			}
+
+			m_sender.opCreateRoom(U"benchmark", 2);
+
+			if (not pumpUntil([&]() { return m_sender.isInRoom(); }))
+			{
+				return false;
+			}
+
+			m_receiver.opJoinRoom(U"benchmark");
+
+			return pumpUntil([&]() { return (m_receiver.isInRoom() && (m_sender.playersInRoom == 2)); });
+		}
+
+		template <class Type>
+		void run(const StringView name, const size_t elements, const Type& value)
+		{
+			const size_t operations = Clamp(((TargetElements / Max<size_t>(elements, 1)) / BatchSize * BatchSize), BatchSize, MaxOperations);
+
+			// 文字列表やバッファの確保を計測に含めない
+			send(value, BatchSize);
+
+			const NetworkSystem::EventTraffic sent = m_sender.getNetworkStats().sentEvents[BenchmarkEventCode];
+			const uint64 delivered = m_receiver.delivered;
+			const uint64 allocations = g_allocations.load(std::memory_order_relaxed);
+			const auto start = std::chrono::steady_clock::now();
+
+			send(value, operations);
+
+			const auto end = std::chrono::steady_clock::now();
+			const uint64 allocated = (g_allocations.load(std::memory_order_relaxed) - allocations);
+			const NetworkSystem::EventTraffic sentAfter = m_sender.getNetworkStats().sentEvents[BenchmarkEventCode];
+			const double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+			JSON result;
+			result[U"name"] = String{ name };
+			result[U"elements"] = static_cast<uint64>(elements);
+			result[U"ops"] = static_cast<uint64>(operations);
+			result[U"ns_per_op"] = (nanoseconds / operations);
+			result[U"bytes_per_op"] = (static_cast<double>(sentAfter.bytes - sent.bytes) / operations);
+			result[U"allocs_per_op"] = (static_cast<double>(allocated) / operations);
+			result[U"delivered"] = (m_receiver.delivered - delivered);
+			m_results.push_back(result);
+		}
+
+		[[nodiscard]]
+		JSON toJSON() const
+		{
+			JSON json;
+			json[U"benchmark"] = U"SivPhoton.opRaiseEvent";
+			json[U"transport"] = U"loopback";
+			json[U"results"] = m_results;
+			return json;
+		}
+
+	private:
+
+		std::shared_ptr<NetworkSystem::LoopbackNetwork> m_network;
+
+		BenchmarkClient m_sender;
+
+		BenchmarkClient m_receiver;
+
+		/// @brief 計測結果の JSON の配列
+		JSON m_results = JSON{ Array<JSON>{} };
+
+		template <class Predicate>
+		[[nodiscard]]
+		bool pumpUntil(Predicate predicate)
+		{
+			for (int32 i = 0; i < 100; ++i)
+			{
+				if (predicate())
+				{
+					return true;
+				}
+
+				m_sender.update();
+				m_receiver.update();
+			}
+
+			return predicate();
+		}
+
+		template <class Type>
+		void send(const Type& value, const size_t operations)
+		{
+			for (size_t i = 0; i < operations; ++i)
+			{
+				m_sender.opRaiseEvent(BenchmarkEventCode, value);
+
+				if (((i + 1) % BatchSize) == 0)
+				{
+					m_sender.update();
+					m_receiver.update();
+				}
+			}
+
+			m_sender.update();
+			m_receiver.update();
+		}
+	};
+
+	template <class Type>
+	[[nodiscard]]
+	Type MakeElement(const size_t i)
+	{
+		if constexpr (std::is_same_v<Type, bool>)
+		{
+			return ((i % 2) == 0);
+		}
+		else if constexpr (std::is_arithmetic_v<Type>)
+		{
+			return static_cast<Type>(i);
+		}
+		else if constexpr (std::is_same_v<Type, String>)
+		{
+			return U"element{}"_fmt(i % 64);
+		}
+		else if constexpr (std::is_same_v<Type, Point>)
+		{
+			return Point{ static_cast<int32>(i), static_cast<int32>(i * 2) };
+		}
+		else if constexpr (std::is_same_v<Type, Vec2>)
+		{
+			return Vec2{ (i * 0.5), (i * 0.25) };
+		}
+		else if constexpr (std::is_same_v<Type, Rect>)
+		{
+			return Rect{ static_cast<int32>(i), static_cast<int32>(i * 2), 32, 32 };
+		}
+		else if constexpr (std::is_same_v<Type, Circle>)
+		{
+			return Circle{ (i * 0.5), (i * 0.25), 8.0 };
+		}
+		else
+		{
+			return BenchmarkUnit{ static_cast<int32>(i), Vec2{ (i * 0.5), (i * 0.25) }, U"unit{}"_fmt(i % 64) };
+		}
+	}
+
+	template <class Type>
+	[[nodiscard]]
+	Array<Type> MakeArray(const size_t size)
+	{
+		Array<Type> values;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			values << MakeElement<Type>(i);
+		}
+
+		return values;
+	}
+
+	template <class Type>
+	[[nodiscard]]
+	Grid<Type> MakeGrid(const int32 size)
+	{
+		Grid<Type> values(size, size);
+
+		for (int32 y = 0; y < size; ++y)
+		{
+			for (int32 x = 0; x < size; ++x)
+			{
+				values[Point{ x, y }] = MakeElement<Type>(static_cast<size_t>(y * size + x));
+			}
+		}
+
+		return values;
+	}
+
+	/// @brief 要素の型について、値ひとつ、Array, Grid を大きさを変えて計測します。
+	template <class Type>
+	void RunElement(BenchmarkSession& session, const StringView name, const Array<size_t>& arraySizes, const Array<int32>& gridSizes)
+	{
+		session.run(name, 1, MakeElement<Type>(1));
+
+		for (const size_t size : arraySizes)
+		{
+			session.run(U"Array<{}>"_fmt(name), size, MakeArray<Type>(size));
+		}
+
+		for (const int32 size : gridSizes)
+		{
+			session.run(U"Grid<{}>"_fmt(name), static_cast<size_t>(size * size), MakeGrid<Type>(size));
+		}
+	}
+}
+
+void Main()
+{
+	NetworkSystem::Log::SetLevel(NetworkSystem::LogLevel::Warning);
+
+	BenchmarkSession session;
+
+	if (not session.open())
+	{
+		Console << U"{\"error\": \"failed to join the loopback room\"}";
+		return;
+	}
+
+	const Array<size_t> arraySizes = { 16, 256, 4096 };
+	const Array<int32> gridSizes = { 4, 16, 64 };
+
+	RunElement<int32>(session, U"int32", arraySizes, gridSizes);
+	RunElement<double>(session, U"double", arraySizes, gridSizes);
+	RunElement<float>(session, U"float", arraySizes, gridSizes);
+	RunElement<bool>(session, U"bool", arraySizes, gridSizes);
+	RunElement<Point>(session, U"Point", arraySizes, gridSizes);
+	RunElement<Vec2>(session, U"Vec2", arraySizes, gridSizes);
+	RunElement<Rect>(session, U"Rect", arraySizes, gridSizes);
+	RunElement<Circle>(session, U"Circle", arraySizes, gridSizes);
+
+	// String は値ひとつ (StringView として送信) と Array, Grid
+	session.run(U"String", 16, String(16, U'x'));
+	session.run(U"String", 256, String(256, U'x'));
+
+	for (const size_t size : { 16, 256 })
+	{
+		session.run(U"Array<String>", size, MakeArray<String>(size));
+	}
+
+	for (const int32 size : { 4, 16 })
+	{
+		session.run(U"Grid<String>", static_cast<size_t>(size * size), MakeGrid<String>(size));
+	}
+
+	// ユーザ定義型 (SerializedValue として受信)
+	session.run(U"BenchmarkUnit", 1, MakeElement<BenchmarkUnit>(1));
+
+	for (const size_t size : { 16, 256 })
+	{
+		session.run(U"Array<BenchmarkUnit>", size, MakeArray<BenchmarkUnit>(size));
+	}
+
+	const JSON json = session.toJSON();
+	json.save(U"benchmark.json");
+	Console << json.format();
+}
+
+# endif
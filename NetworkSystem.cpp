@@ -3,6 +3,9 @@
 # define NOMINMAX
 # include <LoadBalancing-cpp/inc/Client.h>
 # include "NetworkSystem.hpp"
+# include <thread>
+# include "detail/SivPhotonWireFormat.hpp"
+# include "detail/SivPhotonSpscQueue.hpp"
 
 # if SIV3D_PLATFORM(WINDOWS)
 # if SIV3D_BUILD(DEBUG)
@@ -32,6 +35,347 @@ namespace s3d
 		{
 			return ExitGames::Common::JString{ Unicode::ToWstring(s).c_str() };
 		}
+
+		[[nodiscard]]
+		ExitGames::LoadBalancing::RaiseEventOptions ToRaiseEventOptions(const NetworkSystem::SendOptions& options)
+		{
+			ExitGames::LoadBalancing::RaiseEventOptions result;
+			result.setChannelID(options.channel);
+			result.setEventCaching(static_cast<nByte>(options.eventCache));
+			result.setReceiverGroup(static_cast<nByte>(options.receiverGroup));
+			result.setInterestGroup(options.interestGroup);
+
+			if (not options.targetPlayers.isEmpty())
+			{
+				result.setTargetPlayers(options.targetPlayers.data(), static_cast<short>(options.targetPlayers.size()));
+			}
+
+			return result;
+		}
+
+		/// @brief Photon のカスタムプロパティから、キーが文字列で値がバイト列の項目を取り出します。
+		/// @remark SivPhoton 以外が設定した、形式の異なる項目は無視します。
+		[[nodiscard]]
+		PropertyTable ToPropertyTable(const ExitGames::Common::Hashtable& properties)
+		{
+			PropertyTable result;
+			const auto& keys = properties.getKeys();
+
+			for (unsigned i = 0; i < keys.getSize(); ++i)
+			{
+				const ExitGames::Common::Object& key = keys[i];
+
+				if (key.getType() != ExitGames::Common::TypeCode::STRING)
+				{
+					continue;
+				}
+
+				const ExitGames::Common::Object* value = properties.getValue(key);
+
+				if ((not value)
+					|| (value->getType() != ExitGames::Common::TypeCode::BYTE)
+					|| (value->getDimensions() != 1))
+				{
+					continue;
+				}
+
+				const ExitGames::Common::ValueObject<nByte*> bytes{ *value };
+				const uint8* data = *bytes.getDataAddress();
+				result.emplace(ToString(ExitGames::Common::ValueObject<ExitGames::Common::JString>{ key }.getDataCopy()), Array<uint8>(data, (data + *bytes.getSizes())));
+			}
+
+			return result;
+		}
+
+		/// @brief ルームへの参加の結果に含まれる、プレイヤー ID ごとのカスタムプロパティを取り出します。
+		[[nodiscard]]
+		HashTable<int32, PropertyTable> ToPlayerPropertyTables(const ExitGames::Common::Hashtable& playerProperties)
+		{
+			HashTable<int32, PropertyTable> result;
+			const auto& keys = playerProperties.getKeys();
+
+			for (unsigned i = 0; i < keys.getSize(); ++i)
+			{
+				const ExitGames::Common::Object& key = keys[i];
+				const ExitGames::Common::Object* value = playerProperties.getValue(key);
+
+				if ((key.getType() != ExitGames::Common::TypeCode::INTEGER)
+					|| (not value)
+					|| (value->getType() != ExitGames::Common::TypeCode::HASHTABLE))
+				{
+					continue;
+				}
+
+				PropertyTable properties = ToPropertyTable(ExitGames::Common::ValueObject<ExitGames::Common::Hashtable>{ *value }.getDataCopy());
+
+				if (not properties.empty())
+				{
+					result.emplace(ExitGames::Common::ValueObject<int>{ key }.getDataCopy(), std::move(properties));
+				}
+			}
+
+			return result;
+		}
+
+		/// @brief Photon のカスタムプロパティから、キーが文字列で値が整数または文字列の項目 (マッチメイキング用のプロパティ) を取り出します。
+		[[nodiscard]]
+		NetworkSystem::MatchmakingProperties ToMatchmakingProperties(const ExitGames::Common::Hashtable& properties)
+		{
+			NetworkSystem::MatchmakingProperties result;
+			const auto& keys = properties.getKeys();
+
+			for (unsigned i = 0; i < keys.getSize(); ++i)
+			{
+				const ExitGames::Common::Object& key = keys[i];
+				const ExitGames::Common::Object* value = properties.getValue(key);
+
+				if ((key.getType() != ExitGames::Common::TypeCode::STRING)
+					|| (not value))
+				{
+					continue;
+				}
+
+				const String name = ToString(ExitGames::Common::ValueObject<ExitGames::Common::JString>{ key }.getDataCopy());
+
+				if (value->getType() == ExitGames::Common::TypeCode::INTEGER)
+				{
+					result.emplace(name, ExitGames::Common::ValueObject<int>{ *value }.getDataCopy());
+				}
+				else if (value->getType() == ExitGames::Common::TypeCode::STRING)
+				{
+					result.emplace(name, ToString(ExitGames::Common::ValueObject<ExitGames::Common::JString>{ *value }.getDataCopy()));
+				}
+			}
+
+			return result;
+		}
+
+		/// @brief マッチメイキング用のプロパティを Photon のカスタムプロパティに変換します。
+		[[nodiscard]]
+		ExitGames::Common::Hashtable ToHashtable(const NetworkSystem::MatchmakingProperties& properties)
+		{
+			ExitGames::Common::Hashtable result;
+
+			for (const auto& [key, value] : properties)
+			{
+				if (const int32* number = std::get_if<int32>(&value))
+				{
+					result.put(ToJString(key), *number);
+				}
+				else
+				{
+					result.put(ToJString(key), ToJString(std::get<String>(value)));
+				}
+			}
+
+			return result;
+		}
+
+		[[nodiscard]]
+		nByte ToLobbyType(const NetworkSystem::LobbyType lobbyType) noexcept
+		{
+			return ((lobbyType == NetworkSystem::LobbyType::SqlLobby) ? ExitGames::LoadBalancing::LobbyType::SQL_LOBBY : ExitGames::LoadBalancing::LobbyType::DEFAULT);
+		}
+
+		[[nodiscard]]
+		ExitGames::LoadBalancing::RoomOptions ToRoomOptions(const NetworkSystem::RoomCreateOptions& options)
+		{
+			// マッチメイキング用のプロパティはすべてロビーに公開する
+			ExitGames::Common::JVector<ExitGames::Common::JString> propsListedInLobby;
+
+			for (const auto& [key, value] : options.matchmakingProperties)
+			{
+				propsListedInLobby.addElement(ToJString(key));
+			}
+
+			return ExitGames::LoadBalancing::RoomOptions()
+				.setMaxPlayers(static_cast<nByte>(Clamp(options.maxPlayers, 0, 255)))
+				.setIsVisible(options.isVisible)
+				.setIsOpen(options.isOpen)
+				.setCustomRoomProperties(ToHashtable(options.matchmakingProperties))
+				.setPropsListedInLobby(propsListedInLobby)
+				.setLobbyName(ToJString(options.lobbyName))
+				.setLobbyType(ToLobbyType(options.lobbyType));
+		}
+
+		/// @brief ロビーのルームの一覧を変換します。
+		[[nodiscard]]
+		Array<NetworkSystem::RoomInfo> ToRoomList(const ExitGames::Common::JVector<ExitGames::LoadBalancing::Room*>& rooms)
+		{
+			Array<NetworkSystem::RoomInfo> result;
+			result.reserve(rooms.getSize());
+
+			for (unsigned i = 0; i < rooms.getSize(); ++i)
+			{
+				const ExitGames::LoadBalancing::Room& room = *rooms[i];
+				result << NetworkSystem::RoomInfo{ ToString(room.getName()), room.getPlayerCount(), room.getMaxPlayers(), room.getIsOpen(), ToPropertyTable(room.getCustomProperties()), ToMatchmakingProperties(room.getCustomProperties()) };
+			}
+
+			return result;
+		}
+
+		/// @brief 1 つの項目からなる Photon のカスタムプロパティを作成します。
+		[[nodiscard]]
+		ExitGames::Common::Hashtable ToHashtable(const StringView key, const Array<uint8>& value)
+		{
+			ExitGames::Common::Hashtable result;
+			result.put(ToJString(key), value.data(), static_cast<int>(value.size()));
+			return result;
+		}
+
+		static_assert(static_cast<nByte>(NetworkSystem::ReceiverGroup::Others) == ExitGames::Lite::ReceiverGroup::OTHERS);
+		static_assert(static_cast<nByte>(NetworkSystem::ReceiverGroup::All) == ExitGames::Lite::ReceiverGroup::ALL);
+		static_assert(static_cast<nByte>(NetworkSystem::ReceiverGroup::MasterClient) == ExitGames::Lite::ReceiverGroup::MASTER_CLIENT);
+		static_assert(static_cast<nByte>(NetworkSystem::EventCache::AddToRoomCache) == ExitGames::Lite::EventCache::ADD_TO_ROOM_CACHE);
+		static_assert(static_cast<nByte>(NetworkSystem::EventCache::RemoveFromRoomCacheForActorsLeft) == ExitGames::Lite::EventCache::REMOVE_FROM_ROOM_CACHE_FOR_ACTORS_LEFT);
+		static_assert(static_cast<nByte>(NetworkSystem::MatchmakingMode::FillRoom) == ExitGames::LoadBalancing::MatchmakingMode::FILL_ROOM);
+		static_assert(static_cast<nByte>(NetworkSystem::MatchmakingMode::SerialMatching) == ExitGames::LoadBalancing::MatchmakingMode::SERIAL_MATCHING);
+		static_assert(static_cast<nByte>(NetworkSystem::MatchmakingMode::RandomMatching) == ExitGames::LoadBalancing::MatchmakingMode::RANDOM_MATCHING);
+
+		static_assert(WireCoordinateSize(static_cast<uint8>(NetworkSystem::QuantizationFormat::Float32)) == 4);
+		static_assert(WireCoordinateSize(static_cast<uint8>(NetworkSystem::QuantizationFormat::Float16)) == 2);
+		static_assert(WireCoordinateSize(static_cast<uint8>(NetworkSystem::QuantizationFormat::Fixed16)) == 2);
+		static_assert(WireCoordinateSize(static_cast<uint8>(NetworkSystem::QuantizationFormat::Fixed24)) == 3);
+
+		void WriteLittleEndian(Array<uint8>& buffer, const uint32 bits, const size_t byteCount)
+		{
+			for (size_t i = 0; i < byteCount; ++i)
+			{
+				buffer << static_cast<uint8>(bits >> (8 * i));
+			}
+		}
+
+		[[nodiscard]]
+		uint32 ReadLittleEndian(const uint8*& it, const size_t byteCount)
+		{
+			uint32 bits = 0;
+
+			for (size_t i = 0; i < byteCount; ++i)
+			{
+				bits |= (static_cast<uint32>(*it++) << (8 * i));
+			}
+
+			return bits;
+		}
+
+		/// @brief 座標を量子化してバッファの末尾に書き込みます。
+		/// @param min 固定小数点数で表す範囲の最小値
+		/// @param range 固定小数点数で表す範囲の幅
+		void WriteCoordinate(Array<uint8>& buffer, const double value, const NetworkSystem::QuantizationFormat format, const double min, const double range)
+		{
+			const size_t byteCount = WireCoordinateSize(static_cast<uint8>(format));
+
+			switch (format)
+			{
+			case NetworkSystem::QuantizationFormat::Float32:
+				WriteLittleEndian(buffer, std::bit_cast<uint32>(static_cast<float>(value)), byteCount);
+				return;
+			case NetworkSystem::QuantizationFormat::Float16:
+				WriteLittleEndian(buffer, HalfFloat{ static_cast<float>(value) }.getBits(), byteCount);
+				return;
+			case NetworkSystem::QuantizationFormat::Fixed16:
+			case NetworkSystem::QuantizationFormat::Fixed24:
+			{
+				const uint32 maxCode = ((1u << (8 * byteCount)) - 1);
+				const double t = ((0.0 < range) ? Clamp(((value - min) / range), 0.0, 1.0) : 0.0);
+				WriteLittleEndian(buffer, static_cast<uint32>(std::lround(t * maxCode)), byteCount);
+				return;
+			}
+			default:
+				return;
+			}
+		}
+
+		/// @brief 量子化された座標を読み取ります。
+		[[nodiscard]]
+		double ReadCoordinate(const uint8*& it, const NetworkSystem::QuantizationFormat format, const double min, const double range)
+		{
+			const size_t byteCount = WireCoordinateSize(static_cast<uint8>(format));
+			const uint32 bits = ReadLittleEndian(it, byteCount);
+
+			switch (format)
+			{
+			case NetworkSystem::QuantizationFormat::Float32:
+				return std::bit_cast<float>(bits);
+			case NetworkSystem::QuantizationFormat::Float16:
+			{
+				HalfFloat half;
+				half.setBits(static_cast<uint16>(bits));
+				return half.asFloat();
+			}
+			case NetworkSystem::QuantizationFormat::Fixed16:
+			case NetworkSystem::QuantizationFormat::Fixed24:
+			{
+				const uint32 maxCode = ((1u << (8 * byteCount)) - 1);
+				return (min + (range * bits / maxCode));
+			}
+			default:
+				return 0.0;
+			}
+		}
+
+		/// @brief Vec2, Circle の並びを量子化してバッファの末尾に書き込みます。
+		template <class Type>
+		void WriteQuantized(Array<uint8>& buffer, const WireContainer container, const Size size, const Type* values, const size_t count, const NetworkSystem::QuantizationProfile& profile)
+		{
+			const auto format = profile.format;
+			const RectF& area = profile.area;
+
+			if constexpr (std::is_same_v<Type, Vec2>)
+			{
+				WriteQuantizedHeader(buffer, container, WireElement::QuantizedVec2, static_cast<uint8>(format), size);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					WriteCoordinate(buffer, values[i].x, format, area.x, area.w);
+					WriteCoordinate(buffer, values[i].y, format, area.y, area.h);
+				}
+			}
+			else
+			{
+				static_assert(std::is_same_v<Type, Circle>);
+
+				WriteQuantizedHeader(buffer, container, WireElement::QuantizedCircle, static_cast<uint8>(format), size);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					WriteCoordinate(buffer, values[i].x, format, area.x, area.w);
+					WriteCoordinate(buffer, values[i].y, format, area.y, area.h);
+					WriteCoordinate(buffer, values[i].r, format, 0.0, profile.maxRadius);
+				}
+			}
+		}
+
+		/// @brief 量子化された Vec2, Circle の並びを復元します。
+		/// @return 復元に成功した場合 true, 固定小数点数の形式が受信側の設定と異なる場合は false
+		template <class Type>
+		[[nodiscard]]
+		bool ReadQuantized(Type* values, const size_t count, const uint8* it, const uint8 formatValue, const NetworkSystem::QuantizationProfile& profile)
+		{
+			const auto format = static_cast<NetworkSystem::QuantizationFormat>(formatValue);
+
+			// 固定小数点数は範囲を共有していないと復元できない
+			if (((format == NetworkSystem::QuantizationFormat::Fixed16) || (format == NetworkSystem::QuantizationFormat::Fixed24))
+				&& (profile.format != format))
+			{
+				return false;
+			}
+
+			const RectF& area = profile.area;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				values[i].x = ReadCoordinate(it, format, area.x, area.w);
+				values[i].y = ReadCoordinate(it, format, area.y, area.h);
+
+				if constexpr (std::is_same_v<Type, Circle>)
+				{
+					values[i].r = ReadCoordinate(it, format, 0.0, profile.maxRadius);
+				}
+			}
+
+			return true;
+		}
 	}
 
 	template <class T, uint8 customTypeIndex>
@@ -106,6 +450,11 @@ namespace s3d
 		{
 			return m_value;
 		}
+
+		const T& getValue() const
+		{
+			return m_value;
+		}
 	};
 
 	using PhotonPoint = SivCustomType<Point, 0>;
@@ -117,1300 +466,5721 @@ namespace s3d
 	using PhotonCircle = SivCustomType<Circle, 3>;
 }
 
-namespace s3d
+namespace s3d::NetworkSystem::Log
 {
-	class SivPhoton::SivPhotonDetail : public ExitGames::LoadBalancing::Listener
+	namespace
 	{
-	public:
-
-		explicit SivPhotonDetail(SivPhoton& context_)
-			: m_context{ context_ }
+		/// @brief リングバッファの 1 要素
+		/// @remark sequence が偶数の間は書き込みが完了している (seqlock)
+		struct LogSlot
 		{
-			m_receiveEventFunctions.emplace(0, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent) { receivedCustomType<Point, 0>(playerID, eventCode, eventContent); });
-			m_receiveEventFunctions.emplace(1, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent) { receivedCustomType<Vec2, 1>(playerID, eventCode, eventContent); });
-			m_receiveEventFunctions.emplace(2, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent) { receivedCustomType<Rect, 2>(playerID, eventCode, eventContent); });
-			m_receiveEventFunctions.emplace(3, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent) { receivedCustomType<Circle, 3>(playerID, eventCode, eventContent); });
+			std::atomic<uint64> sequence{ 0 };
 
-			m_receiveArrayEventFunctions.emplace(0, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent) { receivedCustomArrayType<Point, 0>(playerID, eventCode, eventContent); });
-			m_receiveArrayEventFunctions.emplace(1, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent) { receivedCustomArrayType<Vec2, 1>(playerID, eventCode, eventContent); });
-			m_receiveArrayEventFunctions.emplace(2, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent) { receivedCustomArrayType<Rect, 2>(playerID, eventCode, eventContent); });
-			m_receiveArrayEventFunctions.emplace(3, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent) { receivedCustomArrayType<Circle, 3>(playerID, eventCode, eventContent); });
+			LogLevel level = LogLevel::Trace;
 
-			m_receiveGridEventFunctions.emplace(0, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Size size) { receivedCustomGridType<Point, 0>(playerID, eventCode, eventContent, size); });
-			m_receiveGridEventFunctions.emplace(1, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Size size) { receivedCustomGridType<Vec2, 1>(playerID, eventCode, eventContent, size); });
-			m_receiveGridEventFunctions.emplace(2, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Size size) { receivedCustomGridType<Rect, 2>(playerID, eventCode, eventContent, size); });
-			m_receiveGridEventFunctions.emplace(3, [this](const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Size size) { receivedCustomGridType<Circle, 3>(playerID, eventCode, eventContent, size); });
-		}
+			uint8 length = 0;
 
-		void debugReturn(int debugLevel, const ExitGames::Common::JString& string) override
-		{
+			uint64 timeMicrosec = 0;
 
-		}
+			char32 message[MaxMessageLength];
+		};
 
-		void connectionErrorReturn(int errorCode) override
-		{
-			m_context.connectionErrorReturn(errorCode);
-			m_context.m_isUsePhoton = false;
-		}
+		std::array<LogSlot, Capacity> g_slots;
 
-		void clientErrorReturn(int errorCode) override
-		{
+		/// @brief 次に書き込むログの通し番号
+		std::atomic<uint64> g_next{ 0 };
 
-		}
+		std::atomic<LogLevel> g_level{ LogLevel::Info };
 
-		void warningReturn(int warningCode) override
-		{
+		std::atomic<bool> g_print{ true };
 
-		}
+		const std::thread::id g_mainThreadID = std::this_thread::get_id();
 
-		void serverErrorReturn(int errorCode) override
-		{
+		std::atomic<bool> g_fileOpen{ false };
 
-		}
+		std::mutex g_fileMutex;
 
-		// 自分でも他人でも、誰かが参加したら呼ばれるコールバック
-		void joinRoomEventAction(const int playerID, const ExitGames::Common::JVector<int>& playerIDs, const ExitGames::LoadBalancing::Player& player) override
+		TextWriter g_file;
+
+		[[nodiscard]]
+		StringView ToString(const LogLevel level) noexcept
 		{
-			Array<int32> ids(playerIDs.getSize());
-			for (unsigned i = 0; i < playerIDs.getSize(); ++i)
+			switch (level)
 			{
-				ids[i] = playerIDs[i];
+			case LogLevel::Trace:
+				return U"Trace";
+			case LogLevel::Debug:
+				return U"Debug";
+			case LogLevel::Info:
+				return U"Info";
+			case LogLevel::Warning:
+				return U"Warning";
+			default:
+				return U"Error";
 			}
-
-			const auto myID = m_context.getClient().getLocalPlayer().getNumber();
-			const auto newID = player.getNumber();
-			const bool isSelf = (myID == newID);
-			m_context.joinRoomEventAction(playerID, ids, isSelf);
 		}
+	}
 
-		// 他人でも、誰かが退室したら呼ばれるコールバック
-		void leaveRoomEventAction(const int playerID, const bool isInactive) override
-		{
-			m_context.leaveRoomEventAction(playerID, isInactive);
-		}
+	void SetLevel(const LogLevel level) noexcept
+	{
+		g_level.store(level, std::memory_order_relaxed);
+	}
 
-		// ルームで他人が RaiseEvent したら呼ばれるコールバック
-		void customEventAction(const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent) override
-		{
-			Print << U"SivPhoton::SivPhotonDetail::customEventAction() [ルームで他人が RaiseEvent したときの処理]";
-			Print << U"eventCode: " << int32(eventCode);
+	LogLevel GetLevel() noexcept
+	{
+		return g_level.load(std::memory_order_relaxed);
+	}
 
-			uint8 type = eventContent.getType();
+	bool IsEnabled(const LogLevel level) noexcept
+	{
+		return ((level != LogLevel::None)
+			&& (g_level.load(std::memory_order_relaxed) <= level));
+	}
 
-			if (type == ExitGames::Common::TypeCode::CUSTOM)
-			{
-				const uint8 customType = eventContent.getCustomType();
-				m_receiveEventFunctions[customType](playerID, eventCode, eventContent);
-				return;
-			}
+	void SetPrint(const bool enabled) noexcept
+	{
+		g_print.store(enabled, std::memory_order_relaxed);
+	}
 
-			if (type == ExitGames::Common::TypeCode::HASHTABLE)
-			{
-				ExitGames::Common::Hashtable eventDataContent = ExitGames::Common::ValueObject<ExitGames::Common::Hashtable>(eventContent).getDataCopy();
-				ExitGames::Common::JString arrayType = ExitGames::Common::ValueObject<ExitGames::Common::JString>(eventDataContent.getValue(L"ArrayType")).getDataCopy();
-				if (arrayType == L"Array")
-				{
-					type = eventDataContent.getValue(L"values")->getType();
-					if (type == ExitGames::Common::TypeCode::CUSTOM)
-					{
-						const uint8 customType = eventDataContent.getValue(L"values")->getCustomType();
-						m_receiveArrayEventFunctions[customType](playerID, eventCode, eventDataContent.getValue(L"values"));
-						return;
-					}
+	bool GetPrint() noexcept
+	{
+		return g_print.load(std::memory_order_relaxed);
+	}
 
-					switch (type)
-					{
-					case ExitGames::Common::TypeCode::INTEGER:
-					{
-						auto values = ExitGames::Common::ValueObject<int*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<int*>(eventDataContent.getValue(L"values"))).getSizes();
+	bool OpenFile(const FilePathView path)
+	{
+		const std::lock_guard lock{ g_fileMutex };
 
-						Array<int32> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
-						m_context.customEventAction(playerID, eventCode, data);
-						return;
-					}
-					case ExitGames::Common::TypeCode::DOUBLE:
-					{
-						auto values = ExitGames::Common::ValueObject<double*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<double*>(eventDataContent.getValue(L"values"))).getSizes();
+		g_file.close();
 
-						Print << length;
+		const bool opened = g_file.open(path);
 
-						Array<double> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
-						m_context.customEventAction(playerID, eventCode, data);
-						return;
-					}
-					case ExitGames::Common::TypeCode::FLOAT:
-					{
-						auto values = ExitGames::Common::ValueObject<float*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<float*>(eventDataContent.getValue(L"values"))).getSizes();
+		g_fileOpen.store(opened, std::memory_order_release);
 
-						Array<float> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
-						m_context.customEventAction(playerID, eventCode, data);
-						return;
-					}
-					case ExitGames::Common::TypeCode::BOOLEAN:
-					{
-						auto values = ExitGames::Common::ValueObject<bool*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<bool*>(eventDataContent.getValue(L"values"))).getSizes();
+		return opened;
+	}
 
-						Array<bool> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
-						m_context.customEventAction(playerID, eventCode, data);
-						return;
-					}
-					case ExitGames::Common::TypeCode::STRING:
-					{
-						auto values = ExitGames::Common::ValueObject<ExitGames::Common::JString*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<ExitGames::Common::JString*>(eventDataContent.getValue(L"values"))).getSizes();
+	void CloseFile()
+	{
+		const std::lock_guard lock{ g_fileMutex };
 
-						Array<String> data;
-						for (const auto i : step(length))
-						{
-							data << detail::ToString(values[i]);
-						}
-						m_context.customEventAction(playerID, eventCode, data);
-						return;
-					}
-					default:
-						break;
-					}
-				}
+		g_fileOpen.store(false, std::memory_order_release);
 
-				if (arrayType == L"Grid")
-				{
-					type = eventDataContent.getValue(L"values")->getType();
-					Size size = ExitGames::Common::ValueObject<PhotonPoint>(eventDataContent.getValue(L"xy")).getDataCopy().getValue();
-					if (type == ExitGames::Common::TypeCode::CUSTOM)
-					{
-						const uint8 customType = eventDataContent.getValue(L"values")->getCustomType();
-						m_receiveGridEventFunctions[customType](playerID, eventCode, eventDataContent.getValue(L"values"), size);
-						return;
-					}
-
-					switch (type)
-					{
-					case ExitGames::Common::TypeCode::INTEGER:
-					{
-						auto values = ExitGames::Common::ValueObject<int*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<int*>(eventDataContent.getValue(L"values"))).getSizes();
+		g_file.close();
+	}
 
-						Array<int32> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
+	Array<LogRecord> GetRecent(const size_t count)
+	{
+		const uint64 next = g_next.load(std::memory_order_acquire);
+		const uint64 first = (next - Min<uint64>(next, Min(count, Capacity)));
 
-						Grid<int32> grid(size, data);
+		Array<LogRecord> records;
+		records.reserve(static_cast<size_t>(next - first));
 
-						m_context.customEventAction(playerID, eventCode, grid);
-						return;
-					}
-					case ExitGames::Common::TypeCode::DOUBLE:
-					{
-						auto values = ExitGames::Common::ValueObject<double*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<double*>(eventDataContent.getValue(L"values"))).getSizes();
+		for (uint64 index = first; index < next; ++index)
+		{
+			const LogSlot& slot = g_slots[index % Capacity];
 
-						Print << length;
+			// 書き込み中のものと、読み取り中に上書きされたものは飛ばす
+			const uint64 sequence = slot.sequence.load(std::memory_order_acquire);
 
-						Array<double> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
+			if (sequence != ((index + 1) * 2))
+			{
+				continue;
+			}
 
-						Grid<double> grid(size, data);
+			LogRecord record{ slot.level, slot.timeMicrosec, String(slot.message, slot.length) };
 
-						m_context.customEventAction(playerID, eventCode, grid);
-						return;
-					}
-					case ExitGames::Common::TypeCode::FLOAT:
-					{
-						auto values = ExitGames::Common::ValueObject<float*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<float*>(eventDataContent.getValue(L"values"))).getSizes();
+			std::atomic_thread_fence(std::memory_order_acquire);
 
-						Array<float> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
+			if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+			{
+				continue;
+			}
 
-						Grid<float> grid(size, data);
+			records << std::move(record);
+		}
 
-						m_context.customEventAction(playerID, eventCode, grid);
-						return;
-					}
-					case ExitGames::Common::TypeCode::BOOLEAN:
-					{
-						auto values = ExitGames::Common::ValueObject<bool*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<bool*>(eventDataContent.getValue(L"values"))).getSizes();
+		return records;
+	}
 
-						Array<bool> data;
-						for (const auto i : step(length))
-						{
-							data << values[i];
-						}
+	void Write(const LogLevel level, const StringView message)
+	{
+		const uint64 timeMicrosec = Time::GetMicrosec();
 
-						Grid<bool> grid(size, data);
+		{
+			const uint64 index = g_next.fetch_add(1, std::memory_order_relaxed);
+			LogSlot& slot = g_slots[index % Capacity];
+			const size_t length = Min(message.size(), MaxMessageLength);
 
-						m_context.customEventAction(playerID, eventCode, grid);
-						return;
-					}
-					case ExitGames::Common::TypeCode::STRING:
-					{
-						auto values = ExitGames::Common::ValueObject<ExitGames::Common::JString*>(eventDataContent.getValue(L"values")).getDataCopy();
-						auto length = *(ExitGames::Common::ValueObject<ExitGames::Common::JString*>(eventDataContent.getValue(L"values"))).getSizes();
+			slot.sequence.store(((index * 2) + 1), std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
 
-						Array<String> data;
-						for (const auto i : step(length))
-						{
-							data << detail::ToString(values[i]);
-						}
+			slot.level = level;
+			slot.length = static_cast<uint8>(length);
+			slot.timeMicrosec = timeMicrosec;
+			std::copy_n(message.data(), length, slot.message);
 
-						Grid<String> grid(size, data);
+			slot.sequence.store(((index + 1) * 2), std::memory_order_release);
+		}
 
-						m_context.customEventAction(playerID, eventCode, grid);
-						return;
-					}
-					default:
-						break;
-					}
-				}
+		if (g_print.load(std::memory_order_relaxed)
+			&& (std::this_thread::get_id() == g_mainThreadID))
+		{
+			Print << message;
+		}
 
-				return;
-			}
+		if (g_fileOpen.load(std::memory_order_acquire))
+		{
+			const std::lock_guard lock{ g_fileMutex };
 
-			switch (type)
+			if (g_file)
 			{
-			case ExitGames::Common::TypeCode::INTEGER:
-				m_context.customEventAction(playerID, eventCode, ExitGames::Common::ValueObject<int>(eventContent).getDataCopy());
-				return;
-			case ExitGames::Common::TypeCode::DOUBLE:
-				m_context.customEventAction(playerID, eventCode, ExitGames::Common::ValueObject<double>(eventContent).getDataCopy());
-				return;
-			case ExitGames::Common::TypeCode::FLOAT:
-				m_context.customEventAction(playerID, eventCode, ExitGames::Common::ValueObject<float>(eventContent).getDataCopy());
-				return;
-			case ExitGames::Common::TypeCode::BOOLEAN:
-				m_context.customEventAction(playerID, eventCode, ExitGames::Common::ValueObject<bool>(eventContent).getDataCopy());
-				return;
-			case ExitGames::Common::TypeCode::STRING:
-				m_context.customEventAction(playerID, eventCode, detail::ToString(ExitGames::Common::ValueObject<ExitGames::Common::JString>(eventContent).getDataCopy()));
-				return;
-			default:
-				break;
+				g_file.writeln(U"{} [{}] {}"_fmt(timeMicrosec, ToString(level), message));
 			}
 		}
+	}
+}
 
-		// connect() の結果を通知するコールバック
-		void connectReturn(int errorCode, const ExitGames::Common::JString& errorString, const ExitGames::Common::JString& region, const ExitGames::Common::JString& cluster) override
+namespace s3d
+{
+	/// @brief サーバとの通信 (Photon またはループバック)
+	/// @remark 操作の結果と受信したイベントは、SivPhotonDetail の notify...() に通知します。
+	class SivPhoton::Transport
+	{
+	public:
+
+		virtual ~Transport() = default;
+
+		/// @brief サーバに接続します。
+		/// @return 接続を開始できた場合 true, それ以外の場合は false
+		[[nodiscard]]
+		virtual bool connect(StringView userName) = 0;
+
+		virtual void disconnect() = 0;
+
+		/// @brief 受信したコマンドの処理と、送信待ちのコマンドの送信をします。
+		virtual void service() = 0;
+
+		virtual void dispatchIncomingCommands() = 0;
+
+		virtual void sendOutgoingCommands() = 0;
+
+		virtual void joinRandomRoom(const NetworkSystem::MatchmakingOptions& options) = 0;
+
+		/// @brief 条件に合うルームに参加し、見つからない場合はルームを作成して参加します。
+		virtual void joinRandomOrCreateRoom(const NetworkSystem::MatchmakingOptions& options, StringView roomName, const NetworkSystem::RoomCreateOptions& createOptions) = 0;
+
+		virtual void joinRoom(StringView roomName, bool rejoin) = 0;
+
+		virtual void createRoom(StringView roomName, const NetworkSystem::RoomCreateOptions& options) = 0;
+
+		virtual void leaveRoom() = 0;
+
+		/// @brief 購読するインタレストグループを変更します。
+		virtual void changeGroups(const std::bitset<256>& groupsToRemove, const std::bitset<256>& groupsToAdd) = 0;
+
+		/// @brief すべてのインタレストグループの購読をやめます。
+		virtual void clearGroups() = 0;
+
+		/// @brief パック形式のイベントを送信します。
+		virtual void raiseEvent(const uint8* data, size_t size, uint8 eventCode, const NetworkSystem::SendOptions& options) = 0;
+
+		[[nodiscard]]
+		virtual String getName() const = 0;
+
+		[[nodiscard]]
+		virtual String getUserID() const = 0;
+
+		[[nodiscard]]
+		virtual bool isInRoom() const = 0;
+
+		[[nodiscard]]
+		virtual String getRoomName() const = 0;
+
+		[[nodiscard]]
+		virtual int32 getPlayerCount() const = 0;
+
+		[[nodiscard]]
+		virtual int32 getMaxPlayers() const = 0;
+
+		[[nodiscard]]
+		virtual bool getIsOpen() const = 0;
+
+		[[nodiscard]]
+		virtual bool getIsVisible() const = 0;
+
+		virtual void setIsOpen(bool isOpen) = 0;
+
+		virtual void setIsVisible(bool isVisible) = 0;
+
+		[[nodiscard]]
+		virtual int32 getCountGamesRunning() const = 0;
+
+		[[nodiscard]]
+		virtual int32 getCountPlayersIngame() const = 0;
+
+		[[nodiscard]]
+		virtual int32 getCountPlayersOnline() const = 0;
+
+		/// @brief ルーム内での自分のプレイヤー ID を返します。
+		/// @return プレイヤー ID, ルームにいない場合は -1
+		[[nodiscard]]
+		virtual int32 getLocalPlayerNumber() const = 0;
+
+		/// @brief サーバ時刻 (ミリ秒) を返します。
+		[[nodiscard]]
+		virtual int32 getServerTime() const = 0;
+
+		[[nodiscard]]
+		virtual bool isMasterClient() const = 0;
+
+		/// @brief 通信量や遅延の統計を stats に書き込みます。
+		virtual void getStats(NetworkSystem::NetworkStats& stats) const = 0;
+
+		virtual void resetStats() = 0;
+
+		/// @brief 旧形式のイベント (ExitGames::Common::Object) を送受信できるか
+		[[nodiscard]]
+		virtual bool supportsObjectEvents() const noexcept = 0;
+
+		/// @brief 現在のルームのカスタムプロパティの項目を変更します。
+		/// @param expectedValue nullptr でない場合、サーバでの現在の値がこれと等しいときのみ変更する
+		virtual void setRoomProperty(StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue) = 0;
+
+		/// @brief 自分のカスタムプロパティの項目を変更します。
+		/// @param expectedValue nullptr でない場合、サーバでの現在の値がこれと等しいときのみ変更する
+		virtual void setPlayerProperty(StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue) = 0;
+
+		/// @brief 現在のルームで、ロビーのルームの一覧に公開するカスタムプロパティのキーを設定します。
+		virtual void setPropertiesListedInLobby(const Array<String>& keys) = 0;
+	};
+
+	class SivPhoton::SivPhotonDetail : public ExitGames::LoadBalancing::Listener
+	{
+	public:
+
+		explicit SivPhotonDetail(SivPhoton& context_)
+			: m_context{ context_ }
+		{
+			m_receiveEventFunctions[0] = &SivPhotonDetail::receivedCustomType<Point, 0>;
+			m_receiveEventFunctions[1] = &SivPhotonDetail::receivedCustomType<Vec2, 1>;
+			m_receiveEventFunctions[2] = &SivPhotonDetail::receivedCustomType<Rect, 2>;
+			m_receiveEventFunctions[3] = &SivPhotonDetail::receivedCustomType<Circle, 3>;
+
+			m_receiveArrayEventFunctions[0] = &SivPhotonDetail::receivedCustomArrayType<Point, 0>;
+			m_receiveArrayEventFunctions[1] = &SivPhotonDetail::receivedCustomArrayType<Vec2, 1>;
+			m_receiveArrayEventFunctions[2] = &SivPhotonDetail::receivedCustomArrayType<Rect, 2>;
+			m_receiveArrayEventFunctions[3] = &SivPhotonDetail::receivedCustomArrayType<Circle, 3>;
+
+			m_receiveGridEventFunctions[0] = &SivPhotonDetail::receivedCustomGridType<Point, 0>;
+			m_receiveGridEventFunctions[1] = &SivPhotonDetail::receivedCustomGridType<Vec2, 1>;
+			m_receiveGridEventFunctions[2] = &SivPhotonDetail::receivedCustomGridType<Rect, 2>;
+			m_receiveGridEventFunctions[3] = &SivPhotonDetail::receivedCustomGridType<Circle, 3>;
+		}
+
+		void debugReturn(int debugLevel, const ExitGames::Common::JString& string) override
 		{
-			const String errorText = detail::ToString(errorString);
-			const String regionText = detail::ToString(region);
-			const String clusterText = detail::ToString(cluster);
-			m_context.connectReturn(errorCode, errorText, regionText, clusterText);
-			if (errorCode)
+
+		}
+
+		void connectionErrorReturn(int errorCode) override
+		{
+			notifyConnectionError(errorCode);
+		}
+
+		void notifyConnectionError(const int32 errorCode)
+		{
+			runOnMainThread([=, this]
 			{
+				m_context.connectionErrorReturn(errorCode);
 				m_context.m_isUsePhoton = false;
-			}
+			});
 		}
 
-		// disconnect() の結果を通知するコールバック
-		void disconnectReturn() override
+		void clientErrorReturn(int errorCode) override
 		{
-			m_context.disconnectReturn();
-			m_context.m_isUsePhoton = false;
+
 		}
 
-		// 
-		void leaveRoomReturn(int errorCode, const ExitGames::Common::JString& errorString) override
+		void warningReturn(int warningCode) override
 		{
-			const String errorText = detail::ToString(errorString);
-			m_context.leaveRoomReturn(errorCode, errorText);
+
 		}
 
-		void joinRandomRoomReturn(int localPlayerID, const ExitGames::Common::Hashtable& roomProperties, const ExitGames::Common::Hashtable& playerProperties, int errorCode, const ExitGames::Common::JString& errorString) override
+		void serverErrorReturn(int errorCode) override
 		{
-			m_context.joinRandomRoomReturn(localPlayerID, errorCode, detail::ToString(errorString));
+
 		}
 
-		void createRoomReturn(int localPlayerID, const ExitGames::Common::Hashtable& roomProperties, const ExitGames::Common::Hashtable& playerProperties, int errorCode, const ExitGames::Common::JString& errorString) override
+		// 自分でも他人でも、誰かが参加したら呼ばれるコールバック
+		void joinRoomEventAction(const int playerID, const ExitGames::Common::JVector<int>& playerIDs, const ExitGames::LoadBalancing::Player& player) override
 		{
-			m_context.createRoomReturn(localPlayerID, errorCode, detail::ToString(errorString));
-		}
+			Array<int32> ids(playerIDs.getSize());
+			for (unsigned i = 0; i < playerIDs.getSize(); ++i)
+			{
+				ids[i] = playerIDs[i];
+			}
 
-	private:
+			const auto myID = m_context.getClient().getLocalPlayer().getNumber();
+			const auto newID = player.getNumber();
+			const bool isSelf = (myID == newID);
 
-		SivPhoton& m_context;
+			notifyPlayerJoined(playerID, ids, isSelf);
+		}
 
-		HashTable<uint8, std::function<void(const int, const nByte, const ExitGames::Common::Object&)>> m_receiveEventFunctions;
+		void notifyPlayerJoined(const int32 playerID, const Array<int32>& ids, const bool isSelf)
+		{
+			runOnMainThread([=, this]
+			{
+				joinedRoom(playerID, ids, isSelf);
+			});
+		}
 
-		HashTable<uint8, std::function<void(const int, const nByte, const ExitGames::Common::Object*)>> m_receiveArrayEventFunctions;
+		// 他人でも、誰かが退室したら呼ばれるコールバック
+		void leaveRoomEventAction(const int playerID, const bool isInactive) override
+		{
+			notifyPlayerLeft(playerID, isInactive);
+		}
 
-		HashTable<uint8, std::function<void(const int, const nByte, const ExitGames::Common::Object*, const Size)>> m_receiveGridEventFunctions;
+		void notifyPlayerLeft(const int32 playerID, const bool isInactive)
+		{
+			runOnMainThread([=, this]
+			{
+				leftRoom(playerID, isInactive);
+			});
+		}
 
-		template <class T, uint8 N>
-		void receivedCustomType(const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent)
+		void joinedRoom(const int playerID, const Array<int32>& ids, const bool isSelf)
 		{
-			auto value = ExitGames::Common::ValueObject<SivCustomType<T, N>>(eventContent).getDataCopy().getValue();
-			m_context.customEventAction(playerID, eventCode, value);
+			// 参加より前に受信したイベントを先に処理する
+			flushReceiveQueue();
+
+			// 差分送信中の Grid と文字列表は、参加した人がキーフレームと登録の一覧から受け取れるようにする
+			if (isSelf)
+			{
+				m_receivedGrids.clear();
+				m_receivedStringTables.clear();
+				m_pendingStringEvents.clear();
+				m_context.resetGridReplications();
+				m_context.resetStringTable();
+				m_context.m_interestGroups.reset();
+			}
+			else
+			{
+				m_context.raiseGridKeyframes(playerID);
+				m_context.raiseNetworkVarSnapshot(playerID);
+				m_context.raiseStringTable(playerID);
+			}
+
+			m_context.joinRoomEventAction(playerID, ids, isSelf);
 		}
 
-		template <class T, uint8 N>
-		void receivedCustomArrayType(const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent)
+		void leftRoom(const int playerID, const bool isInactive)
 		{
-			SivCustomType<T, N>* values = ExitGames::Common::ValueObject<SivCustomType<T, N>*>(eventContent).getDataCopy();
-			auto length = *(ExitGames::Common::ValueObject<SivCustomType<T, N>*>(eventContent)).getSizes();
+			// 退室した人のイベントを、その人の受信状態を消す前に処理する
+			flushReceiveQueue();
 
-			Array<T> data;
-			for (const auto i : step(length))
+			m_receivedStringTables.erase(playerID);
+			m_pendingStringEvents.erase(playerID);
+
+			for (auto it = m_receivedGrids.begin(); it != m_receivedGrids.end();)
 			{
-				data << values[i].getValue();
+				if (static_cast<int32>(it->first >> 8) == playerID)
+				{
+					it = m_receivedGrids.erase(it);
+				}
+				else
+				{
+					++it;
+				}
 			}
-			m_context.customEventAction(playerID, eventCode, data);
+
+			m_context.m_playerProperties.erase(playerID);
+
+			m_context.leaveRoomEventAction(playerID, isInactive);
 		}
 
-		template <class T, uint8 N>
-		void receivedCustomGridType(const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Size size)
+		// ルームで他人が RaiseEvent したら呼ばれるコールバック
+		void customEventAction(const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent) override
 		{
-			SivCustomType<T, N>* values = ExitGames::Common::ValueObject<SivCustomType<T, N>*>(eventContent).getDataCopy();
-			auto length = *(ExitGames::Common::ValueObject<SivCustomType<T, N>*>(eventContent)).getSizes();
+			if ((eventContent.getType() == ExitGames::Common::TypeCode::BYTE) && (eventContent.getDimensions() == 1))
+			{
+				const ExitGames::Common::ValueObject<nByte*> bytes{ eventContent };
+				notifyPackedEvent(playerID, eventCode, *bytes.getDataAddress(), static_cast<size_t>(*bytes.getSizes()));
+				return;
+			}
 
-			Array<T> data;
-			for (const auto i : step(length))
+			if (isDeferred())
 			{
-				data << values[i].getValue();
+				pushIncomingMessage([&](IncomingMessage& message)
+				{
+					message.playerID = playerID;
+					message.eventCode = eventCode;
+					message.isObject = true;
+					message.object = eventContent;
+				});
+			}
+			else
+			{
+				acceptObject(playerID, eventCode, eventContent);
 			}
+		}
 
-			Grid<T> grid{ size, data };
-			m_context.customEventAction(playerID, eventCode, grid);
+		/// @brief パック形式のイベントを受信したときの処理
+		void notifyPackedEvent(const int32 playerID, const uint8 eventCode, const uint8* data, const size_t size)
+		{
+			if (isDeferred())
+			{
+				pushIncomingMessage([&](IncomingMessage& message)
+				{
+					message.playerID = playerID;
+					message.eventCode = eventCode;
+					message.isObject = false;
+					message.bytes.assign(data, (data + size));
+				});
+			}
+			else
+			{
+				acceptBytes(playerID, eventCode, data, size);
+			}
 		}
-	};
-}
 
-namespace s3d
-{
-	SivPhoton::SivPhoton(const StringView secretPhotonAppID, const StringView photonAppVersion)
-		: m_listener{ std::make_unique<SivPhotonDetail>(*this) }
-		, m_client{ std::make_unique<ExitGames::LoadBalancing::Client>(*m_listener, detail::ToJString(secretPhotonAppID), detail::ToJString(photonAppVersion)) }
-		, m_isUsePhoton{ false }
-	{
+		void setNetworkThread(const bool enabled, const Duration& interval)
+		{
+			if (enabled == m_networkThreadEnabled)
+			{
+				return;
+			}
 
-		PhotonPoint::registerType();
-		PhotonVec2::registerType();
-		PhotonRect::registerType();
-		PhotonCircle::registerType();
-	}
+			if (enabled)
+			{
+				createMessageQueues();
 
-	SivPhoton::~SivPhoton()
-	{
-		Print << U"SivPhoton::~SivPhoton()";
+				m_networkThreadEnabled = true;
+				m_stopNetworkThread.store(false, std::memory_order_relaxed);
+				m_networkThread = std::thread{ [this, interval] { runNetworkThread(interval); } };
+				return;
+			}
 
-		PhotonPoint::unregisterType();
-		PhotonVec2::unregisterType();
-		PhotonRect::unregisterType();
-		PhotonCircle::unregisterType();
+			stopNetworkThread();
 
-		disconnect();
+			// スレッド間のキューに残っているイベントを送信し、受信したコールバックを呼ぶ
+			while (const OutgoingEvent* event = m_outgoingEvents->front())
+			{
+				sendOutgoingEvent(*event);
+				m_outgoingEvents->pop();
+			}
+
+			dispatchIncomingMessages();
+		}
+
+		/// @brief ネットワークスレッドを止めます。スレッド間のキューに残っているものは処理しません。
+		void stopNetworkThread()
+		{
+			if (not m_networkThreadEnabled)
+			{
+				return;
+			}
+
+			m_stopNetworkThread.store(true, std::memory_order_release);
+			m_networkThread.join();
+			m_networkThreadEnabled = false;
+		}
+
+		[[nodiscard]]
+		bool getNetworkThread() const noexcept
+		{
+			return m_networkThreadEnabled;
+		}
+
+		void setHoldCallbacks(const bool hold)
+		{
+			if (hold)
+			{
+				createMessageQueues();
+			}
+
+			m_holdingCallbacks = hold;
+		}
+
+		[[nodiscard]]
+		bool getHoldCallbacks() const noexcept
+		{
+			return m_holdingCallbacks;
+		}
+
+		[[nodiscard]]
+		std::unique_lock<std::recursive_mutex> lockClient()
+		{
+			if (not m_networkThreadEnabled)
+			{
+				return{};
+			}
+
+			return std::unique_lock{ m_clientMutex };
+		}
+
+		/// @brief 送信するイベントをネットワークスレッドに渡します。
+		void pushOutgoingEvent(const uint8 eventCode, const Array<uint8>& bytes, const NetworkSystem::SendOptions& options)
+		{
+			OutgoingEvent* event = m_outgoingEvents->back();
+
+			// キューがいっぱいの場合は、ネットワークスレッドが送信するのを待つ
+			while (not event)
+			{
+				std::this_thread::yield();
+				event = m_outgoingEvents->back();
+			}
+
+			event->eventCode = eventCode;
+			event->options = options;
+			event->bytes.assign(bytes.begin(), bytes.end());
+
+			m_outgoingEvents->push();
+		}
+
+		/// @brief ネットワークスレッドから受け取ったコールバックと、保留していたコールバックとイベントを、受信した順に処理します。
+		void dispatchIncomingMessages()
+		{
+			if (m_holdingCallbacks || (not m_incomingMessages))
+			{
+				return;
+			}
+
+			while (IncomingMessage* message = m_incomingMessages->front())
+			{
+				dispatchIncomingMessage(*message);
+				m_incomingMessages->pop();
+			}
+
+			if (m_incomingOverflowing.load(std::memory_order_acquire))
+			{
+				Array<IncomingMessage> overflow;
+				{
+					const std::lock_guard lock{ m_incomingOverflowMutex };
+					overflow.swap(m_incomingOverflow);
+					m_incomingOverflowing.store(false, std::memory_order_release);
+				}
+
+				for (auto& message : overflow)
+				{
+					dispatchIncomingMessage(message);
+				}
+			}
+		}
+
+		void setReceiveQueue(const bool enabled, const size_t capacity, const size_t byteCapacity)
+		{
+			flushReceiveQueue();
+
+			m_receiveQueueEnabled = enabled;
+			m_queuedEvents = Array<QueuedEvent>(enabled ? Max<size_t>(capacity, 1) : 0);
+			m_queuedObjects = Array<ExitGames::Common::Object>(m_queuedEvents.size());
+			m_queuedBytes = Array<uint8>(enabled ? byteCapacity : 0);
+			m_queueHead = 0;
+			m_queueCount = 0;
+			m_queuedBytesTail = 0;
+			m_queuedBytesUsed = 0;
+			m_receiveQueueStats = NetworkSystem::ReceiveQueueStats{};
+		}
+
+		[[nodiscard]]
+		bool getReceiveQueue() const noexcept
+		{
+			return m_receiveQueueEnabled;
+		}
+
+		size_t dispatchReceivedEvents(const NetworkSystem::ReceiveBudget& budget)
+		{
+			const uint64 startMicrosec = Time::GetMicrosec();
+			const uint64 maxMicrosec = static_cast<uint64>(Max(budget.maxTime.count(), 0.0) * 1'000'000);
+
+			size_t dispatched = 0;
+
+			while (m_queueCount)
+			{
+				if ((budget.maxEvents && (budget.maxEvents <= dispatched))
+					|| (dispatched && maxMicrosec && (maxMicrosec <= (Time::GetMicrosec() - startMicrosec))))
+				{
+					break;
+				}
+
+				dispatchOldestEvent();
+				++dispatched;
+			}
+
+			m_receiveQueueStats.lastDispatched = dispatched;
+			return dispatched;
+		}
+
+		/// @brief f を呼び、かかった時間を通信の統計に加算します。
+		template <class Function>
+		void measureService(Function f)
+		{
+			const uint64 startMicrosec = Time::GetMicrosec();
+
+			f();
+
+			const uint64 elapsedMicrosec = (Time::GetMicrosec() - startMicrosec);
+			m_lastServiceMicrosec.store(elapsedMicrosec, std::memory_order_relaxed);
+			m_totalServiceMicrosec.fetch_add(elapsedMicrosec, std::memory_order_relaxed);
+		}
+
+		void getNetworkStats(NetworkSystem::NetworkStats& stats) const
+		{
+			stats.receiveQueueBacklog = m_queueCount;
+			stats.lastServiceTime = Duration{ m_lastServiceMicrosec.load(std::memory_order_relaxed) / 1'000'000.0 };
+			stats.totalServiceTime = Duration{ m_totalServiceMicrosec.load(std::memory_order_relaxed) / 1'000'000.0 };
+			stats.receivedEvents = m_receivedEventTraffic;
+		}
+
+		void resetNetworkStats() noexcept
+		{
+			m_lastServiceMicrosec.store(0, std::memory_order_relaxed);
+			m_totalServiceMicrosec.store(0, std::memory_order_relaxed);
+			m_receivedEventTraffic.fill({});
+		}
+
+		[[nodiscard]]
+		NetworkSystem::ReceiveQueueStats getReceiveQueueStats() const
+		{
+			NetworkSystem::ReceiveQueueStats stats = m_receiveQueueStats;
+			stats.backlog = m_queueCount;
+			stats.backlogBytes = m_queuedBytesUsed;
+
+			if (m_queueCount)
+			{
+				stats.oldestAgeMillisec = ((Time::GetMicrosec() - m_queuedEvents[m_queueHead].receivedMicrosec) / 1000.0);
+			}
+
+			return stats;
+		}
+
+		void receivedEvent(const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent)
+		{
+			SIVPHOTON_LOG(Trace, U"SivPhoton::SivPhotonDetail::customEventAction() [ルームで他人が RaiseEvent したときの処理]");
+			SIVPHOTON_LOG(Trace, U"eventCode: ", int32(eventCode));
+
+			uint8 type = eventContent.getType();
+
+			if (type == ExitGames::Common::TypeCode::CUSTOM)
+			{
+				if (const auto function = m_receiveEventFunctions[eventContent.getCustomType()])
+				{
+					(this->*function)(playerID, eventCode, eventContent);
+				}
+				return;
+			}
+
+			if (type == ExitGames::Common::TypeCode::HASHTABLE)
+			{
+				const ExitGames::Common::ValueObject<ExitGames::Common::Hashtable> eventDataObject{ eventContent };
+				const ExitGames::Common::Hashtable& eventDataContent = *eventDataObject.getDataAddress();
+				const ExitGames::Common::JString arrayType = ExitGames::Common::ValueObject<ExitGames::Common::JString>(eventDataContent.getValue(L"ArrayType")).getDataCopy();
+
+				Optional<Size> gridSize;
+
+				if (arrayType == L"Grid")
+				{
+					gridSize = ExitGames::Common::ValueObject<PhotonPoint>(eventDataContent.getValue(L"xy")).getDataCopy().getValue();
+				}
+				else if (not (arrayType == L"Array"))
+				{
+					return;
+				}
+
+				const ExitGames::Common::Object* values = eventDataContent.getValue(L"values");
+				type = values->getType();
+
+				if (type == ExitGames::Common::TypeCode::CUSTOM)
+				{
+					const uint8 customType = values->getCustomType();
+
+					if (gridSize)
+					{
+						if (const auto function = m_receiveGridEventFunctions[customType])
+						{
+							(this->*function)(playerID, eventCode, values, *gridSize);
+						}
+					}
+					else if (const auto function = m_receiveArrayEventFunctions[customType])
+					{
+						(this->*function)(playerID, eventCode, values);
+					}
+					return;
+				}
+
+				switch (type)
+				{
+				case ExitGames::Common::TypeCode::INTEGER:
+					receivedLegacyValues<int32>(playerID, eventCode, values, gridSize);
+					return;
+				case ExitGames::Common::TypeCode::DOUBLE:
+					receivedLegacyValues<double>(playerID, eventCode, values, gridSize);
+					return;
+				case ExitGames::Common::TypeCode::FLOAT:
+					receivedLegacyValues<float>(playerID, eventCode, values, gridSize);
+					return;
+				case ExitGames::Common::TypeCode::BOOLEAN:
+					receivedLegacyValues<bool>(playerID, eventCode, values, gridSize);
+					return;
+				case ExitGames::Common::TypeCode::STRING:
+					receivedLegacyStrings(playerID, eventCode, values, gridSize);
+					return;
+				default:
+					return;
+				}
+			}
+
+			switch (type)
+			{
+			case ExitGames::Common::TypeCode::INTEGER:
+				dispatchEvent(playerID, eventCode, ExitGames::Common::ValueObject<int>(eventContent).getDataCopy());
+				return;
+			case ExitGames::Common::TypeCode::DOUBLE:
+				dispatchEvent(playerID, eventCode, ExitGames::Common::ValueObject<double>(eventContent).getDataCopy());
+				return;
+			case ExitGames::Common::TypeCode::FLOAT:
+				dispatchEvent(playerID, eventCode, ExitGames::Common::ValueObject<float>(eventContent).getDataCopy());
+				return;
+			case ExitGames::Common::TypeCode::BOOLEAN:
+				dispatchEvent(playerID, eventCode, ExitGames::Common::ValueObject<bool>(eventContent).getDataCopy());
+				return;
+			case ExitGames::Common::TypeCode::STRING:
+				dispatchEvent(playerID, eventCode, detail::ToString(ExitGames::Common::ValueObject<ExitGames::Common::JString>(eventContent).getDataCopy()));
+				return;
+			default:
+				break;
+			}
+		}
+
+		// connect() の結果を通知するコールバック
+		void connectReturn(int errorCode, const ExitGames::Common::JString& errorString, const ExitGames::Common::JString& region, const ExitGames::Common::JString& cluster) override
+		{
+			notifyConnect(errorCode, detail::ToString(errorString), detail::ToString(region), detail::ToString(cluster));
+		}
+
+		void notifyConnect(const int32 errorCode, const String& errorText, const String& regionText, const String& clusterText)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.connectReturn(errorCode, errorText, regionText, clusterText);
+				if (errorCode)
+				{
+					m_context.m_isUsePhoton = false;
+				}
+			});
+		}
+
+		// disconnect() の結果を通知するコールバック
+		void disconnectReturn() override
+		{
+			notifyDisconnect();
+		}
+
+		void notifyDisconnect()
+		{
+			runOnMainThread([this]
+			{
+				m_context.clearProperties();
+
+				if (not m_context.m_roomList.isEmpty())
+				{
+					m_context.updateRoomList({});
+				}
+
+				m_context.disconnectReturn();
+				m_context.m_isUsePhoton = false;
+			});
+		}
+
+		// 
+		void leaveRoomReturn(int errorCode, const ExitGames::Common::JString& errorString) override
+		{
+			notifyLeaveRoom(errorCode, detail::ToString(errorString));
+		}
+
+		void notifyLeaveRoom(const int32 errorCode, const String& errorText)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.clearProperties();
+				m_context.leaveRoomReturn(errorCode, errorText);
+			});
+		}
+
+		void joinRandomRoomReturn(int localPlayerID, const ExitGames::Common::Hashtable& roomProperties, const ExitGames::Common::Hashtable& playerProperties, int errorCode, const ExitGames::Common::JString& errorString) override
+		{
+			if (errorCode == 0)
+			{
+				notifyJoinedRoomProperties(detail::ToPropertyTable(roomProperties), detail::ToPlayerPropertyTables(playerProperties));
+			}
+
+			notifyJoinRandomRoom(localPlayerID, errorCode, detail::ToString(errorString));
+		}
+
+		// 作成した場合も参加した場合も、joinRandomRoomReturn() として通知する
+		void joinRandomOrCreateRoomReturn(int localPlayerID, const ExitGames::Common::Hashtable& roomProperties, const ExitGames::Common::Hashtable& playerProperties, int errorCode, const ExitGames::Common::JString& errorString) override
+		{
+			joinRandomRoomReturn(localPlayerID, roomProperties, playerProperties, errorCode, errorString);
+		}
+
+		void notifyJoinRandomRoom(const int32 localPlayerID, const int32 errorCode, const String& errorText)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.joinRandomRoomReturn(localPlayerID, errorCode, errorText);
+			});
+		}
+
+		void joinRoomReturn(int localPlayerID, const ExitGames::Common::Hashtable& roomProperties, const ExitGames::Common::Hashtable& playerProperties, int errorCode, const ExitGames::Common::JString& errorString) override
+		{
+			if (errorCode == 0)
+			{
+				notifyJoinedRoomProperties(detail::ToPropertyTable(roomProperties), detail::ToPlayerPropertyTables(playerProperties));
+			}
+
+			notifyJoinRoom(localPlayerID, errorCode, detail::ToString(errorString));
+		}
+
+		void notifyJoinRoom(const int32 localPlayerID, const int32 errorCode, const String& errorText)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.joinRoomReturn(localPlayerID, errorCode, errorText);
+			});
+		}
+
+		void createRoomReturn(int localPlayerID, const ExitGames::Common::Hashtable& roomProperties, const ExitGames::Common::Hashtable& playerProperties, int errorCode, const ExitGames::Common::JString& errorString) override
+		{
+			if (errorCode == 0)
+			{
+				notifyJoinedRoomProperties(detail::ToPropertyTable(roomProperties), detail::ToPlayerPropertyTables(playerProperties));
+			}
+
+			notifyCreateRoom(localPlayerID, errorCode, detail::ToString(errorString));
+		}
+
+		void notifyCreateRoom(const int32 localPlayerID, const int32 errorCode, const String& errorText)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.createRoomReturn(localPlayerID, errorCode, errorText);
+			});
+		}
+
+		/// @brief ルームへの参加が成功したときに、ルームと参加者のカスタムプロパティを通知します。
+		/// @remark 参加の結果 (joinRoomReturn() など) より前に呼びます。
+		void notifyJoinedRoomProperties(const detail::PropertyTable& roomProperties, const HashTable<int32, detail::PropertyTable>& playerProperties)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.joinedRoomProperties(roomProperties, playerProperties);
+			});
+		}
+
+		// ルームのカスタムプロパティが変更されたら呼ばれるコールバック
+		void onRoomPropertiesChange(const ExitGames::Common::Hashtable& changes) override
+		{
+			notifyRoomProperties(detail::ToPropertyTable(changes));
+		}
+
+		void notifyRoomProperties(const detail::PropertyTable& changes)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.updateRoomProperties(changes);
+			});
+		}
+
+		// プレイヤーのカスタムプロパティが変更されたら呼ばれるコールバック
+		void onPlayerPropertiesChange(const int playerID, const ExitGames::Common::Hashtable& changes) override
+		{
+			notifyPlayerProperties(playerID, detail::ToPropertyTable(changes));
+		}
+
+		void notifyPlayerProperties(const int32 playerID, const detail::PropertyTable& changes)
+		{
+			runOnMainThread([=, this]
+			{
+				m_context.updatePlayerProperties(playerID, changes);
+			});
+		}
+
+		// ロビーのルームの一覧が更新されたら呼ばれるコールバック
+		void onRoomListUpdate() override
+		{
+			notifyRoomList(detail::ToRoomList(m_context.getClient().getRoomList()));
+		}
+
+		void notifyRoomList(Array<NetworkSystem::RoomInfo> rooms)
+		{
+			runOnMainThread([this, rooms = std::move(rooms)]
+			{
+				m_context.updateRoomList(rooms);
+			});
+		}
+
+	private:
+
+		SivPhoton& m_context;
+
+		/// @brief 旧形式のカスタム型の受信処理 (添字はカスタム型の番号)
+		std::array<void (SivPhotonDetail::*)(const int, const nByte, const ExitGames::Common::Object&), 256> m_receiveEventFunctions{};
+
+		std::array<void (SivPhotonDetail::*)(const int, const nByte, const ExitGames::Common::Object*), 256> m_receiveArrayEventFunctions{};
+
+		std::array<void (SivPhotonDetail::*)(const int, const nByte, const ExitGames::Common::Object*, const Size), 256> m_receiveGridEventFunctions{};
+
+		/// @brief スレッド間のキューの大きさ
+		static constexpr size_t NetworkThreadQueueCapacity = 1024;
+
+		/// @brief メインスレッドからネットワークスレッドに渡す、送信するイベント
+		struct OutgoingEvent
+		{
+			uint8 eventCode = 0;
+
+			NetworkSystem::SendOptions options;
+
+			Array<uint8> bytes;
+		};
+
+		/// @brief ネットワークスレッドからメインスレッドに渡す、受信したイベントやコールバック
+		struct IncomingMessage
+		{
+			int32 playerID = 0;
+
+			uint8 eventCode = 0;
+
+			/// @brief 旧形式のイベントで、object に格納しているか
+			bool isObject = false;
+
+			/// @brief パック形式のイベントのバイト列
+			Array<uint8> bytes;
+
+			ExitGames::Common::Object object;
+
+			/// @brief イベント以外のコールバック (空でない場合はイベントではない)
+			std::function<void()> callback;
+		};
+
+		/// @brief ネットワークスレッドを使うか (メインスレッドのみが変更する)
+		bool m_networkThreadEnabled = false;
+
+		std::thread m_networkThread;
+
+		std::atomic<bool> m_stopNetworkThread{ false };
+
+		/// @brief m_transport を操作する間に取るロック (ネットワークスレッドは service() の間取る)
+		std::recursive_mutex m_clientMutex;
+
+		std::unique_ptr<detail::SpscQueue<OutgoingEvent>> m_outgoingEvents;
+
+		std::unique_ptr<detail::SpscQueue<IncomingMessage>> m_incomingMessages;
+
+		/// @brief m_incomingMessages に収まらなかったメッセージ
+		/// @remark ネットワークスレッドがメインスレッドを待つことがないように、メインスレッドが追いつくまでここに溜める
+		Array<IncomingMessage> m_incomingOverflow;
+
+		std::mutex m_incomingOverflowMutex;
+
+		/// @brief m_incomingOverflow にメッセージがあるか (ある間は、順序を保つために m_incomingMessages を使わない)
+		std::atomic<bool> m_incomingOverflowing{ false };
+
+		/// @brief コールバックとイベントを保留するか (メインスレッドのみが読み書きする)
+		bool m_holdingCallbacks = false;
+
+		/// @brief イベントコードごとの受信量 (メインスレッドのみが読み書きする)
+		std::array<NetworkSystem::EventTraffic, 256> m_receivedEventTraffic{};
+
+		/// @brief 最後に service() にかかった時間 (ネットワークスレッドからも書き込む)
+		std::atomic<uint64> m_lastServiceMicrosec{ 0 };
+
+		std::atomic<uint64> m_totalServiceMicrosec{ 0 };
+
+		/// @brief コールバックとイベントを m_incomingMessages を通して後で処理するか
+		[[nodiscard]]
+		bool isDeferred() const noexcept
+		{
+			// ネットワークスレッドからは m_holdingCallbacks を読まない
+			return (m_networkThreadEnabled || m_holdingCallbacks);
+		}
+
+		void createMessageQueues()
+		{
+			if (not m_outgoingEvents)
+			{
+				m_outgoingEvents = std::make_unique<detail::SpscQueue<OutgoingEvent>>(NetworkThreadQueueCapacity);
+				m_incomingMessages = std::make_unique<detail::SpscQueue<IncomingMessage>>(NetworkThreadQueueCapacity);
+			}
+		}
+
+		void runNetworkThread(const Duration interval)
+		{
+			while (not m_stopNetworkThread.load(std::memory_order_acquire))
+			{
+				{
+					const std::lock_guard lock{ m_clientMutex };
+
+					while (const OutgoingEvent* event = m_outgoingEvents->front())
+					{
+						sendOutgoingEvent(*event);
+						m_outgoingEvents->pop();
+					}
+
+					// コールバックは pushIncomingMessage() でメインスレッドに渡す
+					measureService([this] { m_context.m_transport->service(); });
+				}
+
+				std::this_thread::sleep_for(interval);
+			}
+		}
+
+		void sendOutgoingEvent(const OutgoingEvent& event)
+		{
+			m_context.m_transport->raiseEvent(event.bytes.data(), event.bytes.size(), event.eventCode, event.options);
+		}
+
+		/// @brief ネットワークスレッドからメインスレッドにメッセージを渡します。
+		/// @param fill メッセージを書き込む関数
+		template <class Fill>
+		void pushIncomingMessage(Fill&& fill)
+		{
+			if (not m_incomingOverflowing.load(std::memory_order_acquire))
+			{
+				if (IncomingMessage* message = m_incomingMessages->back())
+				{
+					message->callback = nullptr;
+					fill(*message);
+					m_incomingMessages->push();
+					return;
+				}
+			}
+
+			const std::lock_guard lock{ m_incomingOverflowMutex };
+			fill(m_incomingOverflow.emplace_back());
+			m_incomingOverflowing.store(true, std::memory_order_release);
+		}
+
+		/// @brief コールバックの処理をメインスレッドで実行します。
+		/// @remark ネットワークスレッドを使わず、保留もしていない場合は、その場で実行します。
+		template <class Function>
+		void runOnMainThread(Function&& function)
+		{
+			if (not isDeferred())
+			{
+				function();
+				return;
+			}
+
+			pushIncomingMessage([&](IncomingMessage& message)
+			{
+				message.callback = std::forward<Function>(function);
+			});
+		}
+
+		void dispatchIncomingMessage(IncomingMessage& message)
+		{
+			if (message.callback)
+			{
+				const auto callback = std::move(message.callback);
+				message.callback = nullptr;
+				callback();
+			}
+			else if (message.isObject)
+			{
+				acceptObject(message.playerID, message.eventCode, message.object);
+				message.object = ExitGames::Common::Object{};
+			}
+			else
+			{
+				acceptBytes(message.playerID, message.eventCode, message.bytes.data(), message.bytes.size());
+			}
+		}
+
+		/// @brief 受信したパック形式のイベントを、受信キューに溜めるかその場で処理します。
+		void acceptBytes(const int playerID, const nByte eventCode, const uint8* data, const size_t size)
+		{
+			if (not detail::IsWireBatch(data, size))
+			{
+				acceptEventBytes(playerID, eventCode, data, size);
+				return;
+			}
+
+			// まとめて送信されたイベントは、1 つずつに分ける
+			const uint8* it = (data + 1);
+			const uint8* const end = (data + size);
+
+			uint8 batchedEventCode = 0;
+			const uint8* event = nullptr;
+			size_t eventSize = 0;
+
+			while (detail::ReadBatchEntry(it, end, batchedEventCode, event, eventSize))
+			{
+				acceptEventBytes(playerID, batchedEventCode, event, eventSize);
+			}
+		}
+
+		void acceptEventBytes(const int playerID, const nByte eventCode, const uint8* data, const size_t size)
+		{
+			auto& traffic = m_receivedEventTraffic[eventCode];
+			++traffic.count;
+			traffic.bytes += size;
+
+			if (m_receiveQueueEnabled)
+			{
+				enqueueBytes(playerID, eventCode, data, size);
+			}
+			else
+			{
+				receivedBytes(playerID, eventCode, data, size);
+			}
+		}
+
+		/// @brief 受信した旧形式のイベントを、受信キューに溜めるかその場で処理します。
+		void acceptObject(const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent)
+		{
+			++m_receivedEventTraffic[eventCode].count;
+
+			if (m_receiveQueueEnabled)
+			{
+				enqueueObject(playerID, eventCode, eventContent);
+			}
+			else
+			{
+				receivedEvent(playerID, eventCode, eventContent);
+			}
+		}
+
+		/// @brief 受信キューに溜めたイベント
+		struct QueuedEvent
+		{
+			int32 playerID = 0;
+
+			uint8 eventCode = 0;
+
+			/// @brief 旧形式のイベントで、m_queuedObjects に格納しているか
+			bool isObject = false;
+
+			/// @brief m_queuedBytes での開始位置
+			size_t offset = 0;
+
+			size_t size = 0;
+
+			uint64 receivedMicrosec = 0;
+		};
+
+		/// @brief 受信キューを使うか
+		bool m_receiveQueueEnabled = false;
+
+		/// @brief 受信キューに溜めたイベント (リングバッファ)
+		Array<QueuedEvent> m_queuedEvents;
+
+		/// @brief 受信キューに溜めた旧形式のイベント (添字は m_queuedEvents と同じ)
+		Array<ExitGames::Common::Object> m_queuedObjects;
+
+		/// @brief 受信キューに溜めたパック形式のイベントのバイト列 (リングバッファ)
+		Array<uint8> m_queuedBytes;
+
+		/// @brief 最も古いイベントの m_queuedEvents での位置
+		size_t m_queueHead = 0;
+
+		/// @brief 受信キューに溜めたイベントの数
+		size_t m_queueCount = 0;
+
+		/// @brief 次のバイト列を書き込む m_queuedBytes での位置
+		size_t m_queuedBytesTail = 0;
+
+		/// @brief 受信キューに溜めたバイト列の合計
+		size_t m_queuedBytesUsed = 0;
+
+		NetworkSystem::ReceiveQueueStats m_receiveQueueStats;
+
+		void enqueueObject(const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent)
+		{
+			// バイト列を持たないため、必ず空きを作れる
+			const size_t offset = *reserveQueuedEvent(0);
+			const size_t index = pushQueuedEvent(playerID, eventCode, true, offset, 0);
+			m_queuedObjects[index] = eventContent;
+		}
+
+		void enqueueBytes(const int playerID, const nByte eventCode, const uint8* data, const size_t size)
+		{
+			const auto offset = reserveQueuedEvent(size);
+
+			if (not offset)
+			{
+				// キュー全体より大きいイベントはその場で処理するため、先に受信したイベントをすべて処理して順序を保つ
+				flushReceiveQueue();
+
+				++m_receiveQueueStats.overflowed;
+				receivedBytes(playerID, eventCode, data, size);
+				return;
+			}
+
+			if (size)
+			{
+				std::memcpy((m_queuedBytes.data() + *offset), data, size);
+			}
+
+			pushQueuedEvent(playerID, eventCode, false, *offset, size);
+		}
+
+		/// @brief 受信キューにイベント 1 つとバイト列の空きを作ります。
+		/// @param size バイト列の大きさ
+		/// @return バイト列を書き込む位置, キュー全体に収まらない場合は none
+		[[nodiscard]]
+		Optional<size_t> reserveQueuedEvent(const size_t size)
+		{
+			if (m_queuedBytes.size() < size)
+			{
+				return none;
+			}
+
+			for (;;)
+			{
+				if (m_queueCount == 0)
+				{
+					m_queuedBytesTail = 0;
+					return 0;
+				}
+
+				if (m_queueCount < m_queuedEvents.size())
+				{
+					const size_t head = m_queuedEvents[m_queueHead].offset;
+
+					if (head <= m_queuedBytesTail)
+					{
+						// [head, tail) が使用中
+						if (size <= (m_queuedBytes.size() - m_queuedBytesTail))
+						{
+							return m_queuedBytesTail;
+						}
+
+						if (size < head)
+						{
+							return 0;
+						}
+					}
+					else if (size < (head - m_queuedBytesTail))
+					{
+						// [head, end) と [0, tail) が使用中
+						return m_queuedBytesTail;
+					}
+				}
+
+				// 空きがなければ、古いイベントをその場で処理する
+				++m_receiveQueueStats.overflowed;
+				dispatchOldestEvent();
+			}
+		}
+
+		size_t pushQueuedEvent(const int playerID, const nByte eventCode, const bool isObject, const size_t offset, const size_t size)
+		{
+			const size_t index = ((m_queueHead + m_queueCount) % m_queuedEvents.size());
+			m_queuedEvents[index] = QueuedEvent{ playerID, eventCode, isObject, offset, size, Time::GetMicrosec() };
+
+			++m_queueCount;
+			m_queuedBytesTail = (offset + size);
+			m_queuedBytesUsed += size;
+			m_receiveQueueStats.peakBacklog = Max(m_receiveQueueStats.peakBacklog, m_queueCount);
+
+			return index;
+		}
+
+		void dispatchOldestEvent()
+		{
+			const QueuedEvent& event = m_queuedEvents[m_queueHead];
+
+			if (event.isObject)
+			{
+				receivedEvent(event.playerID, event.eventCode, m_queuedObjects[m_queueHead]);
+				m_queuedObjects[m_queueHead] = ExitGames::Common::Object{};
+			}
+			else
+			{
+				receivedBytes(event.playerID, event.eventCode, (m_queuedBytes.data() + event.offset), event.size);
+			}
+
+			m_queuedBytesUsed -= event.size;
+			m_queueHead = ((m_queueHead + 1) % m_queuedEvents.size());
+			--m_queueCount;
+		}
+
+		/// @brief 受信キューに溜めたイベントをすべて処理します。
+		void flushReceiveQueue()
+		{
+			while (m_queueCount)
+			{
+				dispatchOldestEvent();
+			}
+		}
+
+		/// @brief アラインメントが揃っていない受信データを一時的にコピーするためのバッファ
+		Array<uint64> m_alignedBuffer;
+
+		/// @brief Grid の差分送信の受信側の状態
+		struct ReceivedGrid
+		{
+			detail::WireElement element{};
+
+			/// @brief 最後に受信した通し番号
+			uint32 sequence = 0;
+
+			Size size{ 0, 0 };
+
+			/// @brief 全セルの要素の並び (アラインメントを揃えるため uint64 で確保する)
+			Array<uint64> cells;
+
+			/// @brief キーフレームの再送を要求済みか
+			bool keyframeRequested = false;
+
+			/// @brief キーフレームの再送を要求したときに受信した差分の通し番号
+			uint32 keyframeRequestSequence = 0;
+		};
+
+		/// @brief Grid の差分送信の受信側の状態 (キーは (playerID << 8) | eventCode)
+		HashTable<uint64, ReceivedGrid> m_receivedGrids;
+
+		/// @brief 送信者ごとの文字列表 (ID 順, 登録を受け取っていない ID は none)
+		HashTable<int32, Array<Optional<String>>> m_receivedStringTables;
+
+		/// @brief 文字列表の登録を受け取っていない参照を含むため保留したイベント
+		struct PendingStringEvent
+		{
+			nByte eventCode = 0;
+
+			Array<uint8> bytes;
+		};
+
+		/// @brief 送信者ごとに保留したイベント (受信した順)
+		/// @remark 参加した直後は、送信者が参加を知る前に送った参照が届くことがあります。送信者の StringTable が届いたら順に処理します。
+		HashTable<int32, Array<PendingStringEvent>> m_pendingStringEvents;
+
+		/// @brief 受信した文字列のうち、文字列表に登録されないものを並べて格納するバッファ
+		String m_receivedStringArena;
+
+		/// @brief 受信した文字列ひとつの位置
+		struct ReceivedStringRange
+		{
+			/// @brief 文字列表の文字列か
+			bool inTable = false;
+
+			/// @brief 文字列表の ID, または m_receivedStringArena での開始位置
+			uint32 index = 0;
+
+			/// @brief m_receivedStringArena での長さ
+			size_t length = 0;
+		};
+
+		Array<ReceivedStringRange> m_receivedStringRanges;
+
+		Array<StringView> m_receivedStringViews;
+
+		/// @brief 受信したイベントを、登録されたイベントハンドラ、なければ customEventAction に渡します。
+		template <class Type>
+		void dispatchEvent(const int playerID, const nByte eventCode, const Type& eventContent)
+		{
+			if (not m_context.m_eventHandlers.call(eventCode, playerID, eventContent))
+			{
+				m_context.customEventAction(playerID, eventCode, eventContent);
+			}
+		}
+
+		void receivedBytes(const int playerID, const nByte eventCode, const uint8* data, const size_t size)
+		{
+			if (const auto custom = detail::ReadCustomTypeHeader(data, size))
+			{
+				dispatchEvent(playerID, eventCode, NetworkSystem::SerializedValue{ custom->typeID, custom->begin, custom->end });
+			}
+			else if (detail::IsGridReplication(data, size))
+			{
+				receivedGridReplication(playerID, eventCode, data, size);
+			}
+			else if (const auto vars = detail::ReadNetworkVarsHeader(data, size))
+			{
+				m_context.receivedNetworkVars(*vars);
+			}
+			else if (const auto strings = detail::ReadStringHeader(data, size))
+			{
+				receivedStrings(playerID, eventCode, *strings, data, size);
+			}
+			else
+			{
+				receivedPackedEvent(playerID, eventCode, data, size);
+			}
+		}
+
+		void receivedStrings(const int playerID, const nByte eventCode, const detail::WireStringHeader& header, const uint8* data, const size_t size)
+		{
+			if (header.container == detail::WireContainer::StringTable)
+			{
+				receivedStringTable(playerID, header);
+				return;
+			}
+
+			// 保留中のイベントより先に処理すると、送信した順序が入れ替わる
+			if (const auto it = m_pendingStringEvents.find(playerID);
+				it != m_pendingStringEvents.end())
+			{
+				holdStringEvent(it->second, playerID, eventCode, data, size);
+				return;
+			}
+
+			if (not decodeStrings(playerID, eventCode, header))
+			{
+				holdStringEvent(m_pendingStringEvents[playerID], playerID, eventCode, data, size);
+			}
+		}
+
+		void receivedStringTable(const int playerID, detail::WireStringHeader header)
+		{
+			Array<Optional<String>>& table = m_receivedStringTables[playerID];
+
+			for (size_t i = 0; i < header.count; ++i)
+			{
+				const auto token = detail::ReadStringToken(header.it, header.end);
+
+				if ((not token)
+					|| (not token->isDefinition))
+				{
+					break;
+				}
+
+				if (table.size() <= token->id)
+				{
+					table.resize(token->id + 1);
+				}
+
+				String& value = table[token->id].emplace();
+				detail::AppendUTF8(value, token->begin, token->end);
+			}
+
+			// 登録がそろったイベントを受信した順に処理する
+			const auto it = m_pendingStringEvents.find(playerID);
+
+			if (it == m_pendingStringEvents.end())
+			{
+				return;
+			}
+
+			Array<PendingStringEvent>& pending = it->second;
+			size_t processed = 0;
+
+			for (; processed < pending.size(); ++processed)
+			{
+				const PendingStringEvent& event = pending[processed];
+				const auto strings = detail::ReadStringHeader(event.bytes.data(), event.bytes.size());
+
+				if (strings && (not decodeStrings(playerID, event.eventCode, *strings)))
+				{
+					break;
+				}
+			}
+
+			if (processed == pending.size())
+			{
+				m_pendingStringEvents.erase(it);
+			}
+			else
+			{
+				pending.erase(pending.begin(), (pending.begin() + processed));
+			}
+		}
+
+		void holdStringEvent(Array<PendingStringEvent>& pending, const int playerID, const nByte eventCode, const uint8* data, const size_t size)
+		{
+			if (detail::WireMaxPendingStringEvents <= pending.size())
+			{
+				SIVPHOTON_LOG(Warning, U"文字列表の登録を受け取れないため、保留したイベントを破棄しました。playerID: ", playerID);
+				pending.erase(pending.begin());
+			}
+
+			pending.push_back(PendingStringEvent{ eventCode, Array<uint8>(data, (data + size)) });
+		}
+
+		/// @brief 文字列の並びを読み取ってイベントとして渡します。
+		/// @return 渡した場合や形式が不正で破棄した場合 true, 文字列表の登録を受け取っていない参照を含む場合は false
+		[[nodiscard]]
+		bool decodeStrings(const int playerID, const nByte eventCode, detail::WireStringHeader header)
+		{
+			Array<Optional<String>>& table = m_receivedStringTables[playerID];
+
+			// 文字列表の文字列は登録によって移動しうるため、先にすべて読み取ってからビューを作る
+			m_receivedStringArena.clear();
+			m_receivedStringRanges.clear();
+
+			for (size_t i = 0; i < header.count; ++i)
+			{
+				const auto token = detail::ReadStringToken(header.it, header.end);
+
+				if (not token)
+				{
+					return true;
+				}
+
+				if (token->isReference)
+				{
+					if ((table.size() <= token->id)
+						|| (not table[token->id]))
+					{
+						// 送信者が参加を知る前に送った参照は、StringTable が届くまで解決できない
+						return false;
+					}
+
+					m_receivedStringRanges.push_back(ReceivedStringRange{ true, token->id, 0 });
+				}
+				else if (token->isDefinition)
+				{
+					if (table.size() <= token->id)
+					{
+						table.resize(token->id + 1);
+					}
+
+					String& value = table[token->id].emplace();
+					detail::AppendUTF8(value, token->begin, token->end);
+
+					m_receivedStringRanges.push_back(ReceivedStringRange{ true, token->id, 0 });
+				}
+				else
+				{
+					const size_t offset = m_receivedStringArena.size();
+					detail::AppendUTF8(m_receivedStringArena, token->begin, token->end);
+
+					m_receivedStringRanges.push_back(ReceivedStringRange{ false, static_cast<uint32>(offset), (m_receivedStringArena.size() - offset) });
+				}
+			}
+
+			if (header.container == detail::WireContainer::Value)
+			{
+				const auto& range = m_receivedStringRanges.front();
+				dispatchEvent(playerID, eventCode, (range.inTable ? *table[range.index] : m_receivedStringArena));
+				return true;
+			}
+
+			m_receivedStringViews.clear();
+
+			for (const auto& range : m_receivedStringRanges)
+			{
+				if (range.inTable)
+				{
+					m_receivedStringViews.push_back(StringView{ *table[range.index] });
+				}
+				else
+				{
+					m_receivedStringViews.push_back(StringView{ (m_receivedStringArena.data() + range.index), range.length });
+				}
+			}
+
+			if (header.container == detail::WireContainer::Array)
+			{
+				dispatchEvent(playerID, eventCode, std::span<const StringView>{ m_receivedStringViews.data(), m_receivedStringViews.size() });
+			}
+			else
+			{
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<StringView>{ m_receivedStringViews.data(), header.size });
+			}
+
+			return true;
+		}
+
+		void receivedPackedEvent(const int playerID, const nByte eventCode, const uint8* data, const size_t size)
+		{
+			const auto header = detail::ReadWireHeader(data, size);
+
+			if (not header)
+			{
+				return;
+			}
+
+			switch (header->element)
+			{
+			case detail::WireElement::Int32:
+				receivedPackedValues<int32>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::Double:
+				receivedPackedValues<double>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::Float:
+				receivedPackedValues<float>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::Bool:
+				receivedPackedValues<bool>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::Point:
+				receivedPackedValues<Point>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::Vec2:
+				receivedPackedValues<Vec2>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::Rect:
+				receivedPackedValues<Rect>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::Circle:
+				receivedPackedValues<Circle>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::QuantizedVec2:
+				receivedQuantizedValues<Vec2>(playerID, eventCode, *header, data);
+				return;
+			case detail::WireElement::QuantizedCircle:
+				receivedQuantizedValues<Circle>(playerID, eventCode, *header, data);
+				return;
+			default:
+				return;
+			}
+		}
+
+		template <class T>
+		void receivedPackedValues(const int playerID, const nByte eventCode, const detail::WireHeader& header, const uint8* data)
+		{
+			const T* values = alignedPayload<T>((data + header.payloadOffset), header.count);
+
+			if (header.container == detail::WireContainer::Value)
+			{
+				dispatchEvent(playerID, eventCode, *values);
+			}
+			else if (header.container == detail::WireContainer::Array)
+			{
+				dispatchEvent(playerID, eventCode, std::span<const T>{ values, header.count });
+			}
+			else
+			{
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<T>{ values, header.size });
+			}
+		}
+
+		void receivedGridReplication(const int playerID, const nByte eventCode, const uint8* data, const size_t size)
+		{
+			if (const auto target = detail::ReadKeyframeRequest(data, size))
+			{
+				if (*target == m_context.getNumber())
+				{
+					m_context.raiseGridKeyframe(eventCode, playerID);
+				}
+				return;
+			}
+
+			const auto update = detail::ReadGridUpdateHeader(data, size);
+
+			if (not update)
+			{
+				return;
+			}
+
+			ReceivedGrid& grid = m_receivedGrids[((static_cast<uint64>(playerID) << 8) | eventCode)];
+
+			if (update->container == detail::WireContainer::GridKeyframe)
+			{
+				// 受信したバイト数と一致することを確認してから確保する
+				const uint8* const cells = detail::ReadGridKeyframe(*update);
+
+				if (not cells)
+				{
+					// 以前の状態に差分を適用しないよう破棄し、次の差分でキーフレームを要求する
+					grid = ReceivedGrid{};
+					return;
+				}
+
+				const size_t byteCount = (update->num_elements() * detail::WireElementSize(update->element));
+
+				grid.cells.resize((byteCount + sizeof(uint64) - 1) / sizeof(uint64));
+
+				if (byteCount)
+				{
+					std::memcpy(grid.cells.data(), cells, byteCount);
+				}
+
+				grid.element = update->element;
+				grid.size = update->size;
+				grid.keyframeRequested = false;
+			}
+			else
+			{
+				const bool continuous = ((grid.element == update->element)
+					&& (grid.size == update->size)
+					&& ((grid.sequence + 1) == update->sequence));
+
+				// 途中から受信した場合や取りこぼした場合はキーフレームを待つ
+				if ((not continuous)
+					|| (not detail::ApplyGridDelta(*update, reinterpret_cast<uint8*>(grid.cells.data()))))
+				{
+					// 信頼性のない送信では再送要求やキーフレームが失われることがあるため、応答がなければ要求し直す
+					if ((not grid.keyframeRequested)
+						|| (detail::WireKeyframeRequestRetry <= (update->sequence - grid.keyframeRequestSequence)))
+					{
+						grid.keyframeRequested = true;
+						grid.keyframeRequestSequence = update->sequence;
+						m_context.raiseKeyframeRequest(eventCode, playerID);
+					}
+					return;
+				}
+			}
+
+			grid.sequence = update->sequence;
+
+			receivedGridCells(playerID, eventCode, grid.element, grid.cells.data(), grid.size);
+		}
+
+		void receivedGridCells(const int playerID, const nByte eventCode, const detail::WireElement element, const uint64* cells, const Size size)
+		{
+			switch (element)
+			{
+			case detail::WireElement::Int32:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<int32>{ reinterpret_cast<const int32*>(cells), size });
+				return;
+			case detail::WireElement::Double:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<double>{ reinterpret_cast<const double*>(cells), size });
+				return;
+			case detail::WireElement::Float:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<float>{ reinterpret_cast<const float*>(cells), size });
+				return;
+			case detail::WireElement::Bool:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<bool>{ reinterpret_cast<const bool*>(cells), size });
+				return;
+			case detail::WireElement::Point:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<Point>{ reinterpret_cast<const Point*>(cells), size });
+				return;
+			case detail::WireElement::Vec2:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<Vec2>{ reinterpret_cast<const Vec2*>(cells), size });
+				return;
+			case detail::WireElement::Rect:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<Rect>{ reinterpret_cast<const Rect*>(cells), size });
+				return;
+			case detail::WireElement::Circle:
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<Circle>{ reinterpret_cast<const Circle*>(cells), size });
+				return;
+			default:
+				return;
+			}
+		}
+
+		template <class T>
+		void receivedQuantizedValues(const int playerID, const nByte eventCode, const detail::WireHeader& header, const uint8* data)
+		{
+			Array<T> values(header.count);
+
+			if (not detail::ReadQuantized(values.data(), header.count, (data + header.payloadOffset), header.format, m_context.m_quantizationProfiles[eventCode]))
+			{
+				return;
+			}
+
+			if (header.container == detail::WireContainer::Value)
+			{
+				dispatchEvent(playerID, eventCode, values.front());
+			}
+			else if (header.container == detail::WireContainer::Array)
+			{
+				dispatchEvent(playerID, eventCode, std::span<const T>{ values.data(), values.size() });
+			}
+			else
+			{
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<T>{ values.data(), header.size });
+			}
+		}
+
+		/// @brief 要素の並びを T の配列として参照できるポインタを返します。
+		/// @remark アラインメントが揃っていない場合のみ m_alignedBuffer にコピーします。
+		template <class T>
+		const T* alignedPayload(const uint8* payload, const size_t count)
+		{
+			if ((reinterpret_cast<std::uintptr_t>(payload) % alignof(T)) == 0)
+			{
+				return reinterpret_cast<const T*>(payload);
+			}
+
+			m_alignedBuffer.resize(((sizeof(T) * count) + sizeof(uint64) - 1) / sizeof(uint64));
+			std::memcpy(m_alignedBuffer.data(), payload, (sizeof(T) * count));
+			return reinterpret_cast<const T*>(m_alignedBuffer.data());
+		}
+
+		template <class T>
+		void receivedLegacyValues(const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Optional<Size>& gridSize)
+		{
+			const ExitGames::Common::ValueObject<T*> valueObject{ eventContent };
+			const T* values = *valueObject.getDataAddress();
+			const size_t length = static_cast<size_t>(*valueObject.getSizes());
+
+			if (gridSize)
+			{
+				if ((static_cast<size_t>(gridSize->x) * gridSize->y) != length)
+				{
+					return;
+				}
+
+				dispatchEvent(playerID, eventCode, NetworkSystem::GridView<T>{ values, *gridSize });
+			}
+			else
+			{
+				dispatchEvent(playerID, eventCode, std::span<const T>{ values, length });
+			}
+		}
+
+		void receivedLegacyStrings(const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Optional<Size>& gridSize)
+		{
+			const ExitGames::Common::ValueObject<ExitGames::Common::JString*> valueObject{ eventContent };
+			const ExitGames::Common::JString* values = *valueObject.getDataAddress();
+			const size_t length = static_cast<size_t>(*valueObject.getSizes());
+
+			Array<String> data;
+			data.reserve(length);
+
+			for (const auto i : step(length))
+			{
+				data << detail::ToString(values[i]);
+			}
+
+			if (gridSize)
+			{
+				if ((static_cast<size_t>(gridSize->x) * gridSize->y) != length)
+				{
+					return;
+				}
+
+				dispatchEvent(playerID, eventCode, Grid<String>{ *gridSize, std::move(data) });
+			}
+			else
+			{
+				dispatchEvent(playerID, eventCode, data);
+			}
+		}
+
+		template <class T, uint8 N>
+		void receivedCustomType(const int playerID, const nByte eventCode, const ExitGames::Common::Object& eventContent)
+		{
+			auto value = ExitGames::Common::ValueObject<SivCustomType<T, N>>(eventContent).getDataCopy().getValue();
+			dispatchEvent(playerID, eventCode, value);
+		}
+
+		template <class T, uint8 N>
+		void receivedCustomArrayType(const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent)
+		{
+			const ExitGames::Common::ValueObject<SivCustomType<T, N>*> valueObject{ eventContent };
+			const SivCustomType<T, N>* values = *valueObject.getDataAddress();
+			const size_t length = static_cast<size_t>(*valueObject.getSizes());
+
+			Array<T> data;
+			data.reserve(length);
+
+			for (const auto i : step(length))
+			{
+				data << values[i].getValue();
+			}
+
+			dispatchEvent(playerID, eventCode, data);
+		}
+
+		template <class T, uint8 N>
+		void receivedCustomGridType(const int playerID, const nByte eventCode, const ExitGames::Common::Object* eventContent, const Size size)
+		{
+			const ExitGames::Common::ValueObject<SivCustomType<T, N>*> valueObject{ eventContent };
+			const SivCustomType<T, N>* values = *valueObject.getDataAddress();
+			const size_t length = static_cast<size_t>(*valueObject.getSizes());
+
+			if ((static_cast<size_t>(size.x) * size.y) != length)
+			{
+				return;
+			}
+
+			Array<T> data;
+			data.reserve(length);
+
+			for (const auto i : step(length))
+			{
+				data << values[i].getValue();
+			}
+
+			dispatchEvent(playerID, eventCode, Grid<T>{ size, std::move(data) });
+		}
+	};
+}
+
+namespace s3d::NetworkSystem
+{
+	/// @brief ループバックの仮想サーバで、SQL ロビーの条件式を評価します。
+	/// @remark 比較演算子 (=, <>, !=, <, <=, >, >=), AND, OR, NOT, 括弧、整数と '文字列' のリテラルに対応します。
+	/// 存在しないプロパティとの比較は偽になります。
+	class SqlLobbyFilter
+	{
+	public:
+
+		/// @brief properties が条件式 filter を満たすかを返します。
+		/// @return 条件式が正しく、かつ条件を満たす場合 true
+		[[nodiscard]]
+		static bool Matches(const StringView filter, const MatchmakingProperties& properties)
+		{
+			SqlLobbyFilter parser{ filter, properties };
+			const bool result = parser.parseOr();
+			parser.skipSpaces();
+
+			return (parser.m_valid && (parser.m_pos == parser.m_text.size()) && result);
+		}
+
+	private:
+
+		StringView m_text;
+
+		const MatchmakingProperties& m_properties;
+
+		size_t m_pos = 0;
+
+		bool m_valid = true;
+
+		SqlLobbyFilter(const StringView text, const MatchmakingProperties& properties)
+			: m_text{ text }
+			, m_properties{ properties } {}
+
+		void skipSpaces()
+		{
+			while ((m_pos < m_text.size()) && (m_text[m_pos] == U' '))
+			{
+				++m_pos;
+			}
+		}
+
+		[[nodiscard]]
+		bool accept(const StringView token)
+		{
+			skipSpaces();
+
+			if (m_text.substr(m_pos, token.size()) != token)
+			{
+				return false;
+			}
+
+			m_pos += token.size();
+			return true;
+		}
+
+		/// @brief 大文字と小文字を区別せずにキーワードを読み取ります。
+		[[nodiscard]]
+		bool acceptKeyword(const StringView keyword)
+		{
+			skipSpaces();
+
+			if (m_text.size() < (m_pos + keyword.size()))
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < keyword.size(); ++i)
+			{
+				if (ToUpper(m_text[m_pos + i]) != keyword[i])
+				{
+					return false;
+				}
+			}
+
+			const size_t end = (m_pos + keyword.size());
+
+			if ((end < m_text.size()) && (IsAlnum(m_text[end]) || (m_text[end] == U'_')))
+			{
+				return false;
+			}
+
+			m_pos = end;
+			return true;
+		}
+
+		bool parseOr()
+		{
+			bool result = parseAnd();
+
+			while (m_valid && acceptKeyword(U"OR"))
+			{
+				const bool rhs = parseAnd();
+				result = (result || rhs);
+			}
+
+			return result;
+		}
+
+		bool parseAnd()
+		{
+			bool result = parseNot();
+
+			while (m_valid && acceptKeyword(U"AND"))
+			{
+				const bool rhs = parseNot();
+				result = (result && rhs);
+			}
+
+			return result;
+		}
+
+		bool parseNot()
+		{
+			if (acceptKeyword(U"NOT"))
+			{
+				return (not parseNot());
+			}
+
+			return parseComparison();
+		}
+
+		bool parseComparison()
+		{
+			if (accept(U"("))
+			{
+				const bool result = parseOr();
+
+				if (not accept(U")"))
+				{
+					m_valid = false;
+				}
+
+				return result;
+			}
+
+			const Optional<MatchmakingValue> lhs = parseOperand();
+			const StringView op = parseOperator();
+			const Optional<MatchmakingValue> rhs = parseOperand();
+
+			if ((not m_valid) || op.empty())
+			{
+				m_valid = false;
+				return false;
+			}
+
+			return (lhs && rhs && Compare(*lhs, op, *rhs));
+		}
+
+		[[nodiscard]]
+		StringView parseOperator()
+		{
+			// 2 文字の演算子を先に調べる
+			static constexpr std::array<StringView, 7> Operators{ U"<=", U">=", U"<>", U"!=", U"=", U"<", U">" };
+
+			for (const StringView op : Operators)
+			{
+				if (accept(op))
+				{
+					return op;
+				}
+			}
+
+			return{};
+		}
+
+		/// @brief プロパティ名またはリテラルを読み取ります。
+		/// @return 値, 存在しないプロパティの場合や構文が正しくない場合は none
+		[[nodiscard]]
+		Optional<MatchmakingValue> parseOperand()
+		{
+			skipSpaces();
+
+			if (m_text.size() <= m_pos)
+			{
+				m_valid = false;
+				return none;
+			}
+
+			const size_t begin = m_pos;
+
+			if (m_text[m_pos] == U'\'')
+			{
+				const size_t end = m_text.find(U'\'', (begin + 1));
+
+				if (end == StringView::npos)
+				{
+					m_valid = false;
+					return none;
+				}
+
+				m_pos = (end + 1);
+				return MatchmakingValue{ String{ m_text.substr((begin + 1), (end - begin - 1)) } };
+			}
+
+			if ((m_text[m_pos] == U'-') || IsDigit(m_text[m_pos]))
+			{
+				++m_pos;
+
+				while ((m_pos < m_text.size()) && IsDigit(m_text[m_pos]))
+				{
+					++m_pos;
+				}
+
+				if (const auto number = ParseOpt<int32>(m_text.substr(begin, (m_pos - begin))))
+				{
+					return MatchmakingValue{ *number };
+				}
+
+				m_valid = false;
+				return none;
+			}
+
+			while ((m_pos < m_text.size()) && (IsAlnum(m_text[m_pos]) || (m_text[m_pos] == U'_')))
+			{
+				++m_pos;
+			}
+
+			if (m_pos == begin)
+			{
+				m_valid = false;
+				return none;
+			}
+
+			if (const auto it = m_properties.find(String{ m_text.substr(begin, (m_pos - begin)) }); it != m_properties.end())
+			{
+				return it->second;
+			}
+
+			return none;
+		}
+
+		/// @brief 同じ型の値を比較します。型が異なる場合は偽になります。
+		[[nodiscard]]
+		static bool Compare(const MatchmakingValue& lhs, const StringView op, const MatchmakingValue& rhs)
+		{
+			if (lhs.index() != rhs.index())
+			{
+				return false;
+			}
+
+			const int32 order = std::visit([&](const auto& a)
+			{
+				const auto& b = std::get<std::decay_t<decltype(a)>>(rhs);
+				return ((a < b) ? -1 : ((b < a) ? 1 : 0));
+			}, lhs);
+
+			if (op == U"=")
+			{
+				return (order == 0);
+			}
+			else if ((op == U"<>") || (op == U"!="))
+			{
+				return (order != 0);
+			}
+			else if (op == U"<")
+			{
+				return (order < 0);
+			}
+			else if (op == U"<=")
+			{
+				return (order <= 0);
+			}
+			else if (op == U">")
+			{
+				return (0 < order);
+			}
+			else
+			{
+				return (0 <= order);
+			}
+		}
+	};
+
+	class LoopbackNetwork
+	{
+	public:
+
+		/// @brief 仮想サーバからクライアントに届けるメッセージ
+		struct Message
+		{
+			enum class Type : uint8
+			{
+				Connect,
+
+				Disconnect,
+
+				CreateRoom,
+
+				JoinRoom,
+
+				JoinRandomRoom,
+
+				LeaveRoom,
+
+				PlayerJoined,
+
+				PlayerLeft,
+
+				Event,
+
+				RoomProperties,
+
+				PlayerProperties,
+
+				RoomList,
+			};
+
+			Type type = Type::Event;
+
+			/// @brief 操作の結果では自分の ID, 参加・退室・イベントでは相手の ID
+			int32 playerID = 0;
+
+			int32 errorCode = 0;
+
+			/// @brief PlayerJoined が自分の参加か
+			bool isSelf = false;
+
+			uint8 eventCode = 0;
+
+			/// @brief PlayerJoined の時点のルームの参加者一覧
+			Array<int32> playerIDs;
+
+			/// @brief イベントのバイト列
+			Array<uint8> bytes;
+
+			/// @brief 参加の結果ではルームのカスタムプロパティ, RoomProperties, PlayerProperties では変更された項目
+			s3d::detail::PropertyTable properties;
+
+			/// @brief 参加の結果での、参加者のカスタムプロパティ
+			HashTable<int32, s3d::detail::PropertyTable> playerProperties;
+
+			/// @brief RoomList でのロビーのルームの一覧
+			Array<RoomInfo> rooms;
+		};
+
+		/// @brief クライアントを登録します。
+		/// @return クライアントのハンドル
+		[[nodiscard]]
+		uint64 addClient()
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			const uint64 handle = ++m_lastHandle;
+			m_clients.emplace(handle, Client{});
+			return handle;
+		}
+
+		/// @brief クライアントの登録を解除します。ルームにいる場合は、他の参加者に退室を通知します。
+		void removeClient(const uint64 handle)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			leave(handle);
+			m_clients.erase(handle);
+		}
+
+		void connect(const uint64 handle, const StringView userName)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Client& client = m_clients[handle];
+			client.connected = true;
+			client.userName = String{ userName };
+			client.userID = U"{}{}"_fmt(userName, Time::GetMillisec());
+			client.inbox << Message{ .type = Message::Type::Connect };
+			client.inbox << Message{ .type = Message::Type::RoomList, .rooms = makeRoomList() };
+		}
+
+		void disconnect(const uint64 handle)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Client& client = m_clients[handle];
+
+			if (not client.connected)
+			{
+				return;
+			}
+
+			leave(handle);
+			client.connected = false;
+			client.inbox << Message{ .type = Message::Type::Disconnect };
+		}
+
+		void createRoom(const uint64 handle, const StringView roomName, const RoomCreateOptions& options)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			create(handle, roomName, options, Message::Type::CreateRoom);
+		}
+
+		void joinRoom(const uint64 handle, const StringView roomName)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Room* room = findRoom(roomName);
+
+			if (not room)
+			{
+				reply(handle, Message::Type::JoinRoom, ErrorCode::GameDoesNotExist);
+			}
+			else if (not room->isOpen)
+			{
+				reply(handle, Message::Type::JoinRoom, ErrorCode::GameClosed);
+			}
+			else if (room->isFull())
+			{
+				reply(handle, Message::Type::JoinRoom, ErrorCode::GameFull);
+			}
+			else
+			{
+				enter(handle, room->name, Message::Type::JoinRoom);
+			}
+		}
+
+		/// @brief 条件に合うルームを選んで参加させます。
+		/// @param createOptions nullptr でない場合、条件に合うルームがなければルームを作成して参加させる
+		void joinRandomRoom(const uint64 handle, const MatchmakingOptions& options, const StringView roomName, const RoomCreateOptions* createOptions)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Array<String> candidates;
+
+			for (const auto& room : m_rooms)
+			{
+				if (isMatch(room, options))
+				{
+					candidates << room.name;
+				}
+			}
+
+			if (candidates.isEmpty())
+			{
+				if (createOptions)
+				{
+					create(handle, roomName, *createOptions, Message::Type::JoinRandomRoom);
+				}
+				else
+				{
+					reply(handle, Message::Type::JoinRandomRoom, ErrorCode::NoRandomMatchFound);
+				}
+
+				return;
+			}
+
+			size_t index = 0;
+
+			switch (options.mode)
+			{
+			case MatchmakingMode::SerialMatching:
+				index = (m_serialMatchingCount++ % candidates.size());
+				break;
+			case MatchmakingMode::RandomMatching:
+				index = Random(candidates.size() - 1);
+				break;
+			default:
+				// 古いルームから詰める (m_rooms は作成された順)
+				break;
+			}
+
+			enter(handle, candidates[index], Message::Type::JoinRandomRoom);
+		}
+
+		void leaveRoom(const uint64 handle)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			leave(handle);
+			m_clients[handle].inbox << Message{ .type = Message::Type::LeaveRoom };
+		}
+
+		void changeGroups(const uint64 handle, const std::bitset<256>& groupsToRemove, const std::bitset<256>& groupsToAdd)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Client& client = m_clients[handle];
+			client.groups &= ~groupsToRemove;
+			client.groups |= groupsToAdd;
+		}
+
+		void clearGroups(const uint64 handle)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			m_clients[handle].groups.reset();
+		}
+
+		/// @brief イベントを、送信先のプレイヤーの受信箱に入れます。
+		/// @remark イベントキャッシュは扱いません。
+		void raiseEvent(const uint64 handle, const uint8* data, const size_t size, const uint8 eventCode, const SendOptions& options)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Client& sender = m_clients[handle];
+			const Room* room = findRoom(sender.roomName);
+
+			if (not room)
+			{
+				return;
+			}
+
+			sender.bytesOut += size;
+			++sender.packetsOut;
+
+			for (const auto& player : room->players)
+			{
+				Client& receiver = m_clients[player.handle];
+
+				if (not isReceiver(*room, sender, player, receiver, options))
+				{
+					continue;
+				}
+
+				receiver.bytesIn += size;
+				++receiver.packetsIn;
+				receiver.inbox << Message{ .type = Message::Type::Event, .playerID = sender.playerID, .eventCode = eventCode, .bytes = Array<uint8>(data, (data + size)) };
+			}
+		}
+
+		/// @brief ルームのカスタムプロパティの項目を変更し、参加者に通知します。
+		/// @param expectedValue nullptr でない場合、現在の値がこれと等しいときのみ変更し、変更した本人にも通知する
+		void setRoomProperty(const uint64 handle, const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			const Client& sender = m_clients[handle];
+			Room* room = findRoom(sender.roomName);
+			const String name{ key };
+
+			if ((not room)
+				|| (expectedValue && (not isExpectedValue(room->properties, name, *expectedValue))))
+			{
+				return;
+			}
+
+			room->properties[name] = value;
+			broadcastProperties(*room, handle, Message{ .type = Message::Type::RoomProperties, .playerID = sender.playerID, .properties = { { name, value } } }, (expectedValue != nullptr));
+
+			if (room->propertiesListedInLobby.contains(name))
+			{
+				publishRoomList();
+			}
+		}
+
+		void setPropertiesListedInLobby(const uint64 handle, const Array<String>& keys)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			if (Room* room = findRoom(m_clients.at(handle).roomName))
+			{
+				room->propertiesListedInLobby = keys;
+				publishRoomList();
+			}
+		}
+
+		/// @brief クライアントのカスタムプロパティの項目を変更し、ルームにいる場合は参加者に通知します。
+		/// @param expectedValue nullptr でない場合、現在の値がこれと等しいときのみ変更し、変更した本人にも通知する
+		void setPlayerProperty(const uint64 handle, const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Client& sender = m_clients[handle];
+			const String name{ key };
+
+			if (expectedValue && (not isExpectedValue(sender.properties, name, *expectedValue)))
+			{
+				return;
+			}
+
+			sender.properties[name] = value;
+
+			if (const Room* room = findRoom(sender.roomName))
+			{
+				broadcastProperties(*room, handle, Message{ .type = Message::Type::PlayerProperties, .playerID = sender.playerID, .properties = { { name, value } } }, (expectedValue != nullptr));
+			}
+		}
+
+		/// @brief 受信箱のメッセージを取り出します。
+		void takeMessages(const uint64 handle, Array<Message>& messages)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			messages.swap(m_clients[handle].inbox);
+		}
+
+		[[nodiscard]]
+		String getUserName(const uint64 handle) const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			return m_clients.at(handle).userName;
+		}
+
+		[[nodiscard]]
+		String getUserID(const uint64 handle) const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			return m_clients.at(handle).userID;
+		}
+
+		/// @brief クライアントがいるルームの状態
+		struct RoomState
+		{
+			String name;
+
+			int32 playerCount = 0;
+
+			int32 maxPlayers = 0;
+
+			bool isOpen = true;
+
+			bool isVisible = true;
+
+			int32 masterClientID = 0;
+		};
+
+		/// @brief クライアントがいるルームの状態を返します。
+		/// @return ルームの状態, ルームにいない場合は none
+		[[nodiscard]]
+		Optional<RoomState> getRoomState(const uint64 handle) const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			const Room* room = findRoom(m_clients.at(handle).roomName);
+
+			if (not room)
+			{
+				return none;
+			}
+
+			return RoomState{ room->name, static_cast<int32>(room->players.size()), room->maxPlayers, room->isOpen, room->isVisible, room->masterClientID };
+		}
+
+		void setIsOpen(const uint64 handle, const bool isOpen)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			if (Room* room = findRoom(m_clients.at(handle).roomName))
+			{
+				room->isOpen = isOpen;
+				publishRoomList();
+			}
+		}
+
+		void setIsVisible(const uint64 handle, const bool isVisible)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			if (Room* room = findRoom(m_clients.at(handle).roomName))
+			{
+				room->isVisible = isVisible;
+				publishRoomList();
+			}
+		}
+
+		[[nodiscard]]
+		int32 getPlayerID(const uint64 handle) const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			return m_clients.at(handle).playerID;
+		}
+
+		/// @brief 仮想サーバを作成してからの時間 (ミリ秒) を返します。
+		[[nodiscard]]
+		int32 getServerTime() const noexcept
+		{
+			return static_cast<int32>(Time::GetMillisec() - m_startMillisec);
+		}
+
+		[[nodiscard]]
+		int32 getCountGamesRunning() const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			return static_cast<int32>(m_rooms.size());
+		}
+
+		[[nodiscard]]
+		int32 getCountPlayersIngame() const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			size_t count = 0;
+
+			for (const auto& room : m_rooms)
+			{
+				count += room.players.size();
+			}
+
+			return static_cast<int32>(count);
+		}
+
+		[[nodiscard]]
+		int32 getCountPlayersOnline() const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			int32 count = 0;
+
+			for (const auto& [handle, client] : m_clients)
+			{
+				count += client.connected;
+			}
+
+			return count;
+		}
+
+		void getStats(const uint64 handle, NetworkStats& stats) const
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			const Client& client = m_clients.at(handle);
+			stats.bytesIn = client.bytesIn;
+			stats.bytesOut = client.bytesOut;
+			stats.packetsIn = client.packetsIn;
+			stats.packetsOut = client.packetsOut;
+			stats.queuedIncomingCommands = static_cast<int32>(client.inbox.size());
+		}
+
+		void resetStats(const uint64 handle)
+		{
+			const std::lock_guard lock{ m_mutex };
+
+			Client& client = m_clients[handle];
+			client.packetsIn = 0;
+			client.packetsOut = 0;
+		}
+
+	private:
+
+		/// @brief Photon のサーバと同じエラーコード
+		struct ErrorCode
+		{
+			static constexpr int32 GameIdAlreadyExists = 32766;
+
+			static constexpr int32 GameFull = 32765;
+
+			static constexpr int32 GameClosed = 32764;
+
+			static constexpr int32 NoRandomMatchFound = 32760;
+
+			static constexpr int32 GameDoesNotExist = 32758;
+		};
+
+		struct Client
+		{
+			bool connected = false;
+
+			String userName;
+
+			String userID;
+
+			/// @brief いるルームの名前 (ルームにいない場合は空)
+			String roomName;
+
+			/// @brief ルーム内でのプレイヤー ID (ルームにいない場合は -1)
+			int32 playerID = -1;
+
+			std::bitset<256> groups;
+
+			/// @brief カスタムプロパティ (ルームを移っても引き継ぐ)
+			s3d::detail::PropertyTable properties;
+
+			Array<Message> inbox;
+
+			int64 bytesIn = 0;
+
+			int64 bytesOut = 0;
+
+			int64 packetsIn = 0;
+
+			int64 packetsOut = 0;
+		};
+
+		struct Player
+		{
+			int32 playerID = 0;
+
+			uint64 handle = 0;
+		};
+
+		struct Room
+		{
+			String name;
+
+			int32 maxPlayers = 0;
+
+			bool isOpen = true;
+
+			bool isVisible = true;
+
+			/// @brief 次に参加したプレイヤーの ID
+			int32 nextPlayerID = 1;
+
+			int32 masterClientID = 0;
+
+			Array<Player> players;
+
+			s3d::detail::PropertyTable properties;
+
+			/// @brief ロビーのルームの一覧に公開するカスタムプロパティのキー
+			Array<String> propertiesListedInLobby;
+
+			String lobbyName;
+
+			LobbyType lobbyType = LobbyType::Default;
+
+			MatchmakingProperties matchmakingProperties;
+
+			[[nodiscard]]
+			bool isFull() const noexcept
+			{
+				// 0 は人数の制限なし
+				return ((0 < maxPlayers) && (maxPlayers <= static_cast<int32>(players.size())));
+			}
+		};
+
+		mutable std::mutex m_mutex;
+
+		HashTable<uint64, Client> m_clients;
+
+		Array<Room> m_rooms;
+
+		uint64 m_lastHandle = 0;
+
+		uint32 m_lastRoomNumber = 0;
+
+		/// @brief MatchmakingMode::SerialMatching で振り分けた回数
+		size_t m_serialMatchingCount = 0;
+
+		uint64 m_startMillisec = Time::GetMillisec();
+
+		[[nodiscard]]
+		Room* findRoom(const StringView roomName)
+		{
+			if (roomName.empty())
+			{
+				return nullptr;
+			}
+
+			for (auto& room : m_rooms)
+			{
+				if (room.name == roomName)
+				{
+					return &room;
+				}
+			}
+
+			return nullptr;
+		}
+
+		[[nodiscard]]
+		const Room* findRoom(const StringView roomName) const
+		{
+			return const_cast<LoopbackNetwork*>(this)->findRoom(roomName);
+		}
+
+		void reply(const uint64 handle, const Message::Type type, const int32 errorCode)
+		{
+			m_clients[handle].inbox << Message{ .type = type, .playerID = -1, .errorCode = errorCode };
+		}
+
+		/// @brief ルームを作成して参加させます。
+		void create(const uint64 handle, const StringView roomName, const RoomCreateOptions& options, const Message::Type type)
+		{
+			// 名前を指定しない場合は、サーバが名前を付ける
+			const String name = (roomName.empty() ? U"LoopbackRoom{}"_fmt(++m_lastRoomNumber) : String{ roomName });
+
+			if (findRoom(name))
+			{
+				reply(handle, type, ErrorCode::GameIdAlreadyExists);
+				return;
+			}
+
+			m_rooms << Room{
+				.name = name,
+				.maxPlayers = Clamp(options.maxPlayers, 0, 255),
+				.isOpen = options.isOpen,
+				.isVisible = options.isVisible,
+				.lobbyName = options.lobbyName,
+				.lobbyType = options.lobbyType,
+				.matchmakingProperties = options.matchmakingProperties,
+			};
+
+			enter(handle, name, type);
+		}
+
+		/// @brief ルームがランダムな参加の条件に合うかを返します。
+		[[nodiscard]]
+		static bool isMatch(const Room& room, const MatchmakingOptions& options)
+		{
+			if ((not room.isOpen)
+				|| (not room.isVisible)
+				|| room.isFull()
+				|| (options.maxPlayers && (room.maxPlayers != options.maxPlayers))
+				|| (room.lobbyName != options.lobbyName)
+				|| (room.lobbyType != options.lobbyType))
+			{
+				return false;
+			}
+
+			for (const auto& [key, value] : options.expectedProperties)
+			{
+				const auto it = room.matchmakingProperties.find(key);
+
+				if ((it == room.matchmakingProperties.end())
+					|| (it->second != value))
+				{
+					return false;
+				}
+			}
+
+			if ((options.lobbyType == LobbyType::SqlLobby)
+				&& (not options.sqlFilter.isEmpty()))
+			{
+				return SqlLobbyFilter::Matches(options.sqlFilter, room.matchmakingProperties);
+			}
+
+			return true;
+		}
+
+		/// @brief ルームに参加させ、参加者全員に通知します。
+		void enter(const uint64 handle, const String roomName, const Message::Type type)
+		{
+			// 別のルームにいる場合は先に退室する (退室で m_rooms が変わるため、名前で探し直す)
+			leave(handle);
+
+			Room* room = findRoom(roomName);
+
+			if (not room)
+			{
+				reply(handle, type, ErrorCode::GameDoesNotExist);
+				return;
+			}
+
+			Room& target = *room;
+
+			Client& client = m_clients[handle];
+			const int32 playerID = target.nextPlayerID++;
+
+			client.roomName = target.name;
+			client.playerID = playerID;
+			client.groups.reset();
+
+			if (target.players.isEmpty())
+			{
+				target.masterClientID = playerID;
+			}
+
+			target.players << Player{ playerID, handle };
+
+			Array<int32> playerIDs;
+
+			for (const auto& player : target.players)
+			{
+				playerIDs << player.playerID;
+			}
+
+			HashTable<int32, s3d::detail::PropertyTable> playerProperties;
+
+			for (const auto& player : target.players)
+			{
+				if (const auto& properties = m_clients[player.handle].properties; (not properties.empty()))
+				{
+					playerProperties.emplace(player.playerID, properties);
+				}
+			}
+
+			client.inbox << Message{ .type = type, .playerID = playerID, .properties = target.properties, .playerProperties = std::move(playerProperties) };
+
+			for (const auto& player : target.players)
+			{
+				m_clients[player.handle].inbox << Message{ .type = Message::Type::PlayerJoined, .playerID = playerID, .isSelf = (player.handle == handle), .playerIDs = playerIDs };
+			}
+
+			// ルームの外で設定していたカスタムプロパティを、他の参加者に通知する
+			if (not client.properties.empty())
+			{
+				broadcastProperties(target, handle, Message{ .type = Message::Type::PlayerProperties, .playerID = playerID, .properties = client.properties }, false);
+			}
+
+			publishRoomList();
+		}
+
+		/// @brief ルームから退室させ、他の参加者に通知します。
+		void leave(const uint64 handle)
+		{
+			Client& client = m_clients[handle];
+			Room* room = findRoom(client.roomName);
+
+			client.roomName.clear();
+			const int32 playerID = std::exchange(client.playerID, -1);
+
+			if (not room)
+			{
+				return;
+			}
+
+			room->players.remove_if([=](const Player& player) { return (player.handle == handle); });
+
+			if (room->players.isEmpty())
+			{
+				const String roomName = room->name;
+				m_rooms.remove_if([&](const Room& r) { return (r.name == roomName); });
+				publishRoomList();
+				return;
+			}
+
+			// マスタークライアントが退室した場合は、ID が最も小さいプレイヤーに引き継ぐ
+			if (room->masterClientID == playerID)
+			{
+				room->masterClientID = room->players.front().playerID;
+
+				for (const auto& player : room->players)
+				{
+					room->masterClientID = Min(room->masterClientID, player.playerID);
+				}
+			}
+
+			for (const auto& player : room->players)
+			{
+				m_clients[player.handle].inbox << Message{ .type = Message::Type::PlayerLeft, .playerID = playerID };
+			}
+
+			publishRoomList();
+		}
+
+		/// @brief ロビーのルームの一覧を作成します。
+		/// @remark Photon と同様に、既定のロビーの公開されたルームのみを含め、カスタムプロパティは公開するキーのみを含めます。
+		[[nodiscard]]
+		Array<RoomInfo> makeRoomList() const
+		{
+			Array<RoomInfo> rooms;
+
+			for (const auto& room : m_rooms)
+			{
+				if ((not room.isVisible)
+					|| (not room.lobbyName.isEmpty())
+					|| (room.lobbyType != LobbyType::Default))
+				{
+					continue;
+				}
+
+				RoomInfo info{ room.name, static_cast<int32>(room.players.size()), room.maxPlayers, room.isOpen };
+				info.matchmakingProperties = room.matchmakingProperties;
+
+				for (const auto& key : room.propertiesListedInLobby)
+				{
+					if (const auto it = room.properties.find(key); it != room.properties.end())
+					{
+						info.properties.emplace(key, it->second);
+					}
+				}
+
+				rooms << std::move(info);
+			}
+
+			return rooms;
+		}
+
+		/// @brief ロビーにいる (接続していてルームにいない) クライアントに、ルームの一覧を通知します。
+		void publishRoomList()
+		{
+			const Array<RoomInfo> rooms = makeRoomList();
+
+			for (auto& [handle, client] : m_clients)
+			{
+				if (client.connected && client.roomName.isEmpty())
+				{
+					client.inbox << Message{ .type = Message::Type::RoomList, .rooms = rooms };
+				}
+			}
+		}
+
+		/// @brief カスタムプロパティの変更を参加者に通知します。
+		/// @param toSelf 変更した本人にも通知するか
+		void broadcastProperties(const Room& room, const uint64 handle, const Message& message, const bool toSelf)
+		{
+			for (const auto& player : room.players)
+			{
+				if (toSelf || (player.handle != handle))
+				{
+					m_clients[player.handle].inbox << message;
+				}
+			}
+		}
+
+		/// @brief カスタムプロパティの項目の現在の値が expectedValue と等しいかを返します。
+		[[nodiscard]]
+		static bool isExpectedValue(const s3d::detail::PropertyTable& properties, const String& key, const Array<uint8>& expectedValue)
+		{
+			const auto it = properties.find(key);
+
+			return ((it != properties.end()) && (it->second == expectedValue));
+		}
+
+		[[nodiscard]]
+		static bool isReceiver(const Room& room, const Client& sender, const Player& player, const Client& receiver, const SendOptions& options)
+		{
+			const bool isSender = (player.playerID == sender.playerID);
+
+			if (options.interestGroup)
+			{
+				return ((not isSender) && receiver.groups[options.interestGroup]);
+			}
+
+			if (not options.targetPlayers.isEmpty())
+			{
+				return options.targetPlayers.contains(player.playerID);
+			}
+
+			switch (options.receiverGroup)
+			{
+			case ReceiverGroup::All:
+				return true;
+			case ReceiverGroup::MasterClient:
+				return (player.playerID == room.masterClientID);
+			default:
+				return (not isSender);
+			}
+		}
+	};
+
+	std::shared_ptr<LoopbackNetwork> CreateLoopbackNetwork()
+	{
+		return std::make_shared<LoopbackNetwork>();
+	}
+}
+
+namespace s3d
+{
+	class SivPhoton::PhotonTransport : public SivPhoton::Transport
+	{
+	public:
+
+		explicit PhotonTransport(ExitGames::LoadBalancing::Client& client)
+			: m_client{ client }
+		{
+			m_client.setTrafficStatsEnabled(true);
+		}
+
+		bool connect(const StringView userName) override
+		{
+			const auto userNameJ = detail::ToJString(userName);
+			const auto userID = ExitGames::LoadBalancing::AuthenticationValues{}
+			.setUserID(userNameJ + GETTIMEMS());
+
+			if (not m_client.connect({ userID, userNameJ }))
+			{
+				return false;
+			}
+
+			m_client.fetchServerTimestamp();
+			return true;
+		}
+
+		void disconnect() override
+		{
+			m_client.disconnect();
+		}
+
+		void service() override
+		{
+			m_client.service();
+		}
+
+		void dispatchIncomingCommands() override
+		{
+			m_client.serviceBasic();
+
+			while (m_client.dispatchIncomingCommands())
+			{
+			}
+		}
+
+		void sendOutgoingCommands() override
+		{
+			while (m_client.sendOutgoingCommands())
+			{
+			}
+		}
+
+		void joinRandomRoom(const NetworkSystem::MatchmakingOptions& options) override
+		{
+			m_client.opJoinRandomRoom(detail::ToHashtable(options.expectedProperties), static_cast<nByte>(Clamp(options.maxPlayers, 0, 255)), static_cast<nByte>(options.mode),
+				detail::ToJString(options.lobbyName), detail::ToLobbyType(options.lobbyType), SqlFilter(options));
+		}
+
+		void joinRandomOrCreateRoom(const NetworkSystem::MatchmakingOptions& options, const StringView roomName, const NetworkSystem::RoomCreateOptions& createOptions) override
+		{
+			m_client.opJoinRandomOrCreateRoom(detail::ToJString(roomName), detail::ToRoomOptions(createOptions), detail::ToHashtable(options.expectedProperties), static_cast<nByte>(Clamp(options.maxPlayers, 0, 255)), static_cast<nByte>(options.mode),
+				detail::ToJString(options.lobbyName), detail::ToLobbyType(options.lobbyType), SqlFilter(options));
+		}
+
+		void joinRoom(const StringView roomName, const bool rejoin) override
+		{
+			m_client.opJoinRoom(detail::ToJString(roomName), rejoin);
+		}
+
+		void createRoom(const StringView roomName, const NetworkSystem::RoomCreateOptions& options) override
+		{
+			m_client.opCreateRoom(detail::ToJString(roomName), detail::ToRoomOptions(options));
+		}
+
+		void leaveRoom() override
+		{
+			constexpr bool willComeBack = false;
+
+			m_client.opLeaveRoom(willComeBack);
+		}
+
+		void changeGroups(const std::bitset<256>& groupsToRemove, const std::bitset<256>& groupsToAdd) override
+		{
+			ExitGames::Common::JVector<nByte> remove, add;
+
+			for (size_t group = 1; group < 256; ++group)
+			{
+				if (groupsToRemove[group])
+				{
+					remove.addElement(static_cast<nByte>(group));
+				}
+
+				if (groupsToAdd[group])
+				{
+					add.addElement(static_cast<nByte>(group));
+				}
+			}
+
+			// nullptr は変更しないことを表す
+			m_client.opChangeGroups((groupsToRemove.any() ? &remove : nullptr), (groupsToAdd.any() ? &add : nullptr));
+		}
+
+		void clearGroups() override
+		{
+			// 空の一覧はすべてのグループを表す
+			const ExitGames::Common::JVector<nByte> all;
+
+			m_client.opChangeGroups(&all, nullptr);
+		}
+
+		void raiseEvent(const uint8* data, const size_t size, const uint8 eventCode, const NetworkSystem::SendOptions& options) override
+		{
+			m_client.opRaiseEvent(options.reliable, data, static_cast<int>(size), eventCode, detail::ToRaiseEventOptions(options));
+		}
+
+		String getName() const override
+		{
+			return detail::ToString(m_client.getLocalPlayer().getName());
+		}
+
+		String getUserID() const override
+		{
+			return detail::ToString(m_client.getLocalPlayer().getUserID());
+		}
+
+		bool isInRoom() const override
+		{
+			return m_client.getIsInGameRoom();
+		}
+
+		String getRoomName() const override
+		{
+			return detail::ToString(m_client.getCurrentlyJoinedRoom().getName());
+		}
+
+		int32 getPlayerCount() const override
+		{
+			return m_client.getCurrentlyJoinedRoom().getPlayerCount();
+		}
+
+		int32 getMaxPlayers() const override
+		{
+			return m_client.getCurrentlyJoinedRoom().getMaxPlayers();
+		}
+
+		bool getIsOpen() const override
+		{
+			return m_client.getCurrentlyJoinedRoom().getIsOpen();
+		}
+
+		bool getIsVisible() const override
+		{
+			return m_client.getCurrentlyJoinedRoom().getIsVisible();
+		}
+
+		void setIsOpen(const bool isOpen) override
+		{
+			m_client.getCurrentlyJoinedRoom().setIsOpen(isOpen);
+		}
+
+		void setIsVisible(const bool isVisible) override
+		{
+			m_client.getCurrentlyJoinedRoom().setIsVisible(isVisible);
+		}
+
+		int32 getCountGamesRunning() const override
+		{
+			return m_client.getCountGamesRunning();
+		}
+
+		int32 getCountPlayersIngame() const override
+		{
+			return m_client.getCountPlayersIngame();
+		}
+
+		int32 getCountPlayersOnline() const override
+		{
+			return m_client.getCountPlayersOnline();
+		}
+
+		int32 getLocalPlayerNumber() const override
+		{
+			return m_client.getLocalPlayer().getNumber();
+		}
+
+		int32 getServerTime() const override
+		{
+			return m_client.getServerTime();
+		}
+
+		bool isMasterClient() const override
+		{
+			return m_client.getLocalPlayer().getIsMasterClient();
+		}
+
+		void getStats(NetworkSystem::NetworkStats& stats) const override
+		{
+			const auto& incoming = m_client.getTrafficStatsIncoming();
+			const auto& outgoing = m_client.getTrafficStatsOutgoing();
+
+			stats.roundTripTime = m_client.getRoundTripTime();
+			stats.roundTripTimeVariance = m_client.getRoundTripTimeVariance();
+			stats.bytesIn = m_client.getBytesIn();
+			stats.bytesOut = m_client.getBytesOut();
+			stats.packetsIn = incoming.getTotalPacketCount();
+			stats.packetsOut = outgoing.getTotalPacketCount();
+			stats.resentReliableCommands = m_client.getResentReliableCommands();
+			stats.queuedIncomingCommands = m_client.getQueuedIncomingCommands();
+			stats.queuedOutgoingCommands = m_client.getQueuedOutgoingCommands();
+		}
+
+		void resetStats() override
+		{
+			m_client.resetTrafficStats();
+		}
+
+		bool supportsObjectEvents() const noexcept override
+		{
+			return true;
+		}
+
+		void setRoomProperty(const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue) override
+		{
+			m_client.getCurrentlyJoinedRoom().mergeCustomProperties(detail::ToHashtable(key, value), (expectedValue ? detail::ToHashtable(key, *expectedValue) : ExitGames::Common::Hashtable{}));
+		}
+
+		void setPlayerProperty(const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue) override
+		{
+			m_client.getLocalPlayer().mergeCustomProperties(detail::ToHashtable(key, value), (expectedValue ? detail::ToHashtable(key, *expectedValue) : ExitGames::Common::Hashtable{}));
+		}
+
+		void setPropertiesListedInLobby(const Array<String>& keys) override
+		{
+			ExitGames::Common::JVector<ExitGames::Common::JString> props;
+
+			for (const auto& key : keys)
+			{
+				props.addElement(detail::ToJString(key));
+			}
+
+			// マッチメイキング用のプロパティは常に公開する
+			for (const auto& [key, value] : detail::ToMatchmakingProperties(m_client.getCurrentlyJoinedRoom().getCustomProperties()))
+			{
+				props.addElement(detail::ToJString(key));
+			}
+
+			m_client.getCurrentlyJoinedRoom().setPropsListedInLobby(props);
+		}
+
+	private:
+
+		ExitGames::LoadBalancing::Client& m_client;
+
+		/// @brief SQL ロビーの条件式 (SQL ロビー以外では使われないため空にする)
+		[[nodiscard]]
+		static ExitGames::Common::JString SqlFilter(const NetworkSystem::MatchmakingOptions& options)
+		{
+			return ((options.lobbyType == NetworkSystem::LobbyType::SqlLobby) ? detail::ToJString(options.sqlFilter) : ExitGames::Common::JString{});
+		}
+	};
+
+	class SivPhoton::LoopbackTransport : public SivPhoton::Transport
+	{
+	public:
+
+		LoopbackTransport(SivPhotonDetail& listener, const std::shared_ptr<NetworkSystem::LoopbackNetwork>& network)
+			: m_listener{ listener }
+			, m_network{ network }
+			, m_handle{ network->addClient() } {}
+
+		~LoopbackTransport() override
+		{
+			m_network->removeClient(m_handle);
+		}
+
+		bool connect(const StringView userName) override
+		{
+			m_network->connect(m_handle, userName);
+			return true;
+		}
+
+		void disconnect() override
+		{
+			m_network->disconnect(m_handle);
+		}
+
+		void service() override
+		{
+			dispatchIncomingCommands();
+		}
+
+		void dispatchIncomingCommands() override
+		{
+			m_network->takeMessages(m_handle, m_messages);
+
+			for (const auto& message : m_messages)
+			{
+				dispatchMessage(message);
+			}
+
+			m_messages.clear();
+		}
+
+		void sendOutgoingCommands() override
+		{
+			// イベントは raiseEvent() の時点で受信箱に届いている
+		}
+
+		void joinRandomRoom(const NetworkSystem::MatchmakingOptions& options) override
+		{
+			m_network->joinRandomRoom(m_handle, options, U"", nullptr);
+		}
+
+		void joinRandomOrCreateRoom(const NetworkSystem::MatchmakingOptions& options, const StringView roomName, const NetworkSystem::RoomCreateOptions& createOptions) override
+		{
+			m_network->joinRandomRoom(m_handle, options, roomName, &createOptions);
+		}
+
+		void joinRoom(const StringView roomName, const bool) override
+		{
+			m_network->joinRoom(m_handle, roomName);
+		}
+
+		void createRoom(const StringView roomName, const NetworkSystem::RoomCreateOptions& options) override
+		{
+			m_network->createRoom(m_handle, roomName, options);
+		}
+
+		void leaveRoom() override
+		{
+			m_network->leaveRoom(m_handle);
+		}
+
+		void changeGroups(const std::bitset<256>& groupsToRemove, const std::bitset<256>& groupsToAdd) override
+		{
+			m_network->changeGroups(m_handle, groupsToRemove, groupsToAdd);
+		}
+
+		void clearGroups() override
+		{
+			m_network->clearGroups(m_handle);
+		}
+
+		void raiseEvent(const uint8* data, const size_t size, const uint8 eventCode, const NetworkSystem::SendOptions& options) override
+		{
+			m_network->raiseEvent(m_handle, data, size, eventCode, options);
+		}
+
+		String getName() const override
+		{
+			return m_network->getUserName(m_handle);
+		}
+
+		String getUserID() const override
+		{
+			return m_network->getUserID(m_handle);
+		}
+
+		bool isInRoom() const override
+		{
+			return m_network->getRoomState(m_handle).has_value();
+		}
+
+		String getRoomName() const override
+		{
+			return getRoomState().name;
+		}
+
+		int32 getPlayerCount() const override
+		{
+			return getRoomState().playerCount;
+		}
+
+		int32 getMaxPlayers() const override
+		{
+			return getRoomState().maxPlayers;
+		}
+
+		bool getIsOpen() const override
+		{
+			return getRoomState().isOpen;
+		}
+
+		bool getIsVisible() const override
+		{
+			return getRoomState().isVisible;
+		}
+
+		void setIsOpen(const bool isOpen) override
+		{
+			m_network->setIsOpen(m_handle, isOpen);
+		}
+
+		void setIsVisible(const bool isVisible) override
+		{
+			m_network->setIsVisible(m_handle, isVisible);
+		}
+
+		int32 getCountGamesRunning() const override
+		{
+			return m_network->getCountGamesRunning();
+		}
+
+		int32 getCountPlayersIngame() const override
+		{
+			return m_network->getCountPlayersIngame();
+		}
+
+		int32 getCountPlayersOnline() const override
+		{
+			return m_network->getCountPlayersOnline();
+		}
+
+		int32 getLocalPlayerNumber() const override
+		{
+			return m_network->getPlayerID(m_handle);
+		}
+
+		int32 getServerTime() const override
+		{
+			return m_network->getServerTime();
+		}
+
+		bool isMasterClient() const override
+		{
+			const auto room = m_network->getRoomState(m_handle);
+
+			return (room && (room->masterClientID == m_network->getPlayerID(m_handle)));
+		}
+
+		void getStats(NetworkSystem::NetworkStats& stats) const override
+		{
+			m_network->getStats(m_handle, stats);
+		}
+
+		void resetStats() override
+		{
+			m_network->resetStats(m_handle);
+		}
+
+		bool supportsObjectEvents() const noexcept override
+		{
+			return false;
+		}
+
+		void setRoomProperty(const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue) override
+		{
+			m_network->setRoomProperty(m_handle, key, value, expectedValue);
+		}
+
+		void setPlayerProperty(const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue) override
+		{
+			m_network->setPlayerProperty(m_handle, key, value, expectedValue);
+		}
+
+		void setPropertiesListedInLobby(const Array<String>& keys) override
+		{
+			m_network->setPropertiesListedInLobby(m_handle, keys);
+		}
+
+	private:
+
+		using Message = NetworkSystem::LoopbackNetwork::Message;
+
+		SivPhotonDetail& m_listener;
+
+		std::shared_ptr<NetworkSystem::LoopbackNetwork> m_network;
+
+		uint64 m_handle;
+
+		/// @brief 受信箱から取り出したメッセージ (確保したメモリを使い回す)
+		Array<Message> m_messages;
+
+		[[nodiscard]]
+		NetworkSystem::LoopbackNetwork::RoomState getRoomState() const
+		{
+			return m_network->getRoomState(m_handle).value_or(NetworkSystem::LoopbackNetwork::RoomState{});
+		}
+
+		void dispatchMessage(const Message& message)
+		{
+			switch (message.type)
+			{
+			case Message::Type::Connect:
+				m_listener.notifyConnect(message.errorCode, U"", U"loopback", U"");
+				return;
+			case Message::Type::Disconnect:
+				m_listener.notifyDisconnect();
+				return;
+			case Message::Type::CreateRoom:
+				notifyJoinedRoomProperties(message);
+				m_listener.notifyCreateRoom(message.playerID, message.errorCode, ErrorString(message.errorCode));
+				return;
+			case Message::Type::JoinRoom:
+				notifyJoinedRoomProperties(message);
+				m_listener.notifyJoinRoom(message.playerID, message.errorCode, ErrorString(message.errorCode));
+				return;
+			case Message::Type::JoinRandomRoom:
+				notifyJoinedRoomProperties(message);
+				m_listener.notifyJoinRandomRoom(message.playerID, message.errorCode, ErrorString(message.errorCode));
+				return;
+			case Message::Type::LeaveRoom:
+				m_listener.notifyLeaveRoom(message.errorCode, U"");
+				return;
+			case Message::Type::PlayerJoined:
+				m_listener.notifyPlayerJoined(message.playerID, message.playerIDs, message.isSelf);
+				return;
+			case Message::Type::PlayerLeft:
+				m_listener.notifyPlayerLeft(message.playerID, false);
+				return;
+			case Message::Type::Event:
+				m_listener.notifyPackedEvent(message.playerID, message.eventCode, message.bytes.data(), message.bytes.size());
+				return;
+			case Message::Type::RoomProperties:
+				m_listener.notifyRoomProperties(message.properties);
+				return;
+			case Message::Type::PlayerProperties:
+				m_listener.notifyPlayerProperties(message.playerID, message.properties);
+				return;
+			case Message::Type::RoomList:
+				m_listener.notifyRoomList(message.rooms);
+				return;
+			}
+		}
+
+		void notifyJoinedRoomProperties(const Message& message)
+		{
+			if (message.errorCode == 0)
+			{
+				m_listener.notifyJoinedRoomProperties(message.properties, message.playerProperties);
+			}
+		}
+
+		[[nodiscard]]
+		static String ErrorString(const int32 errorCode)
+		{
+			switch (errorCode)
+			{
+			case 0:
+				return{};
+			case 32766:
+				return U"A game with the specified id already exists.";
+			case 32765:
+				return U"Game is full.";
+			case 32764:
+				return U"Game is closed.";
+			case 32760:
+				return U"No match found.";
+			case 32758:
+				return U"Game does not exist.";
+			default:
+				return U"Unknown error.";
+			}
+		}
+	};
+}
+
+namespace s3d
+{
+	SivPhoton::SivPhoton(const StringView secretPhotonAppID, const StringView photonAppVersion)
+		: m_listener{ std::make_unique<SivPhotonDetail>(*this) }
+		, m_client{ std::make_unique<ExitGames::LoadBalancing::Client>(*m_listener, detail::ToJString(secretPhotonAppID), detail::ToJString(photonAppVersion)) }
+		, m_isUsePhoton{ false }
+	{
+
+		PhotonPoint::registerType();
+		PhotonVec2::registerType();
+		PhotonRect::registerType();
+		PhotonCircle::registerType();
+
+		m_transport = std::make_unique<PhotonTransport>(*m_client);
+	}
+
+	SivPhoton::SivPhoton(const std::shared_ptr<NetworkSystem::LoopbackNetwork>& network)
+		: SivPhoton{ U"", U"" }
+	{
+		assert(network);
+
+		m_transport = std::make_unique<LoopbackTransport>(static_cast<SivPhotonDetail&>(*m_listener), network);
+	}
+
+	SivPhoton::~SivPhoton()
+	{
+		SIVPHOTON_LOG(Debug, U"SivPhoton::~SivPhoton()");
+
+		// 破棄中のため、受信したコールバックは呼ばない
+		static_cast<SivPhotonDetail&>(*m_listener).stopNetworkThread();
+
+		PhotonPoint::unregisterType();
+		PhotonVec2::unregisterType();
+		PhotonRect::unregisterType();
+		PhotonCircle::unregisterType();
+
+		disconnect();
+	}
+
+	void SivPhoton::connect(const StringView userName, const Optional<String>& defaultRoomName)
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::connect() [サーバに接続する]");
+
+		m_defaultRoomName = defaultRoomName.value_or(String{ userName });
+
+		if (not m_transport->connect(userName))
+		{
+			SIVPHOTON_LOG(Error, U"ExitGmae::LoadBalancing::Client::connect() failed.");
+			return;
+		}
+
+		m_isUsePhoton = true;
+	}
+
+	void SivPhoton::disconnect()
+	{
+		const auto lock = lockClient();
+
+		m_transport->disconnect();
+	}
+
+	void SivPhoton::update()
+	{
+		flushNetworkVars();
+		flushEventBatches();
+
+		auto& listener = static_cast<SivPhotonDetail&>(*m_listener);
+
+		// 保留していたものを、新しく受信したものより先に処理する
+		listener.dispatchIncomingMessages();
+
+		if (listener.getNetworkThread())
+		{
+			return;
+		}
+
+		listener.measureService([this] { m_transport->service(); });
+	}
+
+	void SivPhoton::setNetworkThread(const bool enabled, const Duration& interval)
+	{
+		static_cast<SivPhotonDetail&>(*m_listener).setNetworkThread(enabled, interval);
+	}
+
+	bool SivPhoton::getNetworkThread() const noexcept
+	{
+		return static_cast<const SivPhotonDetail&>(*m_listener).getNetworkThread();
+	}
+
+	void SivPhoton::setHoldCallbacks(const bool hold)
+	{
+		static_cast<SivPhotonDetail&>(*m_listener).setHoldCallbacks(hold);
+	}
+
+	bool SivPhoton::getHoldCallbacks() const noexcept
+	{
+		return static_cast<const SivPhotonDetail&>(*m_listener).getHoldCallbacks();
+	}
+
+	void SivPhoton::dispatchIncomingCommands()
+	{
+		auto& listener = static_cast<SivPhotonDetail&>(*m_listener);
+
+		listener.dispatchIncomingMessages();
+
+		if (listener.getNetworkThread())
+		{
+			return;
+		}
+
+		listener.measureService([this] { m_transport->dispatchIncomingCommands(); });
+	}
+
+	void SivPhoton::sendOutgoingCommands()
+	{
+		flushNetworkVars();
+		flushEventBatches();
+
+		auto& listener = static_cast<SivPhotonDetail&>(*m_listener);
+
+		if (listener.getNetworkThread())
+		{
+			return;
+		}
+
+		listener.measureService([this] { m_transport->sendOutgoingCommands(); });
+	}
+
+	void SivPhoton::setTickRate(const NetworkSystem::TickRate& rate) noexcept
+	{
+		m_tickRate = rate;
+	}
+
+	const NetworkSystem::TickRate& SivPhoton::getTickRate() const noexcept
+	{
+		return m_tickRate;
+	}
+
+	NetworkSystem::NetworkStats SivPhoton::getNetworkStats() const
+	{
+		NetworkSystem::NetworkStats stats;
+
+		{
+			const auto lock = lockClient();
+
+			m_transport->getStats(stats);
+		}
+
+		stats.sentEvents = m_sentEventTraffic;
+
+		static_cast<const SivPhotonDetail&>(*m_listener).getNetworkStats(stats);
+
+		return stats;
+	}
+
+	void SivPhoton::resetNetworkStats()
+	{
+		{
+			const auto lock = lockClient();
+
+			m_transport->resetStats();
+		}
+
+		m_sentEventTraffic.fill({});
+
+		static_cast<SivPhotonDetail&>(*m_listener).resetNetworkStats();
+	}
+
+	void SivPhoton::opJoinRandomRoom(const int32 maxPlayers)
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::opJoinRandomRoom(maxPlayers = {}) [既存のランダムなルームに参加する]"_fmt(maxPlayers));
+
+		assert(InRange(maxPlayers, 0, 255));
+
+		m_transport->joinRandomRoom(NetworkSystem::MatchmakingOptions{ .maxPlayers = Clamp(maxPlayers, 1, 255) });
+	}
+
+	void SivPhoton::opJoinRandomRoom(const NetworkSystem::MatchmakingOptions& options)
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::opJoinRandomRoom(options) [条件に合うルームに参加する]");
+
+		assert(InRange(options.maxPlayers, 0, 255));
+
+		m_transport->joinRandomRoom(options);
+	}
+
+	void SivPhoton::opJoinRandomOrCreateRoom(const NetworkSystem::MatchmakingOptions& options, const StringView roomName, const NetworkSystem::RoomCreateOptions& createOptions)
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::opJoinRandomOrCreateRoom() [条件に合うルームに参加し、なければ作成する]");
+
+		assert(InRange(options.maxPlayers, 0, 255));
+		assert(InRange(createOptions.maxPlayers, 0, 255));
+
+		m_transport->joinRandomOrCreateRoom(options, roomName, createOptions);
+	}
+
+	void SivPhoton::opJoinRoom(const StringView roomName, const bool rejoin)
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::opJoinRoom() [既存の指定したルームに参加する]");
+
+		m_transport->joinRoom(roomName, rejoin);
+	}
+
+	void SivPhoton::opCreateRoom(const StringView roomName, const int32 maxPlayers)
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::opCreateRoom() [ルームを新規に作成する]");
+
+		assert(InRange(maxPlayers, 0, 255));
+
+		m_transport->createRoom(roomName, NetworkSystem::RoomCreateOptions{ .maxPlayers = Clamp(maxPlayers, 1, 255) });
+	}
+
+	void SivPhoton::opCreateRoom(const StringView roomName, const NetworkSystem::RoomCreateOptions& options)
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::opCreateRoom(options) [ルームを新規に作成する]");
+
+		assert(InRange(options.maxPlayers, 0, 255));
+
+		m_transport->createRoom(roomName, options);
+	}
+
+	void SivPhoton::opLeaveRoom()
+	{
+		const auto lock = lockClient();
+
+		SIVPHOTON_LOG(Info, U"SivPhoton::opLeaveRoom() [ルームを退室する]");
+
+		m_transport->leaveRoom();
+	}
+
+	void SivPhoton::opChangeGroups(const Array<uint8>& groupsToRemove, const Array<uint8>& groupsToAdd)
+	{
+		std::bitset<256> remove, add;
+
+		for (const auto group : groupsToRemove)
+		{
+			remove.set(group);
+		}
+
+		for (const auto group : groupsToAdd)
+		{
+			add.set(group);
+		}
+
+		changeGroups(remove, add);
+	}
+
+	void SivPhoton::setInterestGroups(const Array<uint8>& groups)
+	{
+		std::bitset<256> target;
+
+		for (const auto group : groups)
+		{
+			target.set(group);
+		}
+
+		changeGroups((m_interestGroups & ~target), (target & ~m_interestGroups));
+	}
+
+	void SivPhoton::clearInterestGroups()
+	{
+		const auto lock = lockClient();
+
+		if (m_interestGroups.none())
+		{
+			return;
+		}
+
+		m_transport->clearGroups();
+
+		m_interestGroups.reset();
+	}
+
+	Array<uint8> SivPhoton::getInterestGroups() const
+	{
+		Array<uint8> groups;
+		groups.reserve(m_interestGroups.count());
+
+		for (size_t group = 1; group < m_interestGroups.size(); ++group)
+		{
+			if (m_interestGroups[group])
+			{
+				groups << static_cast<uint8>(group);
+			}
+		}
+
+		return groups;
+	}
+
+	void SivPhoton::changeGroups(std::bitset<256> groupsToRemove, std::bitset<256> groupsToAdd)
+	{
+		const auto lock = lockClient();
+
+		// グループ 0 は全員を表すため購読できない
+		groupsToRemove.reset(0);
+		groupsToAdd.reset(0);
+
+		if (groupsToRemove.none() && groupsToAdd.none())
+		{
+			return;
+		}
+
+		m_transport->changeGroups(groupsToRemove, groupsToAdd);
+
+		m_interestGroups &= ~groupsToRemove;
+		m_interestGroups |= groupsToAdd;
+	}
+}
+
+namespace s3d
+{
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Rect& value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, PhotonRect{ value }, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Vec2& value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (const auto& profile = m_quantizationProfiles[eventCode]; profile.format != NetworkSystem::QuantizationFormat::None)
+		{
+			detail::WriteQuantized(m_sendBuffer, detail::WireContainer::Value, Size{ 1, 1 }, &value, 1, profile);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, PhotonVec2{ value }, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Point& value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, PhotonPoint{ value }, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Circle& value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (const auto& profile = m_quantizationProfiles[eventCode]; profile.format != NetworkSystem::QuantizationFormat::None)
+		{
+			detail::WriteQuantized(m_sendBuffer, detail::WireContainer::Value, Size{ 1, 1 }, &value, 1, profile);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, PhotonCircle{ value }, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Point>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonPoint> data;
+		for (const auto& v : values)
+		{
+			data << PhotonPoint{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Vec2>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (const auto& profile = m_quantizationProfiles[eventCode]; profile.format != NetworkSystem::QuantizationFormat::None)
+		{
+			detail::WriteQuantized(m_sendBuffer, detail::WireContainer::Array, Size{ static_cast<int32>(values.size()), 1 }, values.data(), values.size(), profile);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonVec2> data;
+		for (const auto& v : values)
+		{
+			data << PhotonVec2{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Rect>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonRect> data;
+		for (const auto& v : values)
+		{
+			data << PhotonRect{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Circle>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (const auto& profile = m_quantizationProfiles[eventCode]; profile.format != NetworkSystem::QuantizationFormat::None)
+		{
+			detail::WriteQuantized(m_sendBuffer, detail::WireContainer::Array, Size{ static_cast<int32>(values.size()), 1 }, values.data(), values.size(), profile);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonCircle> data;
+		for (const auto& v : values)
+		{
+			data << PhotonCircle{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Point>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonPoint> data;
+		for (const auto& v : values)
+		{
+			data << PhotonPoint{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Vec2>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (const auto& profile = m_quantizationProfiles[eventCode]; profile.format != NetworkSystem::QuantizationFormat::None)
+		{
+			detail::WriteQuantized(m_sendBuffer, detail::WireContainer::Grid, values.size(), values.data(), values.num_elements(), profile);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonVec2> data;
+		for (const auto& v : values)
+		{
+			data << PhotonVec2{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Rect>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonRect> data;
+		for (const auto& v : values)
+		{
+			data << PhotonRect{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Circle>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (const auto& profile = m_quantizationProfiles[eventCode]; profile.format != NetworkSystem::QuantizationFormat::None)
+		{
+			detail::WriteQuantized(m_sendBuffer, detail::WireContainer::Grid, values.size(), values.data(), values.num_elements(), profile);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<PhotonCircle> data;
+		for (const auto& v : values)
+		{
+			data << PhotonCircle{ v };
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(const uint8 eventCode, const int32 value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, value, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(const uint8 eventCode, const double value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, value, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(const uint8 eventCode, const float value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, value, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(const uint8 eventCode, const bool value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedValueEncoding())
+		{
+			detail::WriteValue(m_sendBuffer, value);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, value, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(const uint8 eventCode, const StringView value, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			writeStrings(detail::WireContainer::Value, Size{ 1, 1 }, &value, 1, options);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, detail::ToJString(value), eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<int32>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", values.data(), values.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<double>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", values.data(), values.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<float>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", values.data(), values.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<bool>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			detail::WriteArray(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", values.data(), values.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<String>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			writeStrings(detail::WireContainer::Array, Size{ static_cast<int32>(values.size()), 1 }, values.data(), values.size(), options);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<ExitGames::Common::JString> data;
+		for (const auto& v : values)
+		{
+			data << detail::ToJString(v);
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Array");
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<int32>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<int32> data = values.asArray();
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<double>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<double> data = values.asArray();
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<float>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<float> data = values.asArray();
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<bool>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (m_gridReplications[eventCode].enabled)
+		{
+			raiseGridReplication(eventCode, values, options);
+			return;
+		}
+
+		if (isPackedEncoding())
+		{
+			detail::WriteGrid(m_sendBuffer, values);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<bool> data = values.asArray();
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<String>& values, const NetworkSystem::SendOptions& options)
+	{
+		SIVPHOTON_LOG(Trace, U"opRaiseEvent()");
+
+		if (isPackedEncoding())
+		{
+			writeStrings(detail::WireContainer::Grid, values.size(), values.data(), values.num_elements(), options);
+			raisePackedEvent(eventCode, options);
+			return;
+		}
+
+		Array<ExitGames::Common::JString> data;
+		for (const auto& v : values)
+		{
+			data << detail::ToJString(v);
+		}
+
+		ExitGames::Common::Hashtable ev;
+		ev.put(L"ArrayType", L"Grid");
+		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
+		ev.put(L"values", data.data(), data.size());
+
+		recordSentEvent(eventCode, 0);
+		m_client->opRaiseEvent(options.reliable, ev, eventCode, detail::ToRaiseEventOptions(options));
+	}
+
+	void SivPhoton::setArrayEncoding(const NetworkSystem::ArrayEncoding encoding) noexcept
+	{
+		m_arrayEncoding = encoding;
 	}
 
-	void SivPhoton::connect(const StringView userName, const Optional<String>& defaultRoomName)
+	NetworkSystem::ArrayEncoding SivPhoton::getArrayEncoding() const noexcept
 	{
-		Print << U"SivPhoton::connect() [サーバに接続する]";
+		return m_arrayEncoding;
+	}
 
-		m_defaultRoomName = defaultRoomName.value_or(String{ userName });
+	void SivPhoton::setQuantizationProfile(const uint8 eventCode, const NetworkSystem::QuantizationProfile& profile) noexcept
+	{
+		m_quantizationProfiles[eventCode] = profile;
+	}
 
-		const auto userNameJ = detail::ToJString(userName);
-		const auto userID = ExitGames::LoadBalancing::AuthenticationValues{}
-		.setUserID(userNameJ + GETTIMEMS());
+	const NetworkSystem::QuantizationProfile& SivPhoton::getQuantizationProfile(const uint8 eventCode) const noexcept
+	{
+		return m_quantizationProfiles[eventCode];
+	}
 
-		if (not m_client->connect({ userID, userNameJ }))
+	void SivPhoton::setEventBatching(const bool enabled)
+	{
+		if (not enabled)
 		{
-			Print << U"ExitGmae::LoadBalancing::Client::connect() failed.";
-			return;
+			flushEventBatches();
 		}
 
-		m_client->fetchServerTimestamp();
-		m_isUsePhoton = true;
+		m_eventBatching = enabled;
 	}
 
-	void SivPhoton::disconnect()
+	bool SivPhoton::getEventBatching() const noexcept
 	{
-		m_client->disconnect();
+		return m_eventBatching;
 	}
 
-	void SivPhoton::update()
+	void SivPhoton::setReceiveQueue(const bool enabled, const size_t capacity, const size_t byteCapacity)
 	{
-		m_client->service();
+		static_cast<SivPhotonDetail&>(*m_listener).setReceiveQueue(enabled, capacity, byteCapacity);
 	}
 
-	void SivPhoton::opJoinRandomRoom(const int32 maxPlayers)
+	bool SivPhoton::getReceiveQueue() const noexcept
 	{
-		Print << U"SivPhoton::opJoinRandomRoom(maxPlayers = {}) [既存のランダムなルームに参加する]"_fmt(maxPlayers);
-
-		assert(InRange(maxPlayers, 0, 255));
-
-		m_client->opJoinRandomRoom({}, static_cast<uint8>(Clamp(maxPlayers, 1, 255)));
+		return static_cast<const SivPhotonDetail&>(*m_listener).getReceiveQueue();
 	}
 
-	void SivPhoton::opJoinRoom(const StringView roomName, const bool rejoin)
+	size_t SivPhoton::dispatchReceivedEvents(const NetworkSystem::ReceiveBudget& budget)
 	{
-		Print << U"SivPhoton::opJoinRoom() [既存の指定したルームに参加する]";
-
-		const auto roomNameJ = detail::ToJString(roomName);
-
-		m_client->opJoinRoom(roomNameJ, rejoin);
+		return static_cast<SivPhotonDetail&>(*m_listener).dispatchReceivedEvents(budget);
 	}
 
-	void SivPhoton::opCreateRoom(const StringView roomName, const int32 maxPlayers)
+	NetworkSystem::ReceiveQueueStats SivPhoton::getReceiveQueueStats() const
 	{
-		Print << U"SivPhoton::opCreateRoom() [ルームを新規に作成する]";
-
-		assert(InRange(maxPlayers, 0, 255));
-
-		const auto roomNameJ = detail::ToJString(roomName);
-		const auto roomOption = ExitGames::LoadBalancing::RoomOptions()
-			.setMaxPlayers(static_cast<uint8>(Clamp(maxPlayers, 1, 255)));
-
-		m_client->opCreateRoom(roomNameJ, roomOption);
+		return static_cast<const SivPhotonDetail&>(*m_listener).getReceiveQueueStats();
 	}
 
-	void SivPhoton::opLeaveRoom()
+	void SivPhoton::removeEventHandler(const uint8 eventCode) noexcept
 	{
-		Print << U"SivPhoton::opLeaveRoom() [ルームを退室する]";
-
-		constexpr bool willComeBack = false;
-
-		m_client->opLeaveRoom(willComeBack);
+		m_eventHandlers.erase(eventCode);
 	}
-}
 
-namespace s3d
-{
-	template<class T>
-	void s3d::SivPhoton::opRaiseEvent(uint8 eventCode, const T& value)
+	void SivPhoton::removeEventHandlers(const void* object) noexcept
 	{
-		this->opRaiseEvent<T>(eventCode, value);
+		m_eventHandlers.eraseObject(object);
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Rect& value)
+	void SivPhoton::setGridReplication(const uint8 eventCode, const bool enabled)
 	{
-		Print << U"opRaiseEvent()";
+		auto& replication = m_gridReplications[eventCode];
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, PhotonRect{ value }, eventCode);
+		replication.enabled = enabled;
+		replication.element = 0;
+		replication.cells.clear();
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Vec2& value)
+	bool SivPhoton::getGridReplication(const uint8 eventCode) const noexcept
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, PhotonVec2{ value }, eventCode);
+		return m_gridReplications[eventCode].enabled;
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Point& value)
+	String SivPhoton::getName() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, PhotonPoint{ value }, eventCode);
+		return m_transport->getName();
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Circle& value)
+	String SivPhoton::getUserID() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, PhotonCircle{ value }, eventCode);
+		return m_transport->getUserID();
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Point>& values)
+	Array<String> SivPhoton::getRoomNameList() const
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
+		Array<String> names;
+		names.reserve(m_roomList.size());
 
-		Array<PhotonPoint> data;
-		for (const auto& v : values)
+		for (const auto& room : m_roomList)
 		{
-			data << PhotonPoint{ v };
+			names << room.name;
 		}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", data.data(), data.size());
-
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return names;
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Vec2>& values)
+	const Array<NetworkSystem::RoomInfo>& SivPhoton::getRoomList() const noexcept
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
-
-		Array<PhotonVec2> data;
-		for (const auto& v : values)
-		{
-			data << PhotonVec2{ v };
-		}
-
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", data.data(), data.size());
-
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return m_roomList;
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Rect>& values)
+	uint64 SivPhoton::getRoomListVersion() const noexcept
 	{
-		Print << U"opRaiseEvent()";
+		return m_roomListVersion;
+	}
 
-		constexpr bool reliable = true;
+	void SivPhoton::setRoomPropertiesListedInLobby(const Array<String>& keys)
+	{
+		const auto lock = lockClient();
 
-		Array<PhotonRect> data;
-		for (const auto& v : values)
+		if (not m_transport->isInRoom())
 		{
-			data << PhotonRect{ v };
+			SIVPHOTON_LOG(Warning, U"SivPhoton::setRoomPropertiesListedInLobby() ルームに参加していません");
+			return;
 		}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", data.data(), data.size());
-
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		m_transport->setPropertiesListedInLobby(keys);
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<Circle>& values)
+	bool SivPhoton::isInRoom() const
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
-
-		Array<PhotonCircle> data;
-		for (const auto& v : values)
-		{
-			data << PhotonCircle{ v };
-		}
-
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", data.data(), data.size());
+		const auto lock = lockClient();
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return m_transport->isInRoom();
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Point>& values)
+	String SivPhoton::getCurrentRoomName() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-
-		Array<PhotonPoint> data;
-		for (const auto& v : values)
+		if (not m_transport->isInRoom())
 		{
-			data << PhotonPoint{ v };
+			return{};
 		}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
-
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return m_transport->getRoomName();
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Vec2>& values)
+	int32 SivPhoton::getPlayerCountInCurrentRoom() const
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
+		const auto lock = lockClient();
 
-		Array<PhotonVec2> data;
-		for (const auto& v : values)
+		if (not m_transport->isInRoom())
 		{
-			data << PhotonVec2{ v };
+			return 0;
 		}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
-
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return m_transport->getPlayerCount();
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Rect>& values)
+	int32 SivPhoton::getMaxPlayersInCurrentRoom() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-
-		Array<PhotonRect> data;
-		for (const auto& v : values)
+		if (not m_transport->isInRoom())
 		{
-			data << PhotonRect{ v };
+			return 0;
 		}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
-
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return m_transport->getMaxPlayers();
 	}
 
-	template<>
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<Circle>& values)
+	bool SivPhoton::getIsOpenInCurrentRoom() const
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
+		const auto lock = lockClient();
 
-		Array<PhotonCircle> data;
-		for (const auto& v : values)
-		{
-			data << PhotonCircle{ v };
-		}
+		return m_transport->getIsOpen();
+	}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
+	bool SivPhoton::getIsVisibleInCurrentRoom() const
+	{
+		const auto lock = lockClient();
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return m_transport->getIsVisible();
 	}
 
-	void SivPhoton::opRaiseEvent(const uint8 eventCode, const int32 value)
+	void SivPhoton::setIsOpenInCurrentRoom(const bool isOpen)
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, value, eventCode);
+		m_transport->setIsOpen(isOpen);
 	}
 
-	void SivPhoton::opRaiseEvent(const uint8 eventCode, const double value)
+	void SivPhoton::setIsVisibleInCurrentRoom(const bool isVisible)
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, value, eventCode);
+		m_transport->setIsVisible(isVisible);
 	}
 
-	void SivPhoton::opRaiseEvent(const uint8 eventCode, const float value)
+	int32 SivPhoton::getCountGamesRunning() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, value, eventCode);
+		return m_transport->getCountGamesRunning();
 	}
 
-	void SivPhoton::opRaiseEvent(const uint8 eventCode, const bool value)
+	int32 SivPhoton::getCountPlayersIngame() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, value, eventCode);
+		return m_transport->getCountPlayersIngame();
 	}
 
-	void SivPhoton::opRaiseEvent(const uint8 eventCode, const StringView value)
+	int32 SivPhoton::getCountPlayersOnline() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
-		m_client->opRaiseEvent(reliable, detail::ToJString(value), eventCode);
+		return m_transport->getCountPlayersOnline();
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<int32>& values)
+	Optional<int32> SivPhoton::localPlayerID() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
+		const int32 localPlayerID = m_transport->getLocalPlayerNumber();
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", values.data(), values.size());
+		if (localPlayerID < 0)
+		{
+			return none;
+		}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return localPlayerID;
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<double>& values)
+	bool SivPhoton::isMasterClient() const
 	{
-		Print << U"opRaiseEvent()";
+		const auto lock = lockClient();
 
-		constexpr bool reliable = true;
+		return m_transport->isMasterClient();
+	}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", values.data(), values.size());
+	int32 SivPhoton::getNumber() const
+	{
+		const auto lock = lockClient();
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return m_transport->getLocalPlayerNumber();
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<float>& values)
+	int32 SivPhoton::getServerTime() const
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
+		const auto lock = lockClient();
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", values.data(), values.size());
+		return m_transport->getServerTime();
+	}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+	void SivPhoton::registerNetworkVar(NetworkSystem::NetworkVarBase& var)
+	{
+		m_networkVars.add(var);
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<bool>& values)
+	void SivPhoton::unregisterNetworkVar(NetworkSystem::NetworkVarBase& var)
 	{
-		Print << U"opRaiseEvent()";
+		m_networkVars.remove(var);
+	}
 
-		constexpr bool reliable = true;
+	Array<String> SivPhoton::getRoomPropertyKeys() const
+	{
+		Array<String> keys;
+		keys.reserve(m_roomProperties.size());
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", values.data(), values.size());
+		for (const auto& [key, value] : m_roomProperties)
+		{
+			keys << key;
+		}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		return keys;
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Array<String>& values)
+	Array<String> SivPhoton::getPlayerPropertyKeys(const int32 playerID) const
 	{
-		Print << U"opRaiseEvent()";
+		Array<String> keys;
 
-		constexpr bool reliable = true;
-
-		Array<ExitGames::Common::JString> data;
-		for (const auto& v : values)
+		if (const auto it = m_playerProperties.find(playerID); it != m_playerProperties.end())
 		{
-			data << detail::ToJString(v);
+			for (const auto& [key, value] : it->second)
+			{
+				keys << key;
+			}
 		}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Array");
-		ev.put(L"values", data.data(), data.size());
+		return keys;
+	}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+	bool SivPhoton::isUsePhoton() const noexcept
+	{
+		return m_isUsePhoton;
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<int32>& values)
+	void SivPhoton::connectionErrorReturn(const int32 errorCode)
 	{
-		Print << U"opRaiseEvent()";
+		SIVPHOTON_LOG(Error, U"SivPhoton::connectionErrorReturn() [サーバへの接続が失敗したときに呼ばれる]");
+		SIVPHOTON_LOG(Error, U"errorCode: ", errorCode);
+	}
 
-		constexpr bool reliable = true;
+	void SivPhoton::connectReturn(const int32 errorCode, const String& errorString, const String& region, const String& cluster)
+	{
+		SIVPHOTON_LOG(Info, U"SivPhoton::connectReturn()");
+		SIVPHOTON_LOG(Info, U"error: ", errorString);
+		SIVPHOTON_LOG(Info, U"region: ", region);
+		SIVPHOTON_LOG(Info, U"cluster: ", cluster);
+	}
 
-		Array<int32> data = values.asArray();
+	void SivPhoton::disconnectReturn()
+	{
+		SIVPHOTON_LOG(Info, U"SivPhoton::disconnectReturn() [サーバから切断されたときに呼ばれる]");
+	}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
+	void SivPhoton::leaveRoomReturn(const int32 errorCode, const String& errorString)
+	{
+		SIVPHOTON_LOG(Info, U"SivPhoton::leaveRoomReturn() [ルームから退室した結果を処理する]");
+		SIVPHOTON_LOG(Info, U"- errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"- errorString:", errorString);
+	}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+	void SivPhoton::joinRandomRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
+	{
+		SIVPHOTON_LOG(Info, U"SivPhoton::joinRandomRoomReturn()");
+		SIVPHOTON_LOG(Info, U"localPlayerID:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"errorString:", errorString);
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<double>& values)
+	void SivPhoton::joinRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString)
 	{
-		Print << U"opRaiseEvent()";
+		SIVPHOTON_LOG(Info, U"SivPhoton::joinRoomReturn()");
+		SIVPHOTON_LOG(Info, U"localPlayerID:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"errorString:", errorString);
+	}
 
-		constexpr bool reliable = true;
+	void SivPhoton::joinRoomEventAction(const int32 localPlayerID, const Array<int32>& playerIDs, const bool isSelf)
+	{
+		SIVPHOTON_LOG(Info, U"SivPhoton::joinRoomEventAction() [自分を含め、プレイヤーが参加したら呼ばれる]");
+		SIVPHOTON_LOG(Info, U"localPlayerID [参加した人の ID]:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"playerIDs: [ルームの参加者一覧]", playerIDs);
+		SIVPHOTON_LOG(Info, U"isSelf [自分自身の参加？]:", isSelf);
+	}
 
-		Array<double> data = values.asArray();
+	void SivPhoton::leaveRoomEventAction(const int32 playerID, const bool isInactive)
+	{
+		const auto lock = lockClient();
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
+		SIVPHOTON_LOG(Info, U"SivPhoton::leaveRoomEventAction()");
+		SIVPHOTON_LOG(Info, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Info, U"isInactive: ", isInactive);
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+		if (m_transport->isMasterClient())
+		{
+			SIVPHOTON_LOG(Info, U"I am now the master client");
+		}
+		else
+		{
+			SIVPHOTON_LOG(Info, U"I am still not the master client");
+		}
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<float>& values)
+	void SivPhoton::createRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
 	{
-		Print << U"opRaiseEvent()";
-
-		constexpr bool reliable = true;
-
-		Array<float> data = values.asArray();
+		SIVPHOTON_LOG(Info, U"SivPhoton::createRoomReturn() [ルームを新規作成した結果を処理する]");
+		SIVPHOTON_LOG(Info, U"- localPlayerID:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"- errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"- errorString:", errorString);
+	}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
+	void SivPhoton::roomPropertiesChanged(const Array<String>& keys)
+	{
+		SIVPHOTON_LOG(Info, U"SivPhoton::roomPropertiesChanged() [ルームのカスタムプロパティが変更されたら呼ばれる]");
+		SIVPHOTON_LOG(Info, U"- keys:", keys);
+	}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+	void SivPhoton::playerPropertiesChanged(const int32 playerID, const Array<String>& keys)
+	{
+		SIVPHOTON_LOG(Info, U"SivPhoton::playerPropertiesChanged() [プレイヤーのカスタムプロパティが変更されたら呼ばれる]");
+		SIVPHOTON_LOG(Info, U"- playerID:", playerID);
+		SIVPHOTON_LOG(Info, U"- keys:", keys);
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<bool>& values)
+	void SivPhoton::roomListUpdated()
 	{
-		Print << U"opRaiseEvent()";
+		SIVPHOTON_LOG(Trace, U"SivPhoton::roomListUpdated() [ロビーのルームの一覧が更新されたら呼ばれる]");
+		SIVPHOTON_LOG(Trace, U"- rooms:", m_roomList.size());
+	}
 
-		constexpr bool reliable = true;
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const int32 eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(int32)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		Array<bool> data = values.asArray();
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const double eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(double)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const float eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(float)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const bool eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(bool)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	void SivPhoton::opRaiseEvent(uint8 eventCode, const Grid<String>& values)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const String& eventContent)
 	{
-		Print << U"opRaiseEvent()";
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(String)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		constexpr bool reliable = true;
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<int32>& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<int32>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		Array<ExitGames::Common::JString> data;
-		for (const auto& v : values)
-		{
-			data << detail::ToJString(v);
-		}
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<double>& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<double>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		ExitGames::Common::Hashtable ev;
-		ev.put(L"ArrayType", L"Grid");
-		ev.put(L"xy", PhotonPoint{ Point{values.width(), values.height()} });
-		ev.put(L"values", data.data(), data.size());
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<float>& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<float>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		m_client->opRaiseEvent(reliable, ev, eventCode);
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<bool>& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<bool>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	String SivPhoton::getName() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<String>& eventContent)
 	{
-		return detail::ToString(m_client->getLocalPlayer().getName());
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<String>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	String SivPhoton::getUserID() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<int32>& eventContent)
 	{
-		return detail::ToString(m_client->getLocalPlayer().getUserID());
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<int32>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	Array<String> SivPhoton::getRoomNameList() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<double>& eventContent)
 	{
-		const auto roomNameList = m_client->getRoomNameList();
-		Array<String> result;
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<double>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		for (uint32 i = 0; i < roomNameList.getSize(); ++i)
-		{
-			result << detail::ToString(roomNameList[i]);
-		}
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<float>& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<float>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		return result;
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<bool>& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<bool>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	bool SivPhoton::isInRoom() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<String>& eventContent)
 	{
-		return m_client->getIsInGameRoom();
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<String>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	String SivPhoton::getCurrentRoomName() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Point& eventContent)
 	{
-		if (not m_client->getIsInGameRoom())
-		{
-			return{};
-		}
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Point)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		return detail::ToString(m_client->getCurrentlyJoinedRoom().getName());
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Vec2& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Vec2)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	int32 SivPhoton::getPlayerCountInCurrentRoom() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Rect& eventContent)
 	{
-		if (not m_client->getIsInGameRoom())
-		{
-			return 0;
-		}
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Rect)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		return m_client->getCurrentlyJoinedRoom().getPlayerCount();
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Circle& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Circle)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	int32 SivPhoton::getMaxPlayersInCurrentRoom() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Point>& eventContent)
 	{
-		if (not m_client->getIsInGameRoom())
-		{
-			return 0;
-		}
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<Point>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
 
-		return m_client->getCurrentlyJoinedRoom().getMaxPlayers();
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Vec2>& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<Vec2>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	bool SivPhoton::getIsOpenInCurrentRoom() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Rect>& eventContent)
 	{
-		return m_client->getCurrentlyJoinedRoom().getIsOpen();
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<Rect>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	bool SivPhoton::getIsVisibleInCurrentRoom() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Circle>& eventContent)
 	{
-		return m_client->getCurrentlyJoinedRoom().getIsVisible();
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<Circle>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	void SivPhoton::setIsOpenInCurrentRoom(const bool isOpen)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Point>& eventContent)
 	{
-		m_client->getCurrentlyJoinedRoom().setIsOpen(isOpen);
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<Point>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	void SivPhoton::setIsVisibleInCurrentRoom(const bool isVisible)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Vec2>& eventContent)
 	{
-		m_client->getCurrentlyJoinedRoom().setIsVisible(isVisible);
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<Vec2>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	int32 SivPhoton::getCountGamesRunning() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Rect>& eventContent)
 	{
-		return m_client->getCountGamesRunning();
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Grid<Rect>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	int32 SivPhoton::getCountPlayersIngame() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Circle>& eventContent)
 	{
-		return m_client->getCountPlayersIngame();
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(Array<Circle>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
-	int32 SivPhoton::getCountPlayersOnline() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const int32> eventContent)
 	{
-		return m_client->getCountPlayersOnline();
+		customEventAction(playerID, eventCode, Array<int32>(eventContent.begin(), eventContent.end()));
 	}
 
-	Optional<int32> SivPhoton::localPlayerID() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const double> eventContent)
 	{
-		const int32 localPlayerID = m_client->getLocalPlayer().getNumber();
+		customEventAction(playerID, eventCode, Array<double>(eventContent.begin(), eventContent.end()));
+	}
 
-		if (localPlayerID < 0)
-		{
-			return none;
-		}
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const float> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<float>(eventContent.begin(), eventContent.end()));
+	}
 
-		return localPlayerID;
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const bool> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<bool>(eventContent.begin(), eventContent.end()));
 	}
 
-	bool SivPhoton::isMasterClient() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Point> eventContent)
 	{
-		return m_client->getLocalPlayer().getIsMasterClient();
+		customEventAction(playerID, eventCode, Array<Point>(eventContent.begin(), eventContent.end()));
 	}
 
-	int32 SivPhoton::getNumber() const
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Vec2> eventContent)
 	{
-		return m_client->getLocalPlayer().getNumber();
+		customEventAction(playerID, eventCode, Array<Vec2>(eventContent.begin(), eventContent.end()));
 	}
 
-	bool SivPhoton::isUsePhoton() const noexcept
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Rect> eventContent)
 	{
-		return m_isUsePhoton;
+		customEventAction(playerID, eventCode, Array<Rect>(eventContent.begin(), eventContent.end()));
 	}
 
-	void SivPhoton::connectionErrorReturn(const int32 errorCode)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Circle> eventContent)
 	{
-		Print << U"SivPhoton::connectionErrorReturn() [サーバへの接続が失敗したときに呼ばれる]";
-		Print << U"errorCode: " << errorCode;
+		customEventAction(playerID, eventCode, Array<Circle>(eventContent.begin(), eventContent.end()));
 	}
 
-	void SivPhoton::connectReturn(const int32 errorCode, const String& errorString, const String& region, const String& cluster)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<int32>& eventContent)
 	{
-		Print << U"SivPhoton::connectReturn()";
-		Print << U"error: " << errorString;
-		Print << U"region: " << region;
-		Print << U"cluster: " << cluster;
+		customEventAction(playerID, eventCode, eventContent.toGrid());
 	}
 
-	void SivPhoton::disconnectReturn()
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<double>& eventContent)
 	{
-		Print << U"SivPhoton::disconnectReturn() [サーバから切断されたときに呼ばれる]";
+		customEventAction(playerID, eventCode, eventContent.toGrid());
 	}
 
-	void SivPhoton::leaveRoomReturn(const int32 errorCode, const String& errorString)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<float>& eventContent)
 	{
-		Print << U"SivPhoton::leaveRoomReturn() [ルームから退室した結果を処理する]";
-		Print << U"- errorCode:" << errorCode;
-		Print << U"- errorString:" << errorString;
+		customEventAction(playerID, eventCode, eventContent.toGrid());
 	}
 
-	void SivPhoton::joinRandomRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<bool>& eventContent)
 	{
-		Print << U"SivPhoton::joinRandomRoomReturn()";
-		Print << U"localPlayerID:" << localPlayerID;
-		Print << U"errorCode:" << errorCode;
-		Print << U"errorString:" << errorString;
+		customEventAction(playerID, eventCode, eventContent.toGrid());
 	}
 
-	void SivPhoton::joinRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<Point>& eventContent)
 	{
-		Print << U"SivPhoton::joinRoomReturn()";
-		Print << U"localPlayerID:" << localPlayerID;
-		Print << U"errorCode:" << errorCode;
-		Print << U"errorString:" << errorString;
+		customEventAction(playerID, eventCode, eventContent.toGrid());
 	}
 
-	void SivPhoton::joinRoomEventAction(const int32 localPlayerID, const Array<int32>& playerIDs, const bool isSelf)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<Vec2>& eventContent)
 	{
-		Print << U"SivPhoton::joinRoomEventAction() [自分を含め、プレイヤーが参加したら呼ばれる]";
-		Print << U"localPlayerID [参加した人の ID]:" << localPlayerID;
-		Print << U"playerIDs: [ルームの参加者一覧]" << playerIDs;
-		Print << U"isSelf [自分自身の参加？]:" << isSelf;
+		customEventAction(playerID, eventCode, eventContent.toGrid());
 	}
 
-	void SivPhoton::leaveRoomEventAction(const int32 playerID, const bool isInactive)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<Rect>& eventContent)
 	{
-		Print << U"SivPhoton::leaveRoomEventAction()";
-		Print << U"playerID: " << playerID;
-		Print << U"isInactive: " << isInactive;
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
 
-		if (m_client->getLocalPlayer().getIsMasterClient())
-		{
-			Print << U"I am now the master client";
-		}
-		else
-		{
-			Print << U"I am still not the master client";
-		}
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<Circle>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
 	}
 
-	void SivPhoton::createRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const StringView> eventContent)
 	{
-		Print << U"SivPhoton::createRoomReturn() [ルームを新規作成した結果を処理する]";
-		Print << U"- localPlayerID:" << localPlayerID;
-		Print << U"- errorCode:" << errorCode;
-		Print << U"- errorString:" << errorString;
+		customEventAction(playerID, eventCode, Array<String>(eventContent.begin(), eventContent.end()));
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const int32 eventContent)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::GridView<StringView>& eventContent)
 	{
-		Print << U"SivPhoton::customEventAction(int32)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		customEventAction(playerID, eventCode, Grid<String>{ eventContent.size(), Array<String>(eventContent.begin(), eventContent.end()) });
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const double eventContent)
+	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const NetworkSystem::SerializedValue& eventContent)
 	{
-		Print << U"SivPhoton::customEventAction(double)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"SivPhoton::customEventAction(SerializedValue)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"typeID: ", eventContent.typeID());
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const float eventContent)
+	bool SivPhoton::isPackedEncoding() const noexcept
 	{
-		Print << U"SivPhoton::customEventAction(float)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		return ((m_arrayEncoding == NetworkSystem::ArrayEncoding::Packed) || isPackedValueEncoding());
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const bool eventContent)
+	bool SivPhoton::isPackedValueEncoding() const noexcept
 	{
-		Print << U"SivPhoton::customEventAction(bool)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		// ネットワークスレッドへはバイト列でしか受け渡さない。ループバックはバイト列のみを扱う
+		return (m_eventBatching || getNetworkThread() || (not m_transport->supportsObjectEvents()));
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const String& eventContent)
+	void SivPhoton::recordSentEvent(const uint8 eventCode, const size_t size) noexcept
 	{
-		Print << U"SivPhoton::customEventAction(String)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		auto& traffic = m_sentEventTraffic[eventCode];
+		++traffic.count;
+		traffic.bytes += size;
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<int32>& eventContent)
+	void SivPhoton::sendPackedEvent(const uint8 eventCode, const Array<uint8>& bytes, const NetworkSystem::SendOptions& options)
 	{
-		Print << U"SivPhoton::customEventAction(Array<int32>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		auto& listener = static_cast<SivPhotonDetail&>(*m_listener);
+
+		if (listener.getNetworkThread())
+		{
+			listener.pushOutgoingEvent(eventCode, bytes, options);
+			return;
+		}
+
+		m_transport->raiseEvent(bytes.data(), bytes.size(), eventCode, options);
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<double>& eventContent)
+	std::unique_lock<std::recursive_mutex> SivPhoton::lockClient() const
 	{
-		Print << U"SivPhoton::customEventAction(Array<double>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		return static_cast<SivPhotonDetail&>(*m_listener).lockClient();
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<float>& eventContent)
+	void SivPhoton::raisePackedEvent(const uint8 eventCode, const NetworkSystem::SendOptions& options)
 	{
-		Print << U"SivPhoton::customEventAction(Array<float>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		recordSentEvent(eventCode, m_sendBuffer.size());
+
+		if (m_eventBatching)
+		{
+			auto& batch = m_eventBatches[options.reliable];
+
+			// 送信先が異なるイベントは同じ操作にまとめられない
+			if ((not batch.bytes.isEmpty())
+				&& (not batch.options.hasSameRoute(options)))
+			{
+				flushEventBatches();
+			}
+
+			if (batch.bytes.isEmpty())
+			{
+				batch.options = options;
+			}
+
+			detail::AppendBatchEntry(batch.bytes, eventCode, m_sendBuffer);
+
+			m_sendBuffer.clear();
+
+			if (detail::WireBatchFlushSize < batch.bytes.size())
+			{
+				flushEventBatches();
+			}
+
+			return;
+		}
+
+		sendPackedEvent(eventCode, m_sendBuffer, options);
+
+		m_sendBuffer.clear();
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<bool>& eventContent)
+	void SivPhoton::flushEventBatches()
 	{
-		Print << U"SivPhoton::customEventAction(Array<bool>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		for (auto& batch : m_eventBatches)
+		{
+			if (batch.bytes.isEmpty())
+			{
+				continue;
+			}
+
+			sendPackedEvent(detail::WireBatchEventCode, batch.bytes, batch.options);
+
+			batch.bytes.clear();
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<String>& eventContent)
+	template <class StringType>
+	void SivPhoton::writeStrings(const detail::WireContainer container, const Size size, const StringType* values, const size_t count, const NetworkSystem::SendOptions& options)
 	{
-		Print << U"SivPhoton::customEventAction(Array<String>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		// 文字列表の登録を受け取れないプレイヤーがいる可能性がある送信方法では使わない
+		const bool interning = (options.reliable
+			&& (options.eventCache == NetworkSystem::EventCache::DoNotCache)
+			&& (options.interestGroup == 0)
+			&& options.targetPlayers.isEmpty()
+			&& (options.receiverGroup != NetworkSystem::ReceiverGroup::MasterClient));
+
+		detail::WriteStringHeader(m_sendBuffer, container, size);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const StringView value{ values[i] };
+			const size_t length = detail::UTF8Length(value);
+
+			if ((not interning)
+				|| (detail::WireMaxInternedStringLength < length))
+			{
+				detail::WriteStringLiteral(m_sendBuffer, value, length);
+				continue;
+			}
+
+			const uint64 hash = std::hash<std::u32string_view>{}(std::u32string_view{ value.data(), value.size() });
+
+			if (const auto it = m_internedStringIDs.find(hash); it != m_internedStringIDs.end())
+			{
+				auto& interned = m_internedStrings[it->second];
+
+				if (interned.value != value)
+				{
+					// ハッシュ値の衝突
+					detail::WriteStringLiteral(m_sendBuffer, value, length);
+				}
+				else if (interned.channel == options.channel)
+				{
+					detail::WriteStringReference(m_sendBuffer, it->second);
+				}
+				else
+				{
+					// 順序はチャンネルごとにしか保たれないため、別のチャンネルでは登録し直す
+					interned.channel = options.channel;
+					detail::WriteStringDefinition(m_sendBuffer, it->second, value, length);
+				}
+			}
+			else if (m_internedStrings.size() < detail::WireMaxInternedStrings)
+			{
+				const uint32 id = static_cast<uint32>(m_internedStrings.size());
+				m_internedStrings.push_back(InternedString{ String{ value }, options.channel });
+				m_internedStringIDs.emplace(hash, id);
+				detail::WriteStringDefinition(m_sendBuffer, id, value, length);
+			}
+			else
+			{
+				detail::WriteStringLiteral(m_sendBuffer, value, length);
+			}
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<int32>& eventContent)
+	void SivPhoton::raiseStringTable(const int32 playerID)
 	{
-		Print << U"SivPhoton::customEventAction(Grid<int32>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		for (size_t begin = 0; begin < m_internedStrings.size();)
+		{
+			size_t end = begin;
+			size_t totalLength = 0;
+
+			while ((end < m_internedStrings.size())
+				&& (totalLength < detail::WireStringTableChunkSize))
+			{
+				totalLength += detail::UTF8Length(m_internedStrings[end++].value);
+			}
+
+			detail::WriteStringHeader(m_sendBuffer, detail::WireContainer::StringTable, Size{ static_cast<int32>(end - begin), 1 });
+
+			for (size_t id = begin; id < end; ++id)
+			{
+				const String& value = m_internedStrings[id].value;
+				detail::WriteStringDefinition(m_sendBuffer, static_cast<uint32>(id), value, detail::UTF8Length(value));
+			}
+
+			raisePackedEvent(detail::WireStringTableEventCode, NetworkSystem::SendOptions::ToPlayers({ playerID }));
+
+			begin = end;
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<double>& eventContent)
+	void SivPhoton::resetStringTable()
 	{
-		Print << U"SivPhoton::customEventAction(Grid<double>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		// まとめて送信する途中のイベントが、空にした表の ID を参照しないようにする
+		flushEventBatches();
+
+		m_internedStrings.clear();
+		m_internedStringIDs.clear();
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<float>& eventContent)
+	template <class Type>
+	void SivPhoton::raiseGridReplication(const uint8 eventCode, const Grid<Type>& values, const NetworkSystem::SendOptions& options)
 	{
-		Print << U"SivPhoton::customEventAction(Grid<float>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		constexpr auto element = detail::WireElementOf_v<Type>;
+
+		auto& replication = m_gridReplications[eventCode];
+		const uint8* cells = reinterpret_cast<const uint8*>(values.data());
+		const size_t byteCount = (values.num_elements() * sizeof(Type));
+
+		const bool hasBaseline = ((replication.element == static_cast<uint8>(element))
+			&& (replication.size == values.size())
+			&& (replication.cells.size() == byteCount));
+
+		++replication.sequence;
+
+		if ((not hasBaseline)
+			|| (not detail::WriteGridDelta(m_sendBuffer, element, replication.sequence, values.size(), replication.cells.data(), cells)))
+		{
+			detail::WriteGridKeyframe(m_sendBuffer, element, replication.sequence, values.size(), cells);
+		}
+
+		replication.element = static_cast<uint8>(element);
+		replication.size = values.size();
+		replication.cells.assign(cells, (cells + byteCount));
+		replication.channel = options.channel;
+		replication.reliable = options.reliable;
+
+		raisePackedEvent(eventCode, options);
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<bool>& eventContent)
+	void SivPhoton::raiseGridKeyframe(const uint8 eventCode, const int32 playerID)
 	{
-		Print << U"SivPhoton::customEventAction(Grid<bool>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		const auto& replication = m_gridReplications[eventCode];
+
+		if ((not replication.enabled)
+			|| (replication.element == 0))
+		{
+			return;
+		}
+
+		detail::WriteGridKeyframe(m_sendBuffer, static_cast<detail::WireElement>(replication.element), replication.sequence, replication.size, replication.cells.data());
+
+		// 差分と同じチャンネルで送り、差分より後に届いたキーフレームで巻き戻らないようにする
+		NetworkSystem::SendOptions options = NetworkSystem::SendOptions::ToPlayers({ playerID });
+		options.channel = replication.channel;
+		options.reliable = replication.reliable;
+
+		raisePackedEvent(eventCode, options);
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<String>& eventContent)
+	void SivPhoton::raiseGridKeyframes(const int32 playerID)
 	{
-		Print << U"SivPhoton::customEventAction(Grid<String>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		for (size_t eventCode = 0; eventCode < m_gridReplications.size(); ++eventCode)
+		{
+			raiseGridKeyframe(static_cast<uint8>(eventCode), playerID);
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Point& eventContent)
+	void SivPhoton::raiseKeyframeRequest(const uint8 eventCode, const int32 playerID)
 	{
-		Print << U"SivPhoton::customEventAction(Point)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		detail::WriteKeyframeRequest(m_sendBuffer, playerID);
+
+		// 同じイベントコードを自分も差分で送信している場合は、その送信の設定に合わせる
+		const auto& replication = m_gridReplications[eventCode];
+		NetworkSystem::SendOptions options = NetworkSystem::SendOptions::ToPlayers({ playerID });
+		options.channel = replication.channel;
+		options.reliable = replication.reliable;
+
+		raisePackedEvent(eventCode, options);
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Vec2& eventContent)
+	void SivPhoton::resetGridReplications()
 	{
-		Print << U"SivPhoton::customEventAction(Vec2)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		for (auto& replication : m_gridReplications)
+		{
+			replication.element = 0;
+			replication.cells.clear();
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Rect& eventContent)
+	void SivPhoton::flushNetworkVars()
 	{
-		Print << U"SivPhoton::customEventAction(Rect)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		if (not m_networkVars.hasDirty())
+		{
+			return;
+		}
+
+		m_networkVars.writeDirty(m_sendBuffer);
+
+		raisePackedEvent(detail::WireNetworkVarsEventCode, {});
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Circle& eventContent)
+	void SivPhoton::raiseNetworkVarSnapshot(const int32 playerID)
 	{
-		Print << U"SivPhoton::customEventAction(Circle)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		if (not isMasterClient())
+		{
+			return;
+		}
+
+		if (m_networkVars.writeAll(m_sendBuffer))
+		{
+			raisePackedEvent(detail::WireNetworkVarsEventCode, NetworkSystem::SendOptions::ToPlayers({ playerID }));
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Point>& eventContent)
+	void SivPhoton::receivedNetworkVars(detail::WireNetworkVars vars)
 	{
-		Print << U"SivPhoton::customEventAction(Array<Point>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		uint32 id = 0;
+		const uint8* value = nullptr;
+		size_t valueSize = 0;
+
+		for (size_t i = 0; i < vars.count; ++i)
+		{
+			if (not detail::ReadNetworkVar(vars, id, value, valueSize))
+			{
+				return;
+			}
+
+			// 登録されていない ID や、型が一致しない値は無視する
+			if (NetworkSystem::NetworkVarBase* var = m_networkVars.find(id))
+			{
+				static_cast<void>(var->readValue(value, (value + valueSize)));
+			}
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Vec2>& eventContent)
+	void SivPhoton::setRoomPropertyBytes(const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue)
 	{
-		Print << U"SivPhoton::customEventAction(Array<Vec2>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		{
+			const auto lock = lockClient();
+
+			if (not m_transport->isInRoom())
+			{
+				SIVPHOTON_LOG(Warning, U"SivPhoton::setRoomProperty() ルームに参加していません");
+				return;
+			}
+
+			m_transport->setRoomProperty(key, value, expectedValue);
+		}
+
+		// 比較付きの変更はサーバが成否を判定するため、通知を待ってから反映する
+		if (not expectedValue)
+		{
+			m_roomProperties[String{ key }] = value;
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Rect>& eventContent)
+	void SivPhoton::setPlayerPropertyBytes(const StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue)
 	{
-		Print << U"SivPhoton::customEventAction(Array<Rect>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		int32 localPlayerID = -1;
+
+		{
+			const auto lock = lockClient();
+
+			// ルームの外で設定した値は、次に参加したルームで共有される
+			m_transport->setPlayerProperty(key, value, expectedValue);
+
+			if (m_transport->isInRoom())
+			{
+				localPlayerID = m_transport->getLocalPlayerNumber();
+			}
+		}
+
+		if ((not expectedValue) && (0 <= localPlayerID))
+		{
+			m_playerProperties[localPlayerID][String{ key }] = value;
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Array<Circle>& eventContent)
+	void SivPhoton::joinedRoomProperties(const detail::PropertyTable& roomProperties, const HashTable<int32, detail::PropertyTable>& playerProperties)
 	{
-		Print << U"SivPhoton::customEventAction(Array<Circle>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		m_roomProperties = roomProperties;
+		m_playerProperties = playerProperties;
+
+		if (not m_roomProperties.empty())
+		{
+			roomPropertiesChanged(getRoomPropertyKeys());
+		}
+
+		for (const auto& [playerID, properties] : m_playerProperties)
+		{
+			playerPropertiesChanged(playerID, getPlayerPropertyKeys(playerID));
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Point>& eventContent)
+	void SivPhoton::updateRoomProperties(const detail::PropertyTable& changes)
 	{
-		Print << U"SivPhoton::customEventAction(Grid<Point>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		Array<String> keys;
+		keys.reserve(changes.size());
+
+		for (const auto& [key, value] : changes)
+		{
+			m_roomProperties[key] = value;
+			keys << key;
+		}
+
+		if (not keys.isEmpty())
+		{
+			roomPropertiesChanged(keys);
+		}
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Vec2>& eventContent)
+	void SivPhoton::updatePlayerProperties(const int32 playerID, const detail::PropertyTable& changes)
 	{
-		Print << U"SivPhoton::customEventAction(Grid<Vec2>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		if (changes.empty())
+		{
+			return;
+		}
+
+		Array<String> keys;
+		keys.reserve(changes.size());
+		detail::PropertyTable& properties = m_playerProperties[playerID];
+
+		for (const auto& [key, value] : changes)
+		{
+			properties[key] = value;
+			keys << key;
+		}
+
+		playerPropertiesChanged(playerID, keys);
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Rect>& eventContent)
+	void SivPhoton::clearProperties()
 	{
-		Print << U"SivPhoton::customEventAction(Grid<Rect>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		m_roomProperties.clear();
+		m_playerProperties.clear();
 	}
 
-	void SivPhoton::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Circle>& eventContent)
+	void SivPhoton::updateRoomList(const Array<NetworkSystem::RoomInfo>& rooms)
 	{
-		Print << U"SivPhoton::customEventAction(Array<Circle>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		m_roomList = rooms;
+		++m_roomListVersion;
+
+		roomListUpdated();
 	}
 
 	ExitGames::LoadBalancing::Client& SivPhoton::getClient()
@@ -1,6 +1,13 @@
 ﻿
 # pragma once
+# include <span>
+# include <array>
+# include <bitset>
+# include <mutex>
+# include <variant>
 # include <Siv3D.hpp>
+# include "SivPhotonLog.hpp"
+# include "detail/SivPhotonSerializer.hpp"
 
 // Photono SDK クラスの前方宣言
 namespace ExitGames
@@ -26,6 +33,2539 @@ namespace s3d
 		}
 
 		inline constexpr int32 NoRandomMatchFound = (0x7FFF - 7);
+
+		/// @brief Array, Grid のイベントを送信するときのデータ形式
+		enum class ArrayEncoding : uint8
+		{
+			/// @brief 型タグ、可変長整数のサイズ、要素の並びをひとつのバイト列に詰めた形式
+			Packed,
+
+			/// @brief 文字列キーの Hashtable を使う旧形式
+			/// @remark 旧バージョンの SivPhoton と通信する場合に使います。
+			Hashtable,
+		};
+
+		/// @brief Vec2, Circle の座標を量子化する形式
+		enum class QuantizationFormat : uint8
+		{
+			/// @brief 量子化しない (double)
+			None	= 0,
+
+			/// @brief 32 bit 浮動小数点数
+			Float32	= 1,
+
+			/// @brief 16 bit 浮動小数点数
+			Float16	= 2,
+
+			/// @brief 範囲を 16 bit で等分した固定小数点数
+			Fixed16	= 3,
+
+			/// @brief 範囲を 24 bit で等分した固定小数点数
+			Fixed24	= 4,
+		};
+
+		/// @brief イベントコードごとの Vec2, Circle の量子化の設定
+		/// @remark 送信側と受信側で同じ設定をする必要があります。
+		struct QuantizationProfile
+		{
+			QuantizationFormat format = QuantizationFormat::None;
+
+			/// @brief 固定小数点数で表す座標の範囲
+			/// @remark 範囲外の座標は範囲内に丸められます。
+			RectF area{ 0, 0, 0, 0 };
+
+			/// @brief 固定小数点数で表す Circle の半径の最大値
+			double maxRadius = 0.0;
+
+			[[nodiscard]]
+			static QuantizationProfile Float32() noexcept
+			{
+				return{ QuantizationFormat::Float32 };
+			}
+
+			[[nodiscard]]
+			static QuantizationProfile Float16() noexcept
+			{
+				return{ QuantizationFormat::Float16 };
+			}
+
+			/// @brief 範囲を 16 bit で等分した固定小数点数で量子化します。
+			/// @param area 座標の範囲
+			/// @param maxRadius Circle の半径の最大値
+			/// @remark 精度は area の幅・高さの 1/65535 です。
+			[[nodiscard]]
+			static QuantizationProfile Fixed16(const RectF& area, const double maxRadius = 0.0) noexcept
+			{
+				return{ QuantizationFormat::Fixed16, area, maxRadius };
+			}
+
+			/// @brief 範囲を 24 bit で等分した固定小数点数で量子化します。
+			/// @param area 座標の範囲
+			/// @param maxRadius Circle の半径の最大値
+			/// @remark 精度は area の幅・高さの 1/16777215 です。(幅 262144 の範囲で 1/64 ピクセル)
+			[[nodiscard]]
+			static QuantizationProfile Fixed24(const RectF& area, const double maxRadius = 0.0) noexcept
+			{
+				return{ QuantizationFormat::Fixed24, area, maxRadius };
+			}
+		};
+
+		/// @brief イベントを受信するプレイヤーのグループ
+		enum class ReceiverGroup : uint8
+		{
+			/// @brief 自分以外のプレイヤー
+			Others			= 0,
+
+			/// @brief 自分を含むすべてのプレイヤー
+			All				= 1,
+
+			/// @brief マスタークライアントのみ
+			MasterClient	= 2,
+		};
+
+		/// @brief ルームのイベントキャッシュの扱い
+		/// @remark キャッシュされたイベントは、後からルームに参加したプレイヤーにも送信されます。
+		enum class EventCache : uint8
+		{
+			/// @brief キャッシュしない
+			DoNotCache				= 0,
+
+			/// @brief 送信者の同じイベントコードのキャッシュとマージする
+			MergeCache				= 1,
+
+			/// @brief 送信者の同じイベントコードのキャッシュを置き換える
+			ReplaceCache			= 2,
+
+			/// @brief 送信者の同じイベントコードのキャッシュを削除する
+			RemoveCache				= 3,
+
+			/// @brief ルームのキャッシュに追加する (送信者が退室すると削除される)
+			AddToRoomCache			= 4,
+
+			/// @brief ルームのキャッシュに追加する (送信者が退室しても残る)
+			AddToRoomCacheGlobal	= 5,
+
+			/// @brief ルームのキャッシュから削除する
+			RemoveFromRoomCache		= 6,
+
+			/// @brief 退室したプレイヤーのイベントをルームのキャッシュから削除する
+			RemoveFromRoomCacheForActorsLeft = 7,
+		};
+
+		/// @brief イベントの送信方法
+		struct SendOptions
+		{
+			/// @brief 信頼性のある送信をするか
+			/// @remark false の場合、失われたイベントは再送されません。古いイベントより後に届いたイベントは破棄されます。
+			bool reliable = true;
+
+			/// @brief 送信チャンネル
+			/// @remark 順序はチャンネルごとに保たれます。チャンネルを分けると、再送待ちのイベントが他のチャンネルのイベントを遅らせません。
+			uint8 channel = 0;
+
+			/// @brief イベントを受信するプレイヤーのグループ
+			ReceiverGroup receiverGroup = ReceiverGroup::Others;
+
+			/// @brief イベントを受信するプレイヤーの ID
+			/// @remark 空でない場合、receiverGroup は無視されます。
+			Array<int32> targetPlayers;
+
+			/// @brief ルームのイベントキャッシュの扱い
+			EventCache eventCache = EventCache::DoNotCache;
+
+			/// @brief イベントを受信するインタレストグループ
+			/// @remark 0 の場合はグループを指定しません。1 以上の場合、そのグループを購読しているプレイヤーのみが受信します。
+			uint8 interestGroup = 0;
+
+			/// @brief 信頼性のない送信
+			/// @param channel 送信チャンネル
+			[[nodiscard]]
+			static SendOptions Unreliable(const uint8 channel = 0)
+			{
+				return{ .reliable = false, .channel = channel };
+			}
+
+			/// @brief 自分を含むすべてのプレイヤーへの送信
+			[[nodiscard]]
+			static SendOptions ToAll()
+			{
+				return{ .receiverGroup = ReceiverGroup::All };
+			}
+
+			/// @brief マスタークライアントへの送信
+			[[nodiscard]]
+			static SendOptions ToMasterClient()
+			{
+				return{ .receiverGroup = ReceiverGroup::MasterClient };
+			}
+
+			/// @brief 指定したプレイヤーへの送信
+			/// @param playerIDs イベントを受信するプレイヤーの ID
+			[[nodiscard]]
+			static SendOptions ToPlayers(Array<int32> playerIDs)
+			{
+				return{ .targetPlayers = std::move(playerIDs) };
+			}
+
+			/// @brief 指定したインタレストグループを購読しているプレイヤーへの送信
+			/// @param group インタレストグループ (1 以上)
+			[[nodiscard]]
+			static SendOptions ToInterestGroup(const uint8 group)
+			{
+				return{ .interestGroup = group };
+			}
+
+			/// @brief 送信先とキャッシュの扱いが同じかを返します。
+			[[nodiscard]]
+			bool hasSameRoute(const SendOptions& other) const
+			{
+				return ((channel == other.channel)
+					&& (receiverGroup == other.receiverGroup)
+					&& (targetPlayers == other.targetPlayers)
+					&& (eventCache == other.eventCache)
+					&& (interestGroup == other.interestGroup));
+			}
+		};
+
+		/// @brief 位置を、空間を等分したセルごとのインタレストグループに対応付けます。
+		/// @remark 近くのセルのグループだけを購読することで、遠くのプレイヤーのイベントを受信しないようにできます。
+		class InterestGrid
+		{
+		public:
+
+			SIV3D_NODISCARD_CXX20
+			InterestGrid() = default;
+
+			/// @brief InterestGrid を作成します。
+			/// @param area 対象の範囲
+			/// @param cellSize セルの一辺の長さ
+			/// @param firstGroup 左上のセルに対応するインタレストグループ (1 以上)
+			/// @remark セルの数は 256 - firstGroup 以下である必要があります。範囲外の位置は最も近いセルに対応付けます。
+			SIV3D_NODISCARD_CXX20
+			InterestGrid(const RectF& area, const double cellSize, const uint8 firstGroup = 1)
+				: m_area{ area }
+				, m_cellSize{ cellSize }
+				, m_cells{ Max(1, static_cast<int32>(Math::Ceil(area.w / cellSize))), Max(1, static_cast<int32>(Math::Ceil(area.h / cellSize))) }
+				, m_firstGroup{ firstGroup }
+			{
+				assert(0.0 < cellSize);
+				assert(1 <= firstGroup);
+				assert((static_cast<int32>(firstGroup) + (m_cells.x * m_cells.y)) <= 256);
+			}
+
+			/// @brief 横と縦のセルの数を返します。
+			[[nodiscard]]
+			Size cells() const noexcept
+			{
+				return m_cells;
+			}
+
+			/// @brief 指定した位置を含むセルのインタレストグループを返します。
+			/// @param pos 位置
+			/// @return インタレストグループ
+			[[nodiscard]]
+			uint8 groupAt(const Vec2& pos) const noexcept
+			{
+				return toGroup(cellX(pos.x), cellY(pos.y));
+			}
+
+			/// @brief 指定した位置を含むセルのインタレストグループを返します。
+			/// @param pos 位置
+			/// @return インタレストグループ
+			[[nodiscard]]
+			uint8 groupAt(const Point& pos) const noexcept
+			{
+				return groupAt(Vec2{ pos });
+			}
+
+			/// @brief 指定した位置を中心とする正方形に重なるセルのインタレストグループの一覧を返します。
+			/// @param pos 位置
+			/// @param radius 中心から正方形の辺までの距離
+			/// @return インタレストグループの一覧
+			[[nodiscard]]
+			Array<uint8> groupsAround(const Vec2& pos, const double radius) const
+			{
+				const int32 x0 = cellX(pos.x - radius), x1 = cellX(pos.x + radius);
+				const int32 y0 = cellY(pos.y - radius), y1 = cellY(pos.y + radius);
+
+				Array<uint8> groups;
+				groups.reserve(static_cast<size_t>(x1 - x0 + 1) * (y1 - y0 + 1));
+
+				for (int32 y = y0; y <= y1; ++y)
+				{
+					for (int32 x = x0; x <= x1; ++x)
+					{
+						groups << toGroup(x, y);
+					}
+				}
+
+				return groups;
+			}
+
+			/// @brief 指定した位置を中心とする正方形に重なるセルのインタレストグループの一覧を返します。
+			/// @param pos 位置
+			/// @param radius 中心から正方形の辺までの距離
+			/// @return インタレストグループの一覧
+			[[nodiscard]]
+			Array<uint8> groupsAround(const Point& pos, const double radius) const
+			{
+				return groupsAround(Vec2{ pos }, radius);
+			}
+
+		private:
+
+			RectF m_area{ 0, 0, 0, 0 };
+
+			double m_cellSize = 1.0;
+
+			Size m_cells{ 1, 1 };
+
+			uint8 m_firstGroup = 1;
+
+			[[nodiscard]]
+			int32 cellX(const double x) const noexcept
+			{
+				return ToCell(((x - m_area.x) / m_cellSize), m_cells.x);
+			}
+
+			[[nodiscard]]
+			int32 cellY(const double y) const noexcept
+			{
+				return ToCell(((y - m_area.y) / m_cellSize), m_cells.y);
+			}
+
+			/// @brief セル単位の座標を、範囲内のセルの番号にします。
+			/// @remark 範囲外の値や NaN, 無限大を int32 に変換すると未定義動作になるため、double のまま範囲に収めてから変換します。NaN は先頭のセルに対応付けます。
+			[[nodiscard]]
+			static int32 ToCell(const double cell, const int32 cellCount) noexcept
+			{
+				if (not (0.0 <= cell))
+				{
+					return 0;
+				}
+
+				return static_cast<int32>(Math::Floor(Min(cell, static_cast<double>(cellCount - 1))));
+			}
+
+			[[nodiscard]]
+			uint8 toGroup(const int32 x, const int32 y) const noexcept
+			{
+				return static_cast<uint8>(m_firstGroup + (y * m_cells.x) + x);
+			}
+		};
+
+		template <class Type>
+		struct TimestampedValue;
+
+		/// @brief 他のプレイヤーから不定期に届く値をサーバ時刻とともに溜め、描画時に補間した値を返すジッタバッファ
+		/// @tparam Type 値の型 (Vec2, Circle, Rect, RectF など lerp() を持つ型)
+		/// @tparam Capacity プレイヤー ID とイベントコードの組ごとに溜めるサンプルの数
+		/// @remark 現在のサーバ時刻から遅延を引いた描画時刻の前後のサンプルを線形補間します。
+		/// 描画時刻が最も新しいサンプルを過ぎた場合は、直前の 2 つのサンプルから最大 maxExtrapolation まで外挿します。
+		/// @remark 送信側は opRaiseEvent(eventCode, TimestampedValue<Vec2>{ getServerTime(), pos }) のように送信時のサーバ時刻を付けて送り、
+		/// 受信側は customEventAction(int32, int32, const SerializedValue&) で get<TimestampedValue<Vec2>>() した値を push() に渡します。
+		template <class Type, size_t Capacity = 32>
+		class SnapshotBuffer
+		{
+		public:
+
+			static_assert(2 <= Capacity);
+
+			SIV3D_NODISCARD_CXX20
+			SnapshotBuffer() = default;
+
+			/// @brief SnapshotBuffer を作成します。
+			/// @param delay 描画時刻をサーバ時刻から遅らせる時間
+			/// @param maxExtrapolation 外挿する時間の上限
+			SIV3D_NODISCARD_CXX20
+			explicit SnapshotBuffer(const Duration& delay, const Duration& maxExtrapolation = Duration{ 0.25 })
+				: m_delay{ delay }
+				, m_maxExtrapolation{ maxExtrapolation } {}
+
+			void setDelay(const Duration& delay) noexcept
+			{
+				m_delay = delay;
+			}
+
+			[[nodiscard]]
+			const Duration& getDelay() const noexcept
+			{
+				return m_delay;
+			}
+
+			void setMaxExtrapolation(const Duration& maxExtrapolation) noexcept
+			{
+				m_maxExtrapolation = maxExtrapolation;
+			}
+
+			[[nodiscard]]
+			const Duration& getMaxExtrapolation() const noexcept
+			{
+				return m_maxExtrapolation;
+			}
+
+			/// @brief 受信した、送信時のサーバ時刻が付いた値を追加します。
+			/// @param playerID 送信したプレイヤーの ID
+			/// @param eventCode イベントコード
+			/// @param sample 送信側が TimestampedValue として送信した値
+			void push(const int32 playerID, const int32 eventCode, const TimestampedValue<Type>& sample)
+			{
+				push(playerID, eventCode, sample.serverTime, sample.value);
+			}
+
+			/// @brief 受信した値を追加します。
+			/// @param playerID 送信したプレイヤーの ID
+			/// @param eventCode イベントコード
+			/// @param serverTime 値を送信したときのサーバ時刻 (ミリ秒, 送信側の SivPhoton::getServerTime())
+			/// @param value 値
+			/// @remark 最も新しいサンプルより古い値は無視します。容量を超えた場合は最も古いサンプルを捨てます。
+			/// @remark 受信したときのサーバ時刻を渡すこともできますが、その場合は通信の遅延の揺らぎがそのまま時刻の揺らぎになり、補間では取り除けません。
+			void push(const int32 playerID, const int32 eventCode, const int32 serverTime, const Type& value)
+			{
+				Stream& stream = m_streams[Key(playerID, eventCode)];
+
+				if (stream.count)
+				{
+					Snapshot& newest = stream.at(stream.count - 1);
+					const int32 elapsed = Elapsed(newest.serverTime, serverTime);
+
+					if (elapsed < 0)
+					{
+						return;
+					}
+
+					// 同じ時刻のサンプルは、後から届いたもので置き換える
+					if (elapsed == 0)
+					{
+						newest.value = value;
+						return;
+					}
+				}
+
+				if (stream.count == Capacity)
+				{
+					stream.head = ((stream.head + 1) % Capacity);
+					--stream.count;
+				}
+
+				stream.at(stream.count++) = Snapshot{ serverTime, value };
+			}
+
+			/// @brief 描画時刻の値を返します。
+			/// @param playerID プレイヤーの ID
+			/// @param eventCode イベントコード
+			/// @param serverTime 現在のサーバ時刻 (ミリ秒, SivPhoton::getServerTime())
+			/// @return 補間または外挿した値, サンプルがない場合は none
+			[[nodiscard]]
+			Optional<Type> sample(const int32 playerID, const int32 eventCode, const int32 serverTime) const
+			{
+				const auto it = m_streams.find(Key(playerID, eventCode));
+
+				if ((it == m_streams.end()) || (it->second.count == 0))
+				{
+					return none;
+				}
+
+				const Stream& stream = it->second;
+				const int32 renderTime = static_cast<int32>(static_cast<uint32>(serverTime) - static_cast<uint32>(ToMillisec(m_delay)));
+
+				if ((stream.count == 1)
+					|| (Elapsed(stream.at(0).serverTime, renderTime) <= 0))
+				{
+					return stream.at(0).value;
+				}
+
+				// 描画時刻を挟む 2 つのサンプルを、新しい方から探す
+				for (size_t i = (stream.count - 1); 0 < i; --i)
+				{
+					const Snapshot& from = stream.at(i - 1);
+
+					if (Elapsed(from.serverTime, renderTime) < 0)
+					{
+						continue;
+					}
+
+					const Snapshot& to = stream.at(i);
+					const int32 interval = Elapsed(from.serverTime, to.serverTime);
+					int32 elapsed = Elapsed(from.serverTime, renderTime);
+
+					// 最も新しいサンプルより後は外挿する
+					if (interval < elapsed)
+					{
+						elapsed = (interval + Min(Elapsed(to.serverTime, renderTime), ToMillisec(m_maxExtrapolation)));
+					}
+
+					return Lerp(from.value, to.value, (static_cast<double>(elapsed) / interval));
+				}
+
+				return stream.at(0).value;
+			}
+
+			/// @brief 指定したプレイヤーのサンプルをすべて削除します。
+			/// @param playerID プレイヤーの ID
+			/// @remark プレイヤーが退室したときに呼びます。
+			void remove(const int32 playerID)
+			{
+				for (auto it = m_streams.begin(); it != m_streams.end();)
+				{
+					if (static_cast<int32>(it->first >> 32) == playerID)
+					{
+						it = m_streams.erase(it);
+					}
+					else
+					{
+						++it;
+					}
+				}
+			}
+
+			/// @brief すべてのサンプルを削除します。
+			void clear()
+			{
+				m_streams.clear();
+			}
+
+		private:
+
+			struct Snapshot
+			{
+				int32 serverTime = 0;
+
+				Type value{};
+			};
+
+			/// @brief プレイヤー ID とイベントコードの組ごとのサンプル (リングバッファ)
+			struct Stream
+			{
+				std::array<Snapshot, Capacity> snapshots{};
+
+				/// @brief 最も古いサンプルの位置
+				size_t head = 0;
+
+				size_t count = 0;
+
+				/// @brief i 番目に古いサンプルを返します。
+				[[nodiscard]]
+				Snapshot& at(const size_t i) noexcept
+				{
+					return snapshots[(head + i) % Capacity];
+				}
+
+				[[nodiscard]]
+				const Snapshot& at(const size_t i) const noexcept
+				{
+					return snapshots[(head + i) % Capacity];
+				}
+			};
+
+			HashTable<uint64, Stream> m_streams;
+
+			Duration m_delay{ 0.1 };
+
+			Duration m_maxExtrapolation{ 0.25 };
+
+			[[nodiscard]]
+			static uint64 Key(const int32 playerID, const int32 eventCode) noexcept
+			{
+				return ((static_cast<uint64>(static_cast<uint32>(playerID)) << 32) | static_cast<uint32>(eventCode));
+			}
+
+			/// @brief from から to までの経過時間 (ミリ秒) を返します。
+			/// @remark サーバ時刻は 32 ビットで一周するため、差で比較します。
+			[[nodiscard]]
+			static int32 Elapsed(const int32 from, const int32 to) noexcept
+			{
+				return static_cast<int32>(static_cast<uint32>(to) - static_cast<uint32>(from));
+			}
+
+			[[nodiscard]]
+			static int32 ToMillisec(const Duration& duration) noexcept
+			{
+				return static_cast<int32>(Max(duration.count(), 0.0) * 1000);
+			}
+
+			[[nodiscard]]
+			static Type Lerp(const Type& from, const Type& to, const double t)
+			{
+				if constexpr (std::is_same_v<Type, Rect>)
+				{
+					return from.lerp(to, t).asRect();
+				}
+				else
+				{
+					return from.lerp(to, t);
+				}
+			}
+		};
+
+		/// @brief 受信キューから 1 回に処理するイベントの量の上限
+		struct ReceiveBudget
+		{
+			/// @brief 処理するイベントの最大数 (0 の場合は制限なし)
+			size_t maxEvents = 0;
+
+			/// @brief 処理にかける時間の上限 (0 の場合は制限なし)
+			/// @remark 上限を超えても、1 回に少なくとも 1 つのイベントは処理します。
+			Duration maxTime{ 0.0 };
+		};
+
+		/// @brief 受信キューの統計
+		struct ReceiveQueueStats
+		{
+			/// @brief キューに残っているイベントの数
+			size_t backlog = 0;
+
+			/// @brief キューに残っているイベントのバイト数
+			size_t backlogBytes = 0;
+
+			/// @brief キューに残っているイベントの数の最大値
+			size_t peakBacklog = 0;
+
+			/// @brief 最も古いイベントを受信してからの時間 (ミリ秒)
+			double oldestAgeMillisec = 0.0;
+
+			/// @brief 最後の dispatchReceivedEvents() で処理したイベントの数
+			size_t lastDispatched = 0;
+
+			/// @brief キューに収まらず、受信時にその場で処理したイベントの数
+			size_t overflowed = 0;
+		};
+
+		/// @brief イベントコードごとの送受信量
+		struct EventTraffic
+		{
+			/// @brief イベントの数
+			uint64 count = 0;
+
+			/// @brief パック形式のイベントのバイト数の合計 (旧形式のイベントは含まない)
+			uint64 bytes = 0;
+		};
+
+		/// @brief 通信の統計
+		struct NetworkStats
+		{
+			/// @brief 往復時間 (ミリ秒)
+			int32 roundTripTime = 0;
+
+			/// @brief 往復時間のばらつき (ミリ秒)
+			int32 roundTripTimeVariance = 0;
+
+			/// @brief 受信したバイト数
+			int64 bytesIn = 0;
+
+			/// @brief 送信したバイト数
+			int64 bytesOut = 0;
+
+			/// @brief 受信したパケットの数
+			int64 packetsIn = 0;
+
+			/// @brief 送信したパケットの数
+			int64 packetsOut = 0;
+
+			/// @brief 再送した reliable なコマンドの数
+			int32 resentReliableCommands = 0;
+
+			/// @brief Photon が受信して、まだ処理していないコマンドの数
+			int32 queuedIncomingCommands = 0;
+
+			/// @brief Photon が送信を待っているコマンドの数
+			int32 queuedOutgoingCommands = 0;
+
+			/// @brief 受信キューに残っているイベントの数
+			size_t receiveQueueBacklog = 0;
+
+			/// @brief 最後に service() (またはその受信側・送信側) にかかった時間
+			/// @remark ネットワークスレッドを使わない場合は、service() の中で呼ばれたコールバックの時間を含みます。
+			Duration lastServiceTime{ 0.0 };
+
+			/// @brief service() にかかった時間の合計
+			Duration totalServiceTime{ 0.0 };
+
+			/// @brief イベントコードごとの送信量
+			std::array<EventTraffic, 256> sentEvents{};
+
+			/// @brief イベントコードごとの受信量
+			std::array<EventTraffic, 256> receivedEvents{};
+		};
+
+		/// @brief 通信の頻度
+		struct TickRate
+		{
+			/// @brief 受信したコマンドを処理する頻度 (Hz, 0 の場合は毎フレーム)
+			double dispatchIncoming = 0.0;
+
+			/// @brief 送信する頻度 (Hz, 0 の場合は毎フレーム)
+			double sendOutgoing = 0.0;
+		};
+
+		/// @brief 受信した Grid を参照する読み取り専用のビュー
+		/// @tparam Type 要素の型
+		/// @remark 参照先のデータは customEventAction の呼び出し中のみ有効です。
+		template <class Type>
+		class GridView
+		{
+		public:
+
+			using value_type = Type;
+
+			SIV3D_NODISCARD_CXX20
+			constexpr GridView() = default;
+
+			SIV3D_NODISCARD_CXX20
+			constexpr GridView(const Type* data, const Size size) noexcept
+				: m_data{ data }
+				, m_size{ size } {}
+
+			[[nodiscard]]
+			constexpr int32 width() const noexcept
+			{
+				return m_size.x;
+			}
+
+			[[nodiscard]]
+			constexpr int32 height() const noexcept
+			{
+				return m_size.y;
+			}
+
+			[[nodiscard]]
+			constexpr Size size() const noexcept
+			{
+				return m_size;
+			}
+
+			[[nodiscard]]
+			constexpr size_t num_elements() const noexcept
+			{
+				return (static_cast<size_t>(m_size.x) * m_size.y);
+			}
+
+			[[nodiscard]]
+			constexpr bool isEmpty() const noexcept
+			{
+				return (num_elements() == 0);
+			}
+
+			[[nodiscard]]
+			constexpr const Type* data() const noexcept
+			{
+				return m_data;
+			}
+
+			[[nodiscard]]
+			constexpr const Type& operator[](const Point& pos) const noexcept
+			{
+				return m_data[(static_cast<size_t>(pos.y) * m_size.x) + pos.x];
+			}
+
+			/// @brief 指定した行を返します。
+			/// @param y 行のインデックス
+			/// @return 指定した行の要素の並び
+			[[nodiscard]]
+			constexpr std::span<const Type> row(const int32 y) const noexcept
+			{
+				return{ (m_data + (static_cast<size_t>(y) * m_size.x)), static_cast<size_t>(m_size.x) };
+			}
+
+			[[nodiscard]]
+			constexpr std::span<const Type> asSpan() const noexcept
+			{
+				return{ m_data, num_elements() };
+			}
+
+			[[nodiscard]]
+			constexpr const Type* begin() const noexcept
+			{
+				return m_data;
+			}
+
+			[[nodiscard]]
+			constexpr const Type* end() const noexcept
+			{
+				return (m_data + num_elements());
+			}
+
+			/// @brief 参照しているデータをコピーした Grid を返します。
+			/// @return Grid
+			[[nodiscard]]
+			Grid<Type> toGrid() const
+			{
+				return Grid<Type>{ m_size, Array<Type>(begin(), end()) };
+			}
+
+		private:
+
+			const Type* m_data = nullptr;
+
+			Size m_size{ 0, 0 };
+		};
+
+		/// @brief パック形式で送受信できる型
+		/// @remark メンバ関数 template <class Archive> void serialize(Archive& archive) { archive(x, y, name); } でメンバを列挙した型、
+		/// 算術型、列挙型、Point, Vec2, Rect, RectF, Circle, ColorF (およびそれらの Array, Grid, Optional) です。String のメンバは UTF-8 で送信されます。
+		/// serialize() を持たないその他のクラス型は、ポインタや StringView, std::span のメンバやパディングのバイトを送らないよう受け付けません。
+		/// パディングもポインタも含まない型は s3d::detail::IsPackedTrivial を特殊化して許可できます。
+		template <class Type>
+		concept Serializable = s3d::detail::IsPackedSerializable<Type>::value;
+
+		/// @brief 名前から型 ID を計算します。
+		/// @tparam ...Arguments 型 ID に混ぜるテンプレート引数 (型 ID を持つ型はその型 ID を、それ以外の型はサイズを混ぜます)
+		/// @param name アプリケーションの中で一意な型の名前
+		/// @return 型 ID (名前の FNV-1a ハッシュ)
+		template <class... Arguments>
+		[[nodiscard]]
+		constexpr uint32 MakeTypeID(StringView name) noexcept;
+
+		/// @brief メンバを追加できない型 (列挙型など) に型 ID を与えるための特殊化の対象
+		/// @remark template <> struct CustomTypeTraits<Team> { static constexpr uint32 TypeID = MakeTypeID(U"Team"); }; のように特殊化します。
+		template <class Type>
+		struct CustomTypeTraits {};
+
+		/// @brief 型 ID を持つ型か
+		template <class Type>
+		concept HasCustomTypeID = (requires { typename std::integral_constant<uint32, Type::TypeID>; }
+			|| requires { typename std::integral_constant<uint32, CustomTypeTraits<Type>::TypeID>; });
+
+		/// @brief SivPhoton でイベントとして送受信できるユーザ定義型
+		/// @remark Serializable であり、すべてのクライアントで同じ値の型 ID を持つ型です。
+		/// 型 ID は static constexpr uint32 TypeID = MakeTypeID(U"PlayerState"); のようにメンバで宣言するか、CustomTypeTraits を特殊化して与えます。
+		/// 型 ID を持つ型の Array, Grid, Optional は要素の型 ID から型 ID が決まります。
+		template <class Type>
+		concept CustomType = (Serializable<Type> && HasCustomTypeID<Type>);
+
+		/// @brief ユーザ定義型の型 ID を返します。
+		/// @tparam Type ユーザ定義型
+		/// @return 型 ID
+		/// @remark 型 ID は送信するバイト列に含まれ、受信側で型を確認するために使われます。
+		template <CustomType Type>
+		[[nodiscard]]
+		constexpr uint32 CustomTypeID() noexcept
+		{
+			if constexpr (requires { typename std::integral_constant<uint32, Type::TypeID>; })
+			{
+				return static_cast<uint32>(Type::TypeID);
+			}
+			else
+			{
+				return static_cast<uint32>(CustomTypeTraits<Type>::TypeID);
+			}
+		}
+
+		template <class... Arguments>
+		constexpr uint32 MakeTypeID(const StringView name) noexcept
+		{
+			uint32 hash = 2166136261u;
+
+			const auto mix = [&](const uint32 value)
+			{
+				for (uint32 shift = 0; shift < 32; shift += 8)
+				{
+					hash ^= ((value >> shift) & 0xFF);
+					hash *= 16777619u;
+				}
+			};
+
+			for (const char32 ch : name)
+			{
+				mix(static_cast<uint32>(ch));
+			}
+
+			(mix([]() -> uint32
+				{
+					if constexpr (HasCustomTypeID<Arguments>)
+					{
+						return CustomTypeID<Arguments>();
+					}
+					else
+					{
+						return static_cast<uint32>(sizeof(Arguments));
+					}
+				}()), ...);
+
+			return hash;
+		}
+
+		template <class Type>
+			requires HasCustomTypeID<Type>
+		struct CustomTypeTraits<Array<Type>>
+		{
+			static constexpr uint32 TypeID = MakeTypeID<Type>(U"Array");
+		};
+
+		template <class Type>
+			requires HasCustomTypeID<Type>
+		struct CustomTypeTraits<Grid<Type>>
+		{
+			static constexpr uint32 TypeID = MakeTypeID<Type>(U"Grid");
+		};
+
+		template <class Type>
+			requires HasCustomTypeID<Type>
+		struct CustomTypeTraits<Optional<Type>>
+		{
+			static constexpr uint32 TypeID = MakeTypeID<Type>(U"Optional");
+		};
+
+		/// @brief 受信したユーザ定義型のイベント
+		/// @remark 参照先のデータは customEventAction の呼び出し中のみ有効です。
+		class SerializedValue
+		{
+		public:
+
+			SIV3D_NODISCARD_CXX20
+			SerializedValue(const uint32 typeID, const uint8* begin, const uint8* end) noexcept
+				: m_typeID{ typeID }
+				, m_begin{ begin }
+				, m_end{ end } {}
+
+			/// @brief 型 ID を返します。
+			[[nodiscard]]
+			uint32 typeID() const noexcept
+			{
+				return m_typeID;
+			}
+
+			/// @brief 指定した型のイベントであるかを返します。
+			/// @tparam Type ユーザ定義型
+			template <CustomType Type>
+			[[nodiscard]]
+			bool is() const noexcept
+			{
+				return (m_typeID == CustomTypeID<Type>());
+			}
+
+			/// @brief 指定した型として値を復元します。
+			/// @tparam Type ユーザ定義型
+			/// @return 復元した値, 型 ID が異なる場合やデータが不正な場合は none
+			template <CustomType Type>
+			[[nodiscard]]
+			Optional<Type> get() const
+			{
+				if (not is<Type>())
+				{
+					return none;
+				}
+
+				Type value{};
+				s3d::detail::PackedReader reader{ m_begin, m_end };
+				reader(value);
+
+				if ((not reader.isValid())
+					|| (not reader.isEnd()))
+				{
+					return none;
+				}
+
+				return value;
+			}
+
+			/// @brief 受信したバイト列を返します。
+			[[nodiscard]]
+			std::span<const uint8> bytes() const noexcept
+			{
+				return{ m_begin, m_end };
+			}
+
+		private:
+
+			uint32 m_typeID = 0;
+
+			const uint8* m_begin = nullptr;
+
+			const uint8* m_end = nullptr;
+		};
+	}
+
+	namespace detail
+	{
+		/// @brief customEventAction の組み込みの要素の型か
+		template <class Type>
+		inline constexpr bool IsEventElement = (std::is_same_v<Type, int32> || std::is_same_v<Type, double> || std::is_same_v<Type, float> || std::is_same_v<Type, bool>
+			|| std::is_same_v<Type, Point> || std::is_same_v<Type, Vec2> || std::is_same_v<Type, Rect> || std::is_same_v<Type, Circle>);
+
+		/// @brief イベントハンドラの引数の型から、受信時にイベントハンドラの表へ渡される型を求めます。
+		/// @remark String, Array, Grid はビューとして渡され、ハンドラの呼び出し時にコピーします。ユーザ定義型は SerializedValue として渡され、ハンドラの呼び出し時に復元します。
+		template <class Type>
+		struct EventContentOf
+		{
+			using type = std::conditional_t<(IsEventElement<Type> || std::is_same_v<Type, StringView>), Type, NetworkSystem::SerializedValue>;
+		};
+
+		template <>
+		struct EventContentOf<String>
+		{
+			using type = StringView;
+		};
+
+		template <class Type> requires (IsEventElement<Type> || std::is_same_v<Type, StringView>)
+		struct EventContentOf<std::span<const Type>>
+		{
+			using type = std::span<const Type>;
+		};
+
+		template <class Type> requires (IsEventElement<Type> || std::is_same_v<Type, StringView>)
+		struct EventContentOf<NetworkSystem::GridView<Type>>
+		{
+			using type = NetworkSystem::GridView<Type>;
+		};
+
+		template <class Type> requires IsEventElement<Type>
+		struct EventContentOf<Array<Type>>
+		{
+			using type = std::span<const Type>;
+		};
+
+		template <class Type> requires IsEventElement<Type>
+		struct EventContentOf<Grid<Type>>
+		{
+			using type = NetworkSystem::GridView<Type>;
+		};
+
+		template <>
+		struct EventContentOf<Array<String>>
+		{
+			using type = std::span<const StringView>;
+		};
+
+		template <>
+		struct EventContentOf<Grid<String>>
+		{
+			using type = NetworkSystem::GridView<StringView>;
+		};
+
+		/// @brief メンバ関数 void (Object::*)(int32 playerID, Argument eventContent) の型情報
+		template <class Handler>
+		struct EventHandlerTraits;
+
+		template <class ObjectType, class ArgumentType>
+		struct EventHandlerTraits<void (ObjectType::*)(int32, ArgumentType)>
+		{
+			using Object = ObjectType;
+
+			using Argument = std::remove_cvref_t<ArgumentType>;
+		};
+
+		template <class ObjectType, class ArgumentType>
+		struct EventHandlerTraits<void (ObjectType::*)(int32, ArgumentType) noexcept>
+			: EventHandlerTraits<void (ObjectType::*)(int32, ArgumentType)> {};
+
+		/// @brief カスタムプロパティの値の先頭に付ける、値の型を表す ID
+		/// @remark 型 ID を持つ型はその型 ID を、組み込みの型は型ごとに異なる値を使います。型 ID を持たない serialize() の型は、サイズのみで区別されます。
+		template <class Type>
+		struct PropertyTypeIDOf
+		{
+			static constexpr uint32 value = []() -> uint32
+			{
+				if constexpr (NetworkSystem::HasCustomTypeID<Type>)
+				{
+					return NetworkSystem::CustomTypeID<Type>();
+				}
+				else if constexpr (std::is_same_v<Type, bool>)
+				{
+					return NetworkSystem::MakeTypeID(U"bool");
+				}
+				else if constexpr (std::is_floating_point_v<Type>)
+				{
+					return NetworkSystem::MakeTypeID<Type>(U"float");
+				}
+				else if constexpr (std::is_integral_v<Type>)
+				{
+					return NetworkSystem::MakeTypeID<Type>(std::is_signed_v<Type> ? U"int" : U"uint");
+				}
+				else if constexpr (std::is_enum_v<Type>)
+				{
+					return NetworkSystem::MakeTypeID<Type>(U"enum");
+				}
+				else if constexpr (std::is_same_v<Type, String>)
+				{
+					return NetworkSystem::MakeTypeID(U"String");
+				}
+				else if constexpr (std::is_same_v<Type, Point>)
+				{
+					return NetworkSystem::MakeTypeID(U"Point");
+				}
+				else if constexpr (std::is_same_v<Type, Vec2>)
+				{
+					return NetworkSystem::MakeTypeID(U"Vec2");
+				}
+				else if constexpr (std::is_same_v<Type, Rect>)
+				{
+					return NetworkSystem::MakeTypeID(U"Rect");
+				}
+				else if constexpr (std::is_same_v<Type, RectF>)
+				{
+					return NetworkSystem::MakeTypeID(U"RectF");
+				}
+				else if constexpr (std::is_same_v<Type, Circle>)
+				{
+					return NetworkSystem::MakeTypeID(U"Circle");
+				}
+				else if constexpr (std::is_same_v<Type, ColorF>)
+				{
+					return NetworkSystem::MakeTypeID(U"ColorF");
+				}
+				else
+				{
+					return NetworkSystem::MakeTypeID<Type>(U"Serializable");
+				}
+			}();
+		};
+
+		/// @brief コンテナの ID と要素の型の ID を混ぜます。
+		[[nodiscard]]
+		constexpr uint32 MixPropertyTypeID(const uint32 container, const uint32 element) noexcept
+		{
+			return ((container ^ element) * 16777619u);
+		}
+
+		template <class Type>
+		struct PropertyTypeIDOf<Array<Type>>
+		{
+			static constexpr uint32 value = MixPropertyTypeID(NetworkSystem::MakeTypeID(U"Array"), PropertyTypeIDOf<Type>::value);
+		};
+
+		template <class Type>
+		struct PropertyTypeIDOf<Grid<Type>>
+		{
+			static constexpr uint32 value = MixPropertyTypeID(NetworkSystem::MakeTypeID(U"Grid"), PropertyTypeIDOf<Type>::value);
+		};
+
+		template <class Type>
+		struct PropertyTypeIDOf<Optional<Type>>
+		{
+			static constexpr uint32 value = MixPropertyTypeID(NetworkSystem::MakeTypeID(U"Optional"), PropertyTypeIDOf<Type>::value);
+		};
+
+		/// @brief カスタムプロパティの値を、型を表す ID に続けてパック形式で書き込みます。
+		template <class Type>
+		[[nodiscard]]
+		Array<uint8> WriteProperty(const Type& value)
+		{
+			Array<uint8> bytes;
+			const uint32 typeID = PropertyTypeIDOf<Type>::value;
+			WritePayload(bytes, &typeID, 1);
+			PackedWriter{ bytes }(value);
+			return bytes;
+		}
+
+		/// @brief カスタムプロパティの値を読み取ります。
+		/// @return 値, 型を表す ID が一致しない場合やバイト列が不正な場合は none
+		template <class Type>
+		[[nodiscard]]
+		Optional<Type> ReadProperty(const Array<uint8>& bytes)
+		{
+			uint32 typeID = 0;
+
+			if (bytes.size() < sizeof(typeID))
+			{
+				return none;
+			}
+
+			std::memcpy(&typeID, bytes.data(), sizeof(typeID));
+
+			if (typeID != PropertyTypeIDOf<Type>::value)
+			{
+				return none;
+			}
+
+			return ReadPackedValue<Type>((bytes.data() + sizeof(typeID)), (bytes.data() + bytes.size()));
+		}
+	}
+
+	namespace NetworkSystem
+	{
+		/// @brief 送信したときのサーバ時刻を付けた値
+		/// @tparam Type 値の型
+		/// @remark SnapshotBuffer に渡す値を送信するために使います。型 ID は値の型ごとに異なります。
+		template <class Type>
+		struct TimestampedValue
+		{
+			static constexpr uint32 TypeID = s3d::detail::MixPropertyTypeID(MakeTypeID(U"SivPhoton.TimestampedValue"), s3d::detail::PropertyTypeIDOf<Type>::value);
+
+			/// @brief 送信したときのサーバ時刻 (ミリ秒, SivPhoton::getServerTime())
+			int32 serverTime = 0;
+
+			Type value{};
+
+			template <class Archive>
+			void serialize(Archive& archive)
+			{
+				archive(serverTime, value);
+			}
+		};
+
+		/// @brief イベントコードごとに型付きのイベントハンドラを登録する表
+		/// @remark イベントコードごとに 1 つのハンドラを登録でき、受信したイベントの型がハンドラの引数の型と一致する場合のみ呼ばれます。
+		/// 呼び出しは配列の参照と関数ポインタの呼び出しのみで、HashTable の検索を行いません。
+		/// Array<String>, Grid<String> を StringView の並びとして渡す場合は使い回しのバッファを使うため、容量が足りるようになった後はヒープ確保を行いません。
+		class EventHandlerTable
+		{
+		public:
+
+			/// @brief イベントハンドラを登録します。
+			/// @tparam Handler メンバ関数 void (Object::*)(int32 playerID, Argument eventContent)
+			/// @param eventCode イベントコード
+			/// @param object Handler を呼ぶオブジェクト
+			/// @remark Argument には customEventAction が受け取る型 (String, Array, Grid, std::span, GridView を含む) または CustomType を満たすユーザ定義型を指定できます。
+			/// 同じイベントコードに登録済みのハンドラは置き換えられます。
+			template <auto Handler, class Object>
+			void set(const uint8 eventCode, Object* object) noexcept
+			{
+				using Traits = s3d::detail::EventHandlerTraits<decltype(Handler)>;
+				using Argument = typename Traits::Argument;
+				using Content = typename s3d::detail::EventContentOf<Argument>::type;
+
+				static_assert(std::is_base_of_v<typename Traits::Object, Object>, "Handler は Object のメンバ関数である必要があります。");
+				static_assert((not std::is_same_v<Content, SerializedValue>) || std::is_same_v<Argument, SerializedValue> || CustomType<Argument>,
+					"Handler の引数の型はイベントとして受信できません。");
+
+				m_entries[eventCode] = Entry{ &ContentKey<Content>, object, &Call<Handler, Object, Argument, Content> };
+			}
+
+			/// @brief イベントハンドラの登録を解除します。
+			/// @param eventCode イベントコード
+			void erase(const uint8 eventCode) noexcept
+			{
+				m_entries[eventCode] = Entry{};
+			}
+
+			/// @brief 指定したオブジェクトのイベントハンドラの登録をすべて解除します。
+			/// @param object set() に渡したオブジェクト
+			void eraseObject(const void* object) noexcept
+			{
+				for (auto& entry : m_entries)
+				{
+					if (entry.object == object)
+					{
+						entry = Entry{};
+					}
+				}
+			}
+
+			/// @brief イベントハンドラが登録されているかを返します。
+			/// @param eventCode イベントコード
+			[[nodiscard]]
+			bool contains(const uint8 eventCode) const noexcept
+			{
+				return (m_entries[eventCode].function != nullptr);
+			}
+
+			/// @brief 受信したイベントを登録されたイベントハンドラに渡します。
+			/// @return イベントハンドラが呼ばれた場合 true, 登録がない場合や型が一致しない場合は false
+			template <class Type>
+			bool call(const uint8 eventCode, const int32 playerID, const Type& eventContent) const
+			{
+				using Content = typename s3d::detail::EventContentOf<Type>::type;
+
+				const Entry& entry = m_entries[eventCode];
+
+				if (entry.key != &ContentKey<Content>)
+				{
+					return false;
+				}
+
+				if constexpr (std::is_same_v<Type, Content>)
+				{
+					return entry.function(entry.object, playerID, &eventContent);
+				}
+				else if constexpr (std::is_same_v<Type, String>)
+				{
+					const StringView content{ eventContent };
+					return entry.function(entry.object, playerID, &content);
+				}
+				else if constexpr (std::is_same_v<Type, Array<String>> || std::is_same_v<Type, Grid<String>>)
+				{
+					Array<StringView>& views = m_stringViews;
+					views.assign(eventContent.begin(), eventContent.end());
+
+					if constexpr (std::is_same_v<Type, Array<String>>)
+					{
+						const Content content{ views.data(), views.size() };
+						return entry.function(entry.object, playerID, &content);
+					}
+					else
+					{
+						const Content content{ views.data(), eventContent.size() };
+						return entry.function(entry.object, playerID, &content);
+					}
+				}
+				else
+				{
+					// Array → std::span, Grid → GridView
+					const Content content{ eventContent.data(), eventContent.size() };
+					return entry.function(entry.object, playerID, &content);
+				}
+			}
+
+		private:
+
+			struct Entry
+			{
+				/// @brief ハンドラが受け取る型を識別するアドレス
+				const void* key = nullptr;
+
+				void* object = nullptr;
+
+				bool (*function)(void* object, int32 playerID, const void* eventContent) = nullptr;
+			};
+
+			std::array<Entry, 256> m_entries{};
+
+			/// @brief Array<String>, Grid<String> を StringView の並びとして渡すための使い回しのバッファ
+			mutable Array<StringView> m_stringViews;
+
+			/// @brief 型ごとに異なるアドレスを持つ変数 (RTTI を使わずに型を識別するため)
+			/// @remark 読み取り専用の同じ内容の定数は、リンカの同一内容の統合 (MSVC /OPT:ICF, lld --icf=all) で同じアドレスになりうるため、書き換え可能な変数にする
+			template <class Content>
+			static inline char ContentKey = 0;
+
+			template <auto Handler, class Object, class Argument, class Content>
+			static bool Call(void* object, const int32 playerID, const void* eventContent)
+			{
+				Object& target = *static_cast<Object*>(object);
+				const Content& content = *static_cast<const Content*>(eventContent);
+
+				if constexpr (std::is_same_v<Argument, Content>)
+				{
+					(target.*Handler)(playerID, content);
+				}
+				else if constexpr (std::is_same_v<Content, SerializedValue>)
+				{
+					// 型が異なる場合やデータが不正な場合は customEventAction に任せる
+					auto value = content.template get<Argument>();
+
+					if (not value)
+					{
+						return false;
+					}
+
+					(target.*Handler)(playerID, *value);
+				}
+				else if constexpr (std::is_same_v<Argument, String>)
+				{
+					(target.*Handler)(playerID, String{ content });
+				}
+				else if constexpr (std::is_same_v<Argument, Array<typename Argument::value_type>>)
+				{
+					(target.*Handler)(playerID, Argument(content.begin(), content.end()));
+				}
+				else
+				{
+					(target.*Handler)(playerID, Argument{ content.size(), Array<typename Argument::value_type>(content.begin(), content.end()) });
+				}
+
+				return true;
+			}
+		};
+
+		/// @brief クライアント側予測のフック
+		/// @tparam Input 入力の型
+		/// @tparam State 予測する状態の型
+		/// @remark 予測を使うシーンがこのクラスを継承し、Prediction に渡します。
+		template <class Input, class State>
+		class IPredictable
+		{
+		public:
+
+			virtual ~IPredictable() = default;
+
+			/// @brief 入力 1 つ分、状態を進めます。
+			/// @param state 進める状態
+			/// @param input 入力
+			/// @remark 再適用のために同じ入力で何度も呼ばれるため、state 以外を変更しないでください。
+			virtual void simulateStep(State& state, const Input& input) = 0;
+
+			/// @brief 予測した状態を反映します。
+			/// @param state 予測した状態
+			virtual void applyPredictedState(const State& state) = 0;
+		};
+
+		/// @brief マスタークライアントが状態を決めるゲームのための、クライアント側予測とサーバ照合
+		/// @tparam Input 入力の型
+		/// @tparam State 予測する状態の型
+		/// @tparam Capacity マスタークライアントに確認されていない入力を保持する数
+		/// @remark predict() で入力に連番を付けてその場で状態に適用し、送信する InputMessage を返します。
+		/// マスタークライアントは入力を処理して、処理した最後の連番とともに状態を StateMessage で送り返します。
+		/// reconcile() はその状態まで巻き戻し、まだ確認されていない入力を再適用します。
+		template <Serializable Input, Serializable State, size_t Capacity = 64>
+		class Prediction
+		{
+		public:
+
+			static_assert(1 <= Capacity);
+
+			/// @brief 連番を付けた入力
+			struct InputMessage
+			{
+				static constexpr uint32 TypeID = MakeTypeID<Input>(U"SivPhoton.Prediction.InputMessage");
+
+				uint32 sequence = 0;
+
+				Input input{};
+
+				template <class Archive>
+				void serialize(Archive& archive)
+				{
+					archive(sequence, input);
+				}
+			};
+
+			/// @brief マスタークライアントが決めた状態
+			struct StateMessage
+			{
+				static constexpr uint32 TypeID = MakeTypeID<State>(U"SivPhoton.Prediction.StateMessage");
+
+				/// @brief 状態に反映済みの最後の入力の連番
+				uint32 sequence = 0;
+
+				State state{};
+
+				template <class Archive>
+				void serialize(Archive& archive)
+				{
+					archive(sequence, state);
+				}
+			};
+
+			/// @brief Prediction を作成します。
+			/// @param hooks 状態を進める関数と、予測した状態を反映する関数
+			/// @param initialState 初期状態
+			SIV3D_NODISCARD_CXX20
+			explicit Prediction(IPredictable<Input, State>& hooks, const State& initialState = State{})
+				: m_hooks{ hooks }
+				, m_authoritativeState{ initialState }
+				, m_predictedState{ initialState } {}
+
+			/// @brief 入力に連番を付けて予測した状態に適用します。
+			/// @param input 入力
+			/// @return マスタークライアントに送信するメッセージ
+			/// @remark 確認されていない入力が Capacity 個ある場合は、最も古い入力を捨てます (次の照合でその入力の効果は失われます)。
+			[[nodiscard]]
+			InputMessage predict(const Input& input)
+			{
+				if (m_count == Capacity)
+				{
+					m_head = ((m_head + 1) % Capacity);
+					--m_count;
+				}
+
+				const InputMessage message{ ++m_lastSequence, input };
+				m_pendingInputs[(m_head + m_count++) % Capacity] = message;
+
+				m_hooks.simulateStep(m_predictedState, input);
+				m_hooks.applyPredictedState(m_predictedState);
+
+				return message;
+			}
+
+			/// @brief マスタークライアントが決めた状態に巻き戻し、確認されていない入力を再適用します。
+			/// @param message 受信したメッセージ
+			/// @remark 既に照合したものより古いメッセージは無視します。
+			void reconcile(const StateMessage& message)
+			{
+				if (m_hasAcknowledged && (static_cast<int32>(message.sequence - m_acknowledgedSequence) < 0))
+				{
+					return;
+				}
+
+				m_hasAcknowledged = true;
+				m_acknowledgedSequence = message.sequence;
+				m_authoritativeState = message.state;
+
+				while (m_count && (static_cast<int32>(m_pendingInputs[m_head].sequence - message.sequence) <= 0))
+				{
+					m_head = ((m_head + 1) % Capacity);
+					--m_count;
+				}
+
+				m_predictedState = message.state;
+
+				for (size_t i = 0; i < m_count; ++i)
+				{
+					m_hooks.simulateStep(m_predictedState, m_pendingInputs[(m_head + i) % Capacity].input);
+				}
+
+				m_hooks.applyPredictedState(m_predictedState);
+			}
+
+			/// @brief 状態と入力の履歴を初期化します。
+			/// @param state 初期状態
+			void reset(const State& state = State{})
+			{
+				m_authoritativeState = state;
+				m_predictedState = state;
+				m_head = 0;
+				m_count = 0;
+				m_lastSequence = 0;
+				m_acknowledgedSequence = 0;
+				m_hasAcknowledged = false;
+			}
+
+			/// @brief 確認されていない入力まで適用した、予測した状態を返します。
+			[[nodiscard]]
+			const State& predictedState() const noexcept
+			{
+				return m_predictedState;
+			}
+
+			/// @brief 最後に受信した、マスタークライアントが決めた状態を返します。
+			[[nodiscard]]
+			const State& authoritativeState() const noexcept
+			{
+				return m_authoritativeState;
+			}
+
+			/// @brief 最後に付けた入力の連番を返します。
+			[[nodiscard]]
+			uint32 lastSequence() const noexcept
+			{
+				return m_lastSequence;
+			}
+
+			/// @brief マスタークライアントに確認された最後の入力の連番を返します。
+			[[nodiscard]]
+			uint32 acknowledgedSequence() const noexcept
+			{
+				return m_acknowledgedSequence;
+			}
+
+			/// @brief 確認されていない入力の数を返します。
+			[[nodiscard]]
+			size_t pendingCount() const noexcept
+			{
+				return m_count;
+			}
+
+		private:
+
+			IPredictable<Input, State>& m_hooks;
+
+			State m_authoritativeState;
+
+			State m_predictedState;
+
+			/// @brief 確認されていない入力 (リングバッファ)
+			std::array<InputMessage, Capacity> m_pendingInputs{};
+
+			size_t m_head = 0;
+
+			size_t m_count = 0;
+
+			uint32 m_lastSequence = 0;
+
+			uint32 m_acknowledgedSequence = 0;
+
+			bool m_hasAcknowledged = false;
+		};
+
+		/// @brief ロックステップで、ある tick に適用するプレイヤーの入力
+		/// @tparam Input 入力の型
+		template <class Input>
+		struct LockstepInput
+		{
+			int32 playerID = 0;
+
+			Input input{};
+		};
+
+		/// @brief ロックステップのフック
+		/// @tparam Input 入力の型
+		/// @tparam State 巻き戻しとチェックサムに使う、シミュレーションの状態の型
+		/// @remark ロックステップを使うシーンがこのクラスを継承し、Lockstep に渡します。
+		template <Serializable Input, Serializable State>
+		class ILockstep
+		{
+		public:
+
+			virtual ~ILockstep() = default;
+
+			/// @brief 自分の入力を読み取ります。
+			/// @param tick 入力を適用する tick
+			/// @return 入力
+			/// @remark 読み取った入力は、入力遅延の分だけ後の tick に適用されます。
+			[[nodiscard]]
+			virtual Input readInput(uint32 tick) = 0;
+
+			/// @brief シミュレーションを 1 tick 進めます。
+			/// @param tick 進める tick
+			/// @param inputs すべてのプレイヤーの入力 (プレイヤー ID の昇順)
+			/// @remark すべてのクライアントで同じ結果になるよう、inputs と状態以外 (経過時間や Random など) に依存しないでください。
+			/// 巻き戻しを有効にした場合、届いていない入力は予測した入力で、同じ tick で何度も呼ばれます。
+			virtual void simulateTick(uint32 tick, std::span<const LockstepInput<Input>> inputs) = 0;
+
+			/// @brief シミュレーションの状態を保存します。
+			/// @return 状態
+			[[nodiscard]]
+			virtual State saveState() const = 0;
+
+			/// @brief 保存した状態に巻き戻します。
+			/// @param state saveState() で保存した状態
+			virtual void loadState(const State& state) = 0;
+
+			/// @brief 状態のチェックサムを計算します。
+			/// @param state saveState() で保存した状態
+			/// @return チェックサム
+			/// @remark 既定では、状態をパック形式にしたバイト列のハッシュを返します。
+			/// クラス型はメンバごとにパックされるため、パディングの値によってチェックサムが変わることはありません。
+			[[nodiscard]]
+			virtual uint64 checksum(const State& state) const
+			{
+				return s3d::detail::PackedChecksum(state);
+			}
+
+			/// @brief 他のプレイヤーとチェックサムが一致しなかったときに呼ばれます。
+			/// @param tick 一致しなかった状態までにシミュレーションした tick 数
+			/// @param playerID チェックサムを送ったプレイヤーの ID
+			virtual void desyncDetected(const uint32 tick, const int32 playerID)
+			{
+				SIVPHOTON_LOG(Warning, U"ILockstep::desyncDetected() tick: ", tick, U", playerID: ", playerID);
+			}
+		};
+
+		/// @brief ロックステップの設定
+		struct LockstepOptions
+		{
+			/// @brief 1 秒あたりの tick 数
+			double tickRate = 20.0;
+
+			/// @brief 入力を読み取ってから適用するまでの tick 数
+			/// @remark 入力が他のプレイヤーに届くまでの時間を隠します。大きいほど待ちは減りますが、操作への反応が遅れます。
+			uint32 inputDelay = 3;
+
+			/// @brief 届いていない入力を予測して先に進め、予測と異なる入力が届いたら巻き戻して再シミュレーションするか
+			bool rollback = false;
+
+			/// @brief 予測で先に進める最大の tick 数
+			uint32 maxPredictionTicks = 8;
+
+			/// @brief チェックサムを送る間隔 (tick 数, 0 の場合は送らない)
+			uint32 checksumInterval = 30;
+
+			/// @brief 遅れを取り戻すときに、1 回の update() で進める最大の tick 数
+			uint32 maxTicksPerUpdate = 4;
+		};
+
+		/// @brief 毎 tick の入力だけを交換して、すべてのクライアントで同じシミュレーションを進めるロックステップ
+		/// @tparam Input 入力の型
+		/// @tparam State 巻き戻しとチェックサムに使う、シミュレーションの状態の型
+		/// @tparam Capacity 入力と状態を保持する tick 数
+		/// @remark update() で自分の入力を読み取り、送信する InputMessage を返します。すべてのプレイヤーの入力が届いた tick から順に、固定の間隔でシミュレーションを進めます。
+		/// 巻き戻しを有効にした場合は、届いていない入力を各プレイヤーの最後の入力で予測して先に進め、予測と異なる入力が届いたら保存した状態に巻き戻して再シミュレーションします。
+		/// 確定した状態のチェックサムを入力に添えて送り、他のプレイヤーと一致しなければ ILockstep::desyncDetected() を呼びます。
+		template <Serializable Input, Serializable State, size_t Capacity = 64>
+		class Lockstep
+		{
+		public:
+
+			static_assert(2 <= Capacity);
+
+			/// @brief ある tick に適用する入力
+			struct InputMessage
+			{
+				static constexpr uint32 TypeID = MakeTypeID<Input>(U"SivPhoton.Lockstep.InputMessage");
+
+				uint32 tick = 0;
+
+				Input input{};
+
+				/// @brief checksum を計算した状態までにシミュレーションした tick 数 (0 の場合はチェックサムなし)
+				uint32 checksumTick = 0;
+
+				uint64 checksum = 0;
+
+				template <class Archive>
+				void serialize(Archive& archive)
+				{
+					archive(tick, input, checksumTick, checksum);
+				}
+			};
+
+			/// @brief Lockstep を作成します。
+			/// @param hooks 入力の読み取り、シミュレーション、状態の保存と復元をする関数
+			/// @param options ロックステップの設定
+			/// @remark 他のプレイヤーが最大で (inputDelay + maxPredictionTicks) * 2 + 1 tick 先の入力を送ってくるため、Capacity はそれより大きくする必要があります。
+			SIV3D_NODISCARD_CXX20
+			explicit Lockstep(ILockstep<Input, State>& hooks, const LockstepOptions& options = LockstepOptions{})
+				: m_hooks{ hooks }
+				, m_options{ options }
+			{
+				assert(0.0 < m_options.tickRate);
+				assert((((m_options.inputDelay + (m_options.rollback ? m_options.maxPredictionTicks : 0)) * 2) + 1) < Capacity);
+			}
+
+			/// @brief 参加するプレイヤーを決めて、tick 0 からシミュレーションを開始します。
+			/// @param playerIDs 参加するプレイヤーの ID (すべてのクライアントで同じである必要があります)
+			/// @param localPlayerID 自分のプレイヤー ID
+			/// @remark 最初の inputDelay 個の tick は、すべてのプレイヤーの入力を Input{} とします。
+			void start(const Array<int32>& playerIDs, const int32 localPlayerID)
+			{
+				if (not playerIDs.contains(localPlayerID))
+				{
+					SIVPHOTON_LOG(Error, U"Lockstep::start() playerIDs に自分のプレイヤー ID が含まれていません");
+					return;
+				}
+
+				m_players.clear();
+
+				for (const int32 playerID : playerIDs.sorted_and_uniqued())
+				{
+					m_players << Player{ .playerID = playerID, .receivedUntil = m_options.inputDelay };
+				}
+
+				m_localIndex = static_cast<size_t>(std::ranges::find(m_players, localPlayerID, &Player::playerID) - m_players.begin());
+
+				for (uint32 tick = 0; tick < Capacity; ++tick)
+				{
+					resetSlot(m_slots[tick], tick);
+				}
+
+				m_checksums.clear();
+				m_pendingChecksums.clear();
+				m_outgoingChecksum.reset();
+				m_accumulator = 0.0;
+				m_tick = 0;
+				m_confirmedTick = 0;
+				m_rollbackTick = NoRollback;
+				m_rollbackCount = 0;
+				m_waiting = false;
+				m_running = true;
+			}
+
+			/// @brief シミュレーションを止めます。
+			void stop() noexcept
+			{
+				m_running = false;
+			}
+
+			/// @brief 巻き戻しが必要なら再シミュレーションし、経過時間に応じてシミュレーションを進めます。
+			/// @param deltaTime 前回の update() からの経過時間 (秒)
+			/// @return 他のプレイヤーに送信するメッセージ
+			/// @remark すべてのプレイヤーの入力がそろわない場合 (巻き戻しを有効にした場合は、予測で進める上限に達した場合) は待ちます。
+			[[nodiscard]]
+			Array<InputMessage> update(const double deltaTime)
+			{
+				Array<InputMessage> messages;
+
+				if (not m_running)
+				{
+					return messages;
+				}
+
+				resimulate();
+				confirm();
+
+				const double interval = (1.0 / m_options.tickRate);
+				m_accumulator += deltaTime;
+				m_waiting = false;
+
+				for (uint32 i = 0; (i < m_options.maxTicksPerUpdate) && (interval <= m_accumulator); ++i)
+				{
+					const uint32 inputTick = (m_tick + m_options.inputDelay);
+					Player& local = m_players[m_localIndex];
+
+					if (local.receivedUntil <= inputTick)
+					{
+						const Input input = m_hooks.readInput(inputTick);
+
+						slot(inputTick).inputs[m_localIndex].input = input;
+						local.lastInput = input;
+						local.receivedUntil = (inputTick + 1);
+
+						InputMessage& message = messages.emplace_back(InputMessage{ .tick = inputTick, .input = input });
+
+						if (m_outgoingChecksum)
+						{
+							message.checksumTick = m_outgoingChecksum->first;
+							message.checksum = m_outgoingChecksum->second;
+							m_outgoingChecksum.reset();
+						}
+					}
+
+					if (not canSimulate(m_tick))
+					{
+						m_waiting = true;
+						break;
+					}
+
+					simulate(m_tick++);
+					confirm();
+					m_accumulator -= interval;
+				}
+
+				// 待っている間や処理が追いつかない間に溜まった時間で、後からまとめて進めないようにする
+				m_accumulator = Min(m_accumulator, interval);
+
+				return messages;
+			}
+
+			/// @brief 他のプレイヤーから届いた入力を記録します。
+			/// @param playerID 送信したプレイヤーの ID
+			/// @param message 受信したメッセージ
+			/// @remark 予測して進めた tick の入力が予測と異なる場合、次の update() で巻き戻します。
+			void receive(const int32 playerID, const InputMessage& message)
+			{
+				if (not m_running)
+				{
+					return;
+				}
+
+				const auto it = std::ranges::find(m_players, playerID, &Player::playerID);
+
+				if ((it == m_players.end())
+					|| (static_cast<size_t>(it - m_players.begin()) == m_localIndex)
+					|| it->left)
+				{
+					return;
+				}
+
+				// 入力は信頼性のある送信で tick の順に届く
+				if ((message.tick != it->receivedUntil)
+					|| ((m_confirmedTick + Capacity) <= message.tick))
+				{
+					SIVPHOTON_LOG(Warning, U"Lockstep::receive() 想定外の tick の入力を無視しました。playerID: ", playerID, U", tick: ", message.tick);
+					return;
+				}
+
+				LockstepInput<Input>& entry = slot(message.tick).inputs[it - m_players.begin()];
+
+				if ((message.tick < m_tick)
+					&& (not SameInput(entry.input, message.input)))
+				{
+					m_rollbackTick = Min(m_rollbackTick, message.tick);
+				}
+
+				entry.input = message.input;
+				it->lastInput = message.input;
+				it->receivedUntil = (message.tick + 1);
+
+				if (message.checksumTick)
+				{
+					compareChecksum(playerID, message.checksumTick, message.checksum);
+				}
+			}
+
+			/// @brief 退室したプレイヤーの入力を待たないようにします。
+			/// @param playerID 退室したプレイヤーの ID
+			/// @remark 最後に届いた入力より後の tick では、そのプレイヤーの入力を Input{} とします。
+			void removePlayer(const int32 playerID)
+			{
+				const auto it = std::ranges::find(m_players, playerID, &Player::playerID);
+
+				if ((not m_running)
+					|| (it == m_players.end())
+					|| (static_cast<size_t>(it - m_players.begin()) == m_localIndex)
+					|| it->left)
+				{
+					return;
+				}
+
+				it->left = true;
+
+				if (it->receivedUntil < m_tick)
+				{
+					m_rollbackTick = Min(m_rollbackTick, it->receivedUntil);
+				}
+			}
+
+			/// @brief シミュレーションを進めているかを返します。
+			[[nodiscard]]
+			bool isRunning() const noexcept
+			{
+				return m_running;
+			}
+
+			/// @brief 前回の update() で、入力が届くのを待って止まったかを返します。
+			[[nodiscard]]
+			bool isWaiting() const noexcept
+			{
+				return m_waiting;
+			}
+
+			/// @brief シミュレーションした tick 数 (予測して進めた tick を含む) を返します。
+			[[nodiscard]]
+			uint32 tick() const noexcept
+			{
+				return m_tick;
+			}
+
+			/// @brief すべてのプレイヤーの入力でシミュレーションした tick 数を返します。
+			[[nodiscard]]
+			uint32 confirmedTick() const noexcept
+			{
+				return m_confirmedTick;
+			}
+
+			/// @brief 巻き戻した回数を返します。
+			[[nodiscard]]
+			uint32 rollbackCount() const noexcept
+			{
+				return m_rollbackCount;
+			}
+
+			/// @brief 参加しているプレイヤーの ID を返します。
+			[[nodiscard]]
+			Array<int32> playerIDs() const
+			{
+				return m_players.map([](const Player& player) { return player.playerID; });
+			}
+
+		private:
+
+			struct Player
+			{
+				int32 playerID = 0;
+
+				/// @brief この tick より前の入力はすべて届いている
+				uint32 receivedUntil = 0;
+
+				/// @brief 最後に届いた入力 (予測に使う)
+				Input lastInput{};
+
+				/// @brief 退室したか
+				bool left = false;
+			};
+
+			struct Slot
+			{
+				uint32 tick = 0;
+
+				/// @brief プレイヤーごとの入力 (届いていない場合は予測した入力)
+				Array<LockstepInput<Input>> inputs;
+
+				/// @brief この tick をシミュレーションする前の状態 (巻き戻し用)
+				State snapshot{};
+			};
+
+			/// @brief 他のプレイヤーから届いた、まだ自分が計算していない tick のチェックサム
+			struct PendingChecksum
+			{
+				int32 playerID = 0;
+
+				uint32 tick = 0;
+
+				uint64 checksum = 0;
+			};
+
+			static constexpr uint32 NoRollback = Largest<uint32>;
+
+			/// @brief 比較のために保持する自分のチェックサムの数
+			static constexpr uint32 ChecksumHistory = 8;
+
+			ILockstep<Input, State>& m_hooks;
+
+			LockstepOptions m_options;
+
+			/// @brief 参加しているプレイヤー (プレイヤー ID の昇順)
+			Array<Player> m_players;
+
+			size_t m_localIndex = 0;
+
+			/// @brief tick ごとの入力と状態 (リングバッファ)
+			std::array<Slot, Capacity> m_slots{};
+
+			/// @brief 自分が計算したチェックサム
+			HashTable<uint32, uint64> m_checksums;
+
+			Array<PendingChecksum> m_pendingChecksums;
+
+			/// @brief 次に送信する入力に添えるチェックサム
+			Optional<std::pair<uint32, uint64>> m_outgoingChecksum;
+
+			double m_accumulator = 0.0;
+
+			/// @brief 次にシミュレーションする tick
+			uint32 m_tick = 0;
+
+			/// @brief この tick より前はすべてのプレイヤーの入力でシミュレーションした
+			uint32 m_confirmedTick = 0;
+
+			/// @brief 予測と異なる入力が届いた最も古い tick
+			uint32 m_rollbackTick = NoRollback;
+
+			uint32 m_rollbackCount = 0;
+
+			bool m_waiting = false;
+
+			bool m_running = false;
+
+			void resetSlot(Slot& s, const uint32 tick) const
+			{
+				s.tick = tick;
+				s.inputs = m_players.map([](const Player& player) { return LockstepInput<Input>{ player.playerID, Input{} }; });
+			}
+
+			[[nodiscard]]
+			Slot& slot(const uint32 tick)
+			{
+				Slot& s = m_slots[tick % Capacity];
+
+				if (s.tick != tick)
+				{
+					resetSlot(s, tick);
+				}
+
+				return s;
+			}
+
+			/// @brief すべてのプレイヤーの tick の入力が決まっているかを返します。
+			[[nodiscard]]
+			bool isComplete(const uint32 tick) const noexcept
+			{
+				return std::ranges::all_of(m_players, [=](const Player& player) { return (player.left || (tick < player.receivedUntil)); });
+			}
+
+			[[nodiscard]]
+			bool canSimulate(const uint32 tick) const noexcept
+			{
+				if (isComplete(tick))
+				{
+					return true;
+				}
+
+				return (m_options.rollback && ((tick - m_confirmedTick) < m_options.maxPredictionTicks));
+			}
+
+			void simulate(const uint32 tick)
+			{
+				Slot& s = slot(tick);
+				bool complete = true;
+
+				for (size_t i = 0; i < m_players.size(); ++i)
+				{
+					const Player& player = m_players[i];
+
+					if (tick < player.receivedUntil)
+					{
+						continue;
+					}
+
+					if (player.left)
+					{
+						s.inputs[i].input = Input{};
+					}
+					else
+					{
+						s.inputs[i].input = player.lastInput;
+						complete = false;
+					}
+				}
+
+				// 確定した状態の直後の、予測を含まない tick は巻き戻す必要がない
+				if (m_options.rollback && ((not complete) || (m_confirmedTick < tick)))
+				{
+					s.snapshot = m_hooks.saveState();
+				}
+
+				m_hooks.simulateTick(tick, s.inputs);
+			}
+
+			/// @brief 予測と異なる入力が届いた tick まで巻き戻し、現在の tick まで再シミュレーションします。
+			void resimulate()
+			{
+				if (m_tick <= m_rollbackTick)
+				{
+					m_rollbackTick = NoRollback;
+					return;
+				}
+
+				const uint32 target = m_tick;
+
+				m_hooks.loadState(slot(m_rollbackTick).snapshot);
+				m_tick = m_rollbackTick;
+				m_rollbackTick = NoRollback;
+				++m_rollbackCount;
+
+				while (m_tick < target)
+				{
+					simulate(m_tick++);
+				}
+			}
+
+			/// @brief すべてのプレイヤーの入力でシミュレーションした tick を確定し、チェックサムを計算します。
+			void confirm()
+			{
+				while ((m_confirmedTick < m_tick)
+					&& isComplete(m_confirmedTick))
+				{
+					++m_confirmedTick;
+
+					if (m_options.checksumInterval
+						&& ((m_confirmedTick % m_options.checksumInterval) == 0))
+					{
+						// 先に予測して進めている場合は、次の tick の前に保存した状態が確定した状態になる
+						recordChecksum(m_confirmedTick, m_hooks.checksum((m_confirmedTick == m_tick) ? m_hooks.saveState() : slot(m_confirmedTick).snapshot));
+					}
+				}
+			}
+
+			void recordChecksum(const uint32 tick, const uint64 checksum)
+			{
+				m_checksums[tick] = checksum;
+				m_checksums.erase(tick - (ChecksumHistory * m_options.checksumInterval));
+				m_outgoingChecksum.emplace(tick, checksum);
+
+				m_pendingChecksums.remove_if([&](const PendingChecksum& pending)
+					{
+						if (pending.tick != tick)
+						{
+							return false;
+						}
+
+						if (pending.checksum != checksum)
+						{
+							m_hooks.desyncDetected(tick, pending.playerID);
+						}
+
+						return true;
+					});
+			}
+
+			void compareChecksum(const int32 playerID, const uint32 tick, const uint64 checksum)
+			{
+				if (const auto it = m_checksums.find(tick);
+					it != m_checksums.end())
+				{
+					if (it->second != checksum)
+					{
+						m_hooks.desyncDetected(tick, playerID);
+					}
+				}
+				else if (m_confirmedTick < tick)
+				{
+					m_pendingChecksums << PendingChecksum{ playerID, tick, checksum };
+				}
+			}
+
+			/// @brief 予測した入力と届いた入力が同じかを返します。
+			/// @remark operator== を持たない型は、パディングを含まないパック形式 (メンバごと) のバイト列で比較します。
+			[[nodiscard]]
+			static bool SameInput(const Input& a, const Input& b)
+			{
+				if constexpr (std::equality_comparable<Input>)
+				{
+					return (a == b);
+				}
+				else
+				{
+					static_assert((s3d::detail::HasSerializeFunction<Input> || s3d::detail::IsPackedMemcpyable<Input>),
+						"operator== を持たない入力の型は、serialize(Archive&) でメンバを列挙してください。");
+
+					return s3d::detail::PackedEquals(a, b);
+				}
+			}
+		};
+
+		class NetworkVarRegistry;
+
+		/// @brief NetworkVar の型に依らない部分
+		class NetworkVarBase
+		{
+		public:
+
+			/// @brief NetworkVarBase を作成します。
+			/// @param id 通信するすべてのクライアントで同じ ID
+			SIV3D_NODISCARD_CXX20
+			explicit NetworkVarBase(const uint32 id) noexcept
+				: m_id{ id } {}
+
+			NetworkVarBase(const NetworkVarBase&) = delete;
+
+			NetworkVarBase& operator =(const NetworkVarBase&) = delete;
+
+			/// @brief 登録を解除します。
+			virtual ~NetworkVarBase();
+
+			[[nodiscard]]
+			uint32 id() const noexcept
+			{
+				return m_id;
+			}
+
+			/// @brief 次の送信を待っている変更があるかを返します。
+			[[nodiscard]]
+			bool isDirty() const noexcept
+			{
+				return m_dirty;
+			}
+
+			/// @brief 値をパック形式でバッファの末尾に書き込みます。
+			virtual void writeValue(Array<uint8>& buffer) const = 0;
+
+			/// @brief 受信した値を読み取ります。変更の印は付けません。
+			/// @return 読み取りに成功した場合 true, データが不正な場合は false
+			[[nodiscard]]
+			virtual bool readValue(const uint8* begin, const uint8* end) = 0;
+
+		protected:
+
+			/// @brief 値が変更されたことを記録し、次の送信に含めます。
+			void markDirty();
+
+		private:
+
+			friend class NetworkVarRegistry;
+
+			uint32 m_id;
+
+			bool m_dirty = false;
+
+			NetworkVarRegistry* m_registry = nullptr;
+		};
+
+		/// @brief 同じ ID の NetworkVar を持つクライアント間で自動的に同期される値
+		/// @tparam Type 値の型 (int32, double, float, bool, String, Point, Vec2, Rect, Circle などの Serializable な型)
+		/// @remark 値を変更すると変更の印が付き、次の送信 (SivPhoton::update() またはネットワークティック) で、変更されたすべての NetworkVar の値をひとつのイベントにまとめて送信します。
+		/// 後からルームに参加したプレイヤーには、マスタークライアントがすべての値を送信します。
+		template <Serializable Type>
+		class NetworkVar : public NetworkVarBase
+		{
+		public:
+
+			/// @brief NetworkVar を作成します。
+			/// @param id 通信するすべてのクライアントで同じ ID
+			/// @param value 初期値
+			SIV3D_NODISCARD_CXX20
+			explicit NetworkVar(const uint32 id, const Type& value = Type{})
+				: NetworkVarBase{ id }
+				, m_value{ value } {}
+
+			NetworkVar& operator =(const Type& value)
+			{
+				set(value);
+				return *this;
+			}
+
+			[[nodiscard]]
+			const Type& get() const noexcept
+			{
+				return m_value;
+			}
+
+			[[nodiscard]]
+			operator const Type&() const noexcept
+			{
+				return m_value;
+			}
+
+			/// @brief 値を変更します。
+			/// @param value 新しい値
+			/// @remark 現在の値と等しい場合は何もしません。
+			void set(const Type& value)
+			{
+				if (m_value == value)
+				{
+					return;
+				}
+
+				m_value = value;
+				markDirty();
+			}
+
+			/// @brief 値をその場で変更します。
+			/// @param f 値の参照を受け取る関数
+			/// @remark 変更の有無に関わらず変更の印を付けます。
+			template <class Function>
+			void modify(Function f)
+			{
+				f(m_value);
+				markDirty();
+			}
+
+			void writeValue(Array<uint8>& buffer) const override
+			{
+				s3d::detail::PackedWriter{ buffer }(m_value);
+			}
+
+			bool readValue(const uint8* begin, const uint8* end) override
+			{
+				Type value{};
+				s3d::detail::PackedReader reader{ begin, end };
+				reader(value);
+
+				if ((not reader.isValid())
+					|| (not reader.isEnd()))
+				{
+					return false;
+				}
+
+				m_value = std::move(value);
+				return true;
+			}
+
+		private:
+
+			Type m_value;
+		};
+
+		/// @brief NetworkVar を ID で検索する表と、変更された NetworkVar の一覧
+		class NetworkVarRegistry
+		{
+		public:
+
+			SIV3D_NODISCARD_CXX20
+			NetworkVarRegistry() = default;
+
+			NetworkVarRegistry(const NetworkVarRegistry&) = delete;
+
+			NetworkVarRegistry& operator =(const NetworkVarRegistry&) = delete;
+
+			~NetworkVarRegistry()
+			{
+				for (auto& [id, var] : m_vars)
+				{
+					var->m_registry = nullptr;
+				}
+			}
+
+			/// @brief NetworkVar を登録します。
+			/// @remark 同じ ID の NetworkVar が登録されている場合は置き換えます。
+			void add(NetworkVarBase& var)
+			{
+				if (var.m_registry)
+				{
+					var.m_registry->remove(var);
+				}
+
+				if (const auto it = m_vars.find(var.m_id); it != m_vars.end())
+				{
+					remove(*it->second);
+				}
+
+				var.m_registry = this;
+				m_vars.emplace(var.m_id, &var);
+
+				if (var.m_dirty)
+				{
+					m_dirty << &var;
+				}
+			}
+
+			void remove(NetworkVarBase& var)
+			{
+				if (var.m_registry != this)
+				{
+					return;
+				}
+
+				m_vars.erase(var.m_id);
+				m_dirty.remove_if([&](const NetworkVarBase* dirty) { return (dirty == &var); });
+				var.m_registry = nullptr;
+			}
+
+			/// @brief 指定した ID の NetworkVar を返します。
+			/// @return NetworkVar, 登録されていない場合は nullptr
+			[[nodiscard]]
+			NetworkVarBase* find(const uint32 id) const noexcept
+			{
+				const auto it = m_vars.find(id);
+
+				return ((it == m_vars.end()) ? nullptr : it->second);
+			}
+
+			/// @brief 変更された NetworkVar があるかを返します。
+			[[nodiscard]]
+			bool hasDirty() const noexcept
+			{
+				return (not m_dirty.isEmpty());
+			}
+
+			/// @brief 変更された NetworkVar の値を NetworkVars の形式で書き込み、変更の印を消します。
+			void writeDirty(Array<uint8>& buffer)
+			{
+				s3d::detail::WriteNetworkVarsHeader(buffer, m_dirty.size());
+
+				for (NetworkVarBase* var : m_dirty)
+				{
+					append(buffer, *var);
+					var->m_dirty = false;
+				}
+
+				m_dirty.clear();
+			}
+
+			/// @brief すべての NetworkVar の値を NetworkVars の形式で書き込みます。
+			/// @return 登録されている NetworkVar がある場合 true, それ以外の場合は false
+			bool writeAll(Array<uint8>& buffer)
+			{
+				if (m_vars.empty())
+				{
+					return false;
+				}
+
+				s3d::detail::WriteNetworkVarsHeader(buffer, m_vars.size());
+
+				for (const auto& [id, var] : m_vars)
+				{
+					append(buffer, *var);
+				}
+
+				return true;
+			}
+
+		private:
+
+			friend class NetworkVarBase;
+
+			HashTable<uint32, NetworkVarBase*> m_vars;
+
+			Array<NetworkVarBase*> m_dirty;
+
+			/// @brief 値を書き込むための使い回しのバッファ
+			Array<uint8> m_valueBuffer;
+
+			void append(Array<uint8>& buffer, const NetworkVarBase& var)
+			{
+				m_valueBuffer.clear();
+				var.writeValue(m_valueBuffer);
+				s3d::detail::AppendNetworkVar(buffer, var.m_id, m_valueBuffer);
+			}
+		};
+
+		inline NetworkVarBase::~NetworkVarBase()
+		{
+			if (m_registry)
+			{
+				m_registry->remove(*this);
+			}
+		}
+
+		inline void NetworkVarBase::markDirty()
+		{
+			if (m_dirty)
+			{
+				return;
+			}
+
+			m_dirty = true;
+
+			if (m_registry)
+			{
+				m_registry->m_dirty << this;
+			}
+		}
+
+		/// @brief マッチメイキングに使うルームのプロパティの値
+		/// @remark サーバが比較できるよう、パック形式ではなく整数または文字列のまま送信します。
+		using MatchmakingValue = std::variant<int32, String>;
+
+		/// @brief マッチメイキングに使うルームのプロパティの表
+		using MatchmakingProperties = HashTable<String, MatchmakingValue>;
+
+		/// @brief ランダムなルームへの参加で、条件に合うルームから参加先を選ぶ方法
+		enum class MatchmakingMode : uint8
+		{
+			/// @brief 古いルームから順に、満員になるまで詰める
+			FillRoom,
+
+			/// @brief 参加のたびに次のルームへ順番に振り分ける
+			SerialMatching,
+
+			/// @brief ランダムに選ぶ
+			RandomMatching,
+		};
+
+		/// @brief ロビーの種類
+		enum class LobbyType : uint8
+		{
+			/// @brief マッチメイキング用のプロパティの一致で絞り込むロビー
+			Default,
+
+			/// @brief SQL の条件式で絞り込むロビー
+			/// @remark 条件式で参照できるのは、マッチメイキング用のプロパティのうち C0 から C9 という名前のものです。
+			SqlLobby,
+		};
+
+		/// @brief ルームを作成するときの設定
+		struct RoomCreateOptions
+		{
+			/// @brief ルームの最大人数 (0 の場合は制限なし)
+			int32 maxPlayers = 0;
+
+			/// @brief ロビーのルームの一覧に表示し、ランダムな参加の対象にするか
+			bool isVisible = true;
+
+			/// @brief 参加を受け付けるか
+			bool isOpen = true;
+
+			/// @brief マッチメイキング用のプロパティ
+			/// @remark すべてロビーに公開され、RoomInfo::matchmakingProperties で参照できます。
+			MatchmakingProperties matchmakingProperties;
+
+			/// @brief ルームを作成するロビーの名前 (空の場合は既定のロビー)
+			String lobbyName;
+
+			LobbyType lobbyType = LobbyType::Default;
+		};
+
+		/// @brief ランダムなルームに参加するときの条件
+		struct MatchmakingOptions
+		{
+			/// @brief ルームの最大人数 (0 の場合は問わない)
+			int32 maxPlayers = 0;
+
+			/// @brief ルームのマッチメイキング用のプロパティに期待する値
+			/// @remark すべてのキーで値が一致するルームのみが候補になります。
+			MatchmakingProperties expectedProperties;
+
+			MatchmakingMode mode = MatchmakingMode::FillRoom;
+
+			/// @brief 参加先を探すロビーの名前 (空の場合は既定のロビー)
+			String lobbyName;
+
+			LobbyType lobbyType = LobbyType::Default;
+
+			/// @brief SQL ロビーの条件式 (例: U"C0 = 1 AND C1 > 10")
+			/// @remark lobbyType が LobbyType::SqlLobby の場合のみ使われます。
+			String sqlFilter;
+		};
+
+		/// @brief ロビーのルームの一覧の項目
+		struct RoomInfo
+		{
+			String name;
+
+			/// @brief 参加しているプレイヤーの人数
+			int32 playerCount = 0;
+
+			int32 maxPlayers = 0;
+
+			bool isOpen = true;
+
+			/// @brief ロビーに公開されたカスタムプロパティ (キーと、型を表す ID に続くパック形式の値)
+			/// @remark SivPhoton::setRoomPropertiesListedInLobby() で指定したキーのみが含まれます。
+			s3d::detail::PropertyTable properties;
+
+			/// @brief マッチメイキング用のプロパティ
+			MatchmakingProperties matchmakingProperties;
+
+			/// @brief ロビーに公開されたカスタムプロパティを返します。
+			/// @tparam Type 設定したときと同じ値の型
+			/// @param key キー
+			/// @return 値, 公開されていない場合や型が一致しない場合は none
+			/// @remark 値に付いた型を表す ID で型を確認します。型 ID を持たない serialize() の型は、サイズが同じ別の型と区別できません。
+			template <Serializable Type>
+			[[nodiscard]]
+			Optional<Type> getProperty(const StringView key) const
+			{
+				const auto it = properties.find(String{ key });
+
+				if (it == properties.end())
+				{
+					return none;
+				}
+
+				return s3d::detail::ReadProperty<Type>(it->second);
+			}
+		};
+
+		/// @brief プロセス内で複数の SivPhoton をつなぐ、ループバックの仮想サーバ
+		/// @remark ルームの作成・参加・退室、マスタークライアントの割り当て、イベントの配送を、Photon のサーバの代わりにメモリ上で行います。
+		class LoopbackNetwork;
+
+		/// @brief ループバックの仮想サーバを作成します。
+		/// @return 作成した仮想サーバ
+		[[nodiscard]]
+		std::shared_ptr<LoopbackNetwork> CreateLoopbackNetwork();
 	}
 
 	class SivPhoton
@@ -38,6 +2578,11 @@ namespace s3d
 		/// @remark アプリケーションバージョンが異なる SivPhoton とは通信できません。
 		SivPhoton(StringView secretPhotonAppID, StringView photonAppVersion);
 
+		/// @brief Photon のサーバの代わりに、ループバックの仮想サーバに接続する SivPhoton を作成します。
+		/// @param network 接続する仮想サーバ
+		/// @remark 同じ仮想サーバに接続した SivPhoton どうしは、ネットワークを使わずに通信します。すべてのイベントをパック形式で送信します。
+		explicit SivPhoton(const std::shared_ptr<NetworkSystem::LoopbackNetwork>& network);
+
 		virtual ~SivPhoton();
 
 		/// @brief Photon サーバへの接続を試みます。
@@ -47,56 +2592,267 @@ namespace s3d
 		void disconnect();
 
 		/// @brief サーバーといい感じにします。
-		/// @remark 6 秒間以上この関数を呼ばないと自動的に切断されます。
+		/// @remark 6 秒間以上この関数を呼ばないと自動的に切断されます。ネットワークスレッドを使う場合は、受信したコールバックを呼ぶだけで、通信は止まりません。
 		void update();
 
+		/// @brief サーバとの通信 (Client::service()) を専用のスレッドで行うかを設定します。
+		/// @param enabled ネットワークスレッドを使う場合 true
+		/// @param interval ネットワークスレッドが通信する間隔
+		/// @remark ネットワークスレッドを使うと、メインスレッドが長時間止まっても接続が維持されます。
+		/// 送信するイベントと受信したイベントはロックフリーのキューでスレッド間を受け渡し、コールバックは update() の中でメインスレッドから呼ばれます。
+		/// @remark ネットワークスレッドを使う間は、すべてのイベントをパック形式で送信します。
+		void setNetworkThread(bool enabled, const Duration& interval = Duration{ 0.005 });
+
+		/// @brief ネットワークスレッドを使うかを返します。
+		/// @return ネットワークスレッドを使う場合 true, それ以外の場合は false
+		[[nodiscard]]
+		bool getNetworkThread() const noexcept;
+
+		/// @brief 受信したコールバックとイベントを保留するかを設定します。
+		/// @param hold 保留する場合 true
+		/// @remark 保留している間も update() は通信を続けます。保留を解除すると、次の update() で保留していたものを受信した順に呼びます。
+		void setHoldCallbacks(bool hold);
+
+		/// @brief 受信したコールバックとイベントを保留しているかを返します。
+		/// @return 保留している場合 true, それ以外の場合は false
+		[[nodiscard]]
+		bool getHoldCallbacks() const noexcept;
+
+		/// @brief 受信したコマンドを処理し、コールバックを呼びます。
+		/// @remark update() のうち受信側の処理のみを行います。受信と送信の頻度を分ける場合に sendOutgoingCommands() と組み合わせて使います。
+		void dispatchIncomingCommands();
+
+		/// @brief まとめて送信するイベントと、送信待ちのコマンドを送信します。
+		/// @remark update() のうち送信側の処理のみを行います。
+		void sendOutgoingCommands();
+
+		/// @brief 通信の頻度を設定します。
+		/// @param rate 通信の頻度
+		/// @remark SivPhotonSceneMaster は、フレームレートにかかわらずこの頻度で dispatchIncomingCommands() と sendOutgoingCommands() を呼びます。
+		void setTickRate(const NetworkSystem::TickRate& rate) noexcept;
+
+		/// @brief 通信の頻度を返します。
+		/// @return 通信の頻度
+		[[nodiscard]]
+		const NetworkSystem::TickRate& getTickRate() const noexcept;
+
+		/// @brief 通信の統計を取得します。
+		/// @return 通信の統計
+		[[nodiscard]]
+		NetworkSystem::NetworkStats getNetworkStats() const;
+
+		/// @brief 通信の統計を 0 に戻します。
+		void resetNetworkStats();
+
 		/// @brief ルーム
 		/// @param maxPlayers ルームの最大人数
 		/// @remark 最大 255, 無料の Photon アカウントの場合は 20
 		void opJoinRandomRoom(int32 maxPlayers);
 
+		/// @brief 条件に合うルームからひとつを選んで参加します。
+		/// @param options マッチメイキングの条件
+		/// @remark 結果は joinRandomRoomReturn() で通知されます。
+		void opJoinRandomRoom(const NetworkSystem::MatchmakingOptions& options);
+
+		/// @brief 条件に合うルームからひとつを選んで参加し、見つからない場合はルームを作成して参加します。
+		/// @param options マッチメイキングの条件
+		/// @param roomName 作成するルームの名前 (空の場合はサーバが名前を付ける)
+		/// @param createOptions 作成するルームの設定
+		/// @remark 検索と作成を 1 回の通信で行います。結果は参加と作成のどちらの場合も joinRandomRoomReturn() で通知されます。
+		void opJoinRandomOrCreateRoom(const NetworkSystem::MatchmakingOptions& options, StringView roomName, const NetworkSystem::RoomCreateOptions& createOptions);
+
 		void opJoinRoom(StringView roomName, bool rejoin = false);
 
 		void opCreateRoom(StringView roomName, int32 maxPlayers);
 
+		/// @brief ルームを作成して参加します。
+		/// @param roomName ルームの名前 (空の場合はサーバが名前を付ける)
+		/// @param options ルームの設定
+		void opCreateRoom(StringView roomName, const NetworkSystem::RoomCreateOptions& options);
+
 		void opLeaveRoom();
 
-		template <class T>
-		void opRaiseEvent(uint8 eventCode, const T& value);
+		/// @brief インタレストグループの購読を変更します。
+		/// @param groupsToRemove 購読をやめるグループ
+		/// @param groupsToAdd 購読するグループ
+		/// @remark グループ 0 は無視されます。ルームを退室すると購読はすべて解除されます。
+		void opChangeGroups(const Array<uint8>& groupsToRemove, const Array<uint8>& groupsToAdd);
+
+		/// @brief 購読するインタレストグループを設定します。
+		/// @param groups 購読するグループの一覧
+		/// @remark 現在の購読との差分のみを送信します。変化がない場合は何もしないため、毎フレーム呼んでも構いません。
+		void setInterestGroups(const Array<uint8>& groups);
+
+		/// @brief すべてのインタレストグループの購読をやめます。
+		void clearInterestGroups();
+
+		/// @brief 購読しているインタレストグループの一覧を返します。
+		/// @return 購読しているグループの一覧
+		[[nodiscard]]
+		Array<uint8> getInterestGroups() const;
+
+		/// @brief ユーザ定義型のイベントを送信します。
+		/// @tparam Type NetworkSystem::CustomType を満たす型
+		/// @remark 受信側では customEventAction(int32, int32, const NetworkSystem::SerializedValue&) が呼ばれます。
+		/// @remark String や文字列リテラルなど StringView に変換できる型は、文字列として送信します。
+		template <class Type>
+			requires ((NetworkSystem::CustomType<Type> || std::is_convertible_v<const Type&, StringView>)
+				&& (not std::is_arithmetic_v<Type>))
+		void opRaiseEvent(uint8 eventCode, const Type& value, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const int32 value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const int32 value);
+		void opRaiseEvent(uint8 eventCode, const double value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const double value);
+		void opRaiseEvent(uint8 eventCode, const float value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const float value);
+		void opRaiseEvent(uint8 eventCode, const bool value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const bool value);
+		void opRaiseEvent(uint8 eventCode, const StringView value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const StringView value);
+		void opRaiseEvent(uint8 eventCode, const Array<int32>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<int32>& value);
+		void opRaiseEvent(uint8 eventCode, const Array<double>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<double>& value);
+		void opRaiseEvent(uint8 eventCode, const Array<float>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<float>& value);
+		void opRaiseEvent(uint8 eventCode, const Array<bool>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<bool>& value);
+		void opRaiseEvent(uint8 eventCode, const Array<String>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<String>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<int32>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<int32>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<double>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<double>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<float>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<float>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<bool>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<bool>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<String>& value, const NetworkSystem::SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<String>& value);
+		void opRaiseEvent(uint8 eventCode, const Point& value, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Vec2& value, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Rect& value, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Circle& value, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Array<Point>& values, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Array<Vec2>& values, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Array<Rect>& values, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Array<Circle>& values, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Grid<Point>& values, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Grid<Vec2>& values, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Grid<Rect>& values, const NetworkSystem::SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const Grid<Circle>& values, const NetworkSystem::SendOptions& options = {});
 
 		//template <class Type>
 		//void opRaiseEvent(uint8 eventCode, const HashTable<uint8, Type>& parameters);
 
+		/// @brief Array, Grid のイベントを送信するときのデータ形式を設定します。
+		/// @param encoding データ形式
+		/// @remark 受信側はどちらの形式でも受け取れます。パック形式では String も UTF-8 で送信し、
+		/// 信頼性のある送信で繰り返し現れる文字列は、ルームごとの文字列表の ID で送信します。
+		void setArrayEncoding(NetworkSystem::ArrayEncoding encoding) noexcept;
+
+		/// @brief Array, Grid のイベントを送信するときのデータ形式を返します。
+		/// @return データ形式
+		[[nodiscard]]
+		NetworkSystem::ArrayEncoding getArrayEncoding() const noexcept;
+
+		/// @brief 指定したイベントコードで送受信する Vec2, Circle (および Array, Grid) の量子化を設定します。
+		/// @param eventCode イベントコード
+		/// @param profile 量子化の設定
+		/// @remark 送信側と受信側で同じ設定をする必要があります。固定小数点数の範囲が異なる場合は正しく復元できません。
+		void setQuantizationProfile(uint8 eventCode, const NetworkSystem::QuantizationProfile& profile) noexcept;
+
+		/// @brief 指定したイベントコードの量子化の設定を返します。
+		/// @param eventCode イベントコード
+		/// @return 量子化の設定
+		[[nodiscard]]
+		const NetworkSystem::QuantizationProfile& getQuantizationProfile(uint8 eventCode) const noexcept;
+
+		/// @brief 1 フレームに送信するイベントをまとめて送信するかを設定します。
+		/// @param enabled まとめて送信する場合 true
+		/// @remark 有効な場合、opRaiseEvent で送信したイベントは update() でひとつの操作としてまとめて送信されます。
+		/// @remark 受信側では送信した順に customEventAction が呼ばれます。Array, Grid は常にパック形式で送信されます。
+		/// @remark 信頼性のある送信とない送信は別々にまとめます。送信先やキャッシュの扱いが直前のイベントと異なる場合は、それまでにまとめたイベントを先に送信します。
+		void setEventBatching(bool enabled);
+
+		/// @brief 1 フレームに送信するイベントをまとめて送信するかを返します。
+		/// @return まとめて送信する場合 true, それ以外の場合は false
+		[[nodiscard]]
+		bool getEventBatching() const noexcept;
+
+		/// @brief 受信したイベントを受信キューに溜め、dispatchReceivedEvents() で処理するかを設定します。
+		/// @param enabled 受信キューを使う場合 true, 受信時にその場で処理する場合 false
+		/// @param capacity キューに溜めるイベントの最大数
+		/// @param byteCapacity キューに溜めるイベントの最大バイト数
+		/// @remark キューは設定時に確保し、受信時には確保しません。キューに収まらないイベントは、古いイベントから順にその場で処理して空きを作ります。
+		/// byteCapacity より大きいイベントは、キューのイベントをすべて処理してからその場で処理します。
+		/// @remark ルームへの参加・退室の通知の前には、それまでにキューに溜めたイベントをすべて処理します。
+		/// @remark 無効にすると、キューに残っているイベントをすべて処理します。SivPhotonSceneMaster は updateScene() の中で処理します。
+		void setReceiveQueue(bool enabled, size_t capacity = 1024, size_t byteCapacity = (256 * 1024));
+
+		/// @brief 受信キューを使うかを返します。
+		/// @return 受信キューを使う場合 true, それ以外の場合は false
+		[[nodiscard]]
+		bool getReceiveQueue() const noexcept;
+
+		/// @brief 受信キューに溜めたイベントを、古いものから順に処理します。
+		/// @param budget 処理する量の上限
+		/// @return 処理したイベントの数
+		size_t dispatchReceivedEvents(const NetworkSystem::ReceiveBudget& budget = {});
+
+		/// @brief 受信キューの統計を返します。
+		/// @return 受信キューの統計
+		[[nodiscard]]
+		NetworkSystem::ReceiveQueueStats getReceiveQueueStats() const;
+
+		/// @brief 指定したイベントコードで受信したイベントを受け取るハンドラを登録します。
+		/// @tparam Handler メンバ関数 void (Object::*)(int32 playerID, Argument eventContent)
+		/// @param eventCode イベントコード
+		/// @param object Handler を呼ぶオブジェクト
+		/// @remark 受信したイベントの型が Argument と一致する場合、customEventAction の代わりに Handler が呼ばれます。
+		/// Argument には customEventAction が受け取る型または Serializable なユーザ定義型を指定できます。
+		/// @remark object を破棄する前に removeEventHandlers(object) で登録を解除する必要があります。
+		template <auto Handler, class Object>
+		void setEventHandler(uint8 eventCode, Object* object) noexcept
+		{
+			m_eventHandlers.set<Handler>(eventCode, object);
+		}
+
+		/// @brief 指定したイベントコードのハンドラの登録を解除します。
+		/// @param eventCode イベントコード
+		void removeEventHandler(uint8 eventCode) noexcept;
+
+		/// @brief 指定したオブジェクトのハンドラの登録をすべて解除します。
+		/// @param object setEventHandler() に渡したオブジェクト
+		void removeEventHandlers(const void* object) noexcept;
+
+		/// @brief 指定したイベントコードで送信する Grid を、前回送信した Grid からの差分で送信するように設定します。
+		/// @param eventCode イベントコード
+		/// @param enabled 差分で送信する場合 true
+		/// @remark 受信側は前回受信した Grid に差分を適用して全体を復元してから customEventAction を呼びます。
+		/// @remark ルームに誰かが参加したときや、受信側が差分を適用できなかったときは全体 (キーフレーム) を送信します。
+		/// キーフレームは、最後に送信した差分と同じ送信チャンネルと信頼性で、必要なプレイヤーにのみ送信します。
+		/// @remark Grid<String> は対象外です。量子化の設定より優先されます。
+		void setGridReplication(uint8 eventCode, bool enabled);
+
+		/// @brief 指定したイベントコードで送信する Grid を差分で送信するかを返します。
+		/// @param eventCode イベントコード
+		/// @return 差分で送信する場合 true, それ以外の場合は false
+		[[nodiscard]]
+		bool getGridReplication(uint8 eventCode) const noexcept;
+
 		/// @brief サーバに接続したときのユーザ名を返します。
 		/// @return ユーザ名
 		[[nodiscard]]
@@ -113,6 +2869,22 @@ namespace s3d
 		[[nodiscard]]
 		Array<String> getRoomNameList() const;
 
+		/// @brief ロビーのルームの一覧を返します。
+		/// @return ルームの一覧
+		/// @remark サーバからルームの一覧の変更が通知されたときのみ更新されるキャッシュを返すため、毎フレーム呼んでも通信や変換は発生しません。
+		/// ルームに参加している間は更新されません。
+		[[nodiscard]]
+		const Array<NetworkSystem::RoomInfo>& getRoomList() const noexcept;
+
+		/// @brief ルームの一覧が更新された回数を返します。
+		/// @remark 前回の値と比較して、一覧の表示を作り直すかを判断できます。
+		[[nodiscard]]
+		uint64 getRoomListVersion() const noexcept;
+
+		/// @brief 現在のルームで、ロビーのルームの一覧に公開するカスタムプロパティのキーを設定します。
+		/// @param keys 公開するキーの一覧
+		void setRoomPropertiesListedInLobby(const Array<String>& keys);
+
 		/// @brief 自分がルームに参加しているかを返します。
 		/// @return ルームに参加している場合 true, それ以外の場合は false
 		[[nodiscard]]
@@ -161,6 +2933,83 @@ namespace s3d
 		[[nodiscard]]
 		int32 getNumber() const;
 
+		/// @brief サーバ時刻を返します。
+		/// @return サーバ時刻 (ミリ秒)
+		/// @remark connect() で取得したサーバとの時刻のずれから推定します。32 ビットで一周するため、比較は差で行ってください。
+		[[nodiscard]]
+		int32 getServerTime() const;
+
+		/// @brief NetworkVar を登録し、他のクライアントと同期します。
+		/// @param var NetworkVar
+		/// @remark NetworkVar の破棄時に登録は解除されます。同じ ID の NetworkVar が登録されている場合は置き換えます。
+		void registerNetworkVar(NetworkSystem::NetworkVarBase& var);
+
+		/// @brief NetworkVar の登録を解除します。
+		/// @param var NetworkVar
+		void unregisterNetworkVar(NetworkSystem::NetworkVarBase& var);
+
+		/// @brief 現在のルームのカスタムプロパティを設定します。
+		/// @param key キー
+		/// @param value 値
+		/// @remark 変更したキーのみを送信し、ローカルのキャッシュには直ちに反映します。後からルームに参加したプレイヤーにも共有されます。
+		template <class Type>
+			requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setRoomProperty(StringView key, const Type& value);
+
+		/// @brief 現在のルームのカスタムプロパティを、現在の値が expectedValue と等しい場合のみ設定します。
+		/// @param key キー
+		/// @param value 値
+		/// @param expectedValue サーバでの現在の値の期待値
+		/// @remark 設定の成否はサーバが判定するため、ローカルのキャッシュは roomPropertiesChanged() の通知で反映します。
+		template <class Type>
+			requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setRoomProperty(StringView key, const Type& value, const Type& expectedValue);
+
+		/// @brief 現在のルームのカスタムプロパティをローカルのキャッシュから返します。
+		/// @tparam Type 設定したときと同じ値の型
+		/// @param key キー
+		/// @return 値, 設定されていない場合や型が一致しない場合は none
+		/// @remark 値に付いた型を表す ID で型を確認します。型 ID を持たない serialize() の型は、サイズが同じ別の型と区別できません。
+		template <NetworkSystem::Serializable Type>
+		[[nodiscard]]
+		Optional<Type> getRoomProperty(StringView key) const;
+
+		/// @brief 現在のルームのカスタムプロパティのキーの一覧を返します。
+		[[nodiscard]]
+		Array<String> getRoomPropertyKeys() const;
+
+		/// @brief 自分のカスタムプロパティを設定します。
+		/// @param key キー
+		/// @param value 値
+		/// @remark 変更したキーのみを送信し、ローカルのキャッシュには直ちに反映します。
+		template <class Type>
+			requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setPlayerProperty(StringView key, const Type& value);
+
+		/// @brief 自分のカスタムプロパティを、現在の値が expectedValue と等しい場合のみ設定します。
+		/// @param key キー
+		/// @param value 値
+		/// @param expectedValue サーバでの現在の値の期待値
+		/// @remark ローカルのキャッシュは playerPropertiesChanged() の通知で反映します。
+		template <class Type>
+			requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setPlayerProperty(StringView key, const Type& value, const Type& expectedValue);
+
+		/// @brief プレイヤーのカスタムプロパティをローカルのキャッシュから返します。
+		/// @tparam Type 設定したときと同じ値の型
+		/// @param playerID プレイヤーの ID
+		/// @param key キー
+		/// @return 値, 設定されていない場合や型が一致しない場合は none
+		/// @remark 値に付いた型を表す ID で型を確認します。型 ID を持たない serialize() の型は、サイズが同じ別の型と区別できません。
+		template <NetworkSystem::Serializable Type>
+		[[nodiscard]]
+		Optional<Type> getPlayerProperty(int32 playerID, StringView key) const;
+
+		/// @brief プレイヤーのカスタムプロパティのキーの一覧を返します。
+		/// @param playerID プレイヤーの ID
+		[[nodiscard]]
+		Array<String> getPlayerPropertyKeys(int32 playerID) const;
+
 		[[nodiscard]]
 		bool isUsePhoton() const noexcept;
 
@@ -182,6 +3031,20 @@ namespace s3d
 
 		virtual void createRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString);
 
+		/// @brief ルームのカスタムプロパティが変更されたときに呼ばれます。
+		/// @param keys 変更されたキーの一覧
+		/// @remark ルームに参加したときは、設定済みのすべてのキーで呼ばれます。
+		virtual void roomPropertiesChanged(const Array<String>& keys);
+
+		/// @brief プレイヤーのカスタムプロパティが変更されたときに呼ばれます。
+		/// @param playerID プレイヤーの ID
+		/// @param keys 変更されたキーの一覧
+		virtual void playerPropertiesChanged(int32 playerID, const Array<String>& keys);
+
+		/// @brief ロビーのルームの一覧が更新されたときに呼ばれます。
+		/// @remark getRoomList() で更新後の一覧を取得できます。
+		virtual void roomListUpdated();
+
 		virtual void customEventAction(int32 playerID, int32 eventCode, const int32 eventContent);
 
 		virtual void customEventAction(int32 playerID, int32 eventCode, const double eventContent);
@@ -236,6 +3099,49 @@ namespace s3d
 
 		virtual void customEventAction(int32 playerID, int32 eventCode, const Grid<Circle>& eventContent);
 
+		// 以下の std::span, GridView を受け取る customEventAction には、受信したバッファをコピーせずに参照するビューが渡されます。
+		// ビューはこの関数の呼び出し中のみ有効です。既定の実装は Array, Grid にコピーして対応する customEventAction を呼びます。
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const int32> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const double> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const float> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const bool> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const Point> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const Vec2> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const Rect> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const Circle> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<int32>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<double>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<float>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<bool>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<Point>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<Vec2>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<Rect>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<Circle>& eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, std::span<const StringView> eventContent);
+
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::GridView<StringView>& eventContent);
+
+		/// @brief ユーザ定義型のイベントを受信したときに呼ばれます。
+		/// @param eventContent 受信したイベント。eventContent.get<Type>() で値を復元します。
+		virtual void customEventAction(int32 playerID, int32 eventCode, const NetworkSystem::SerializedValue& eventContent);
+
 	protected:
 
 		String m_defaultRoomName;
@@ -248,11 +3154,307 @@ namespace s3d
 
 		std::unique_ptr<ExitGames::LoadBalancing::Client> m_client;
 
+		class Transport;
+
+		class PhotonTransport;
+
+		class LoopbackTransport;
+
+		/// @brief サーバとの通信 (Photon またはループバック)
+		/// @remark 旧形式のイベントの送信のみ、m_client を直接使います。
+		std::unique_ptr<Transport> m_transport;
+
 		bool m_isUsePhoton = false;
 
+		NetworkSystem::ArrayEncoding m_arrayEncoding = NetworkSystem::ArrayEncoding::Packed;
+
+		/// @brief パック形式のイベントを組み立てるための使い回しのバッファ
+		Array<uint8> m_sendBuffer;
+
+		/// @brief 文字列表に登録した文字列
+		struct InternedString
+		{
+			String value;
+
+			/// @brief 最後に登録を送信したチャンネル
+			uint8 channel = 0;
+		};
+
+		/// @brief 文字列表に登録した文字列 (ID 順)
+		/// @remark ルームにいる間は追加のみ行い、ID を使い回しません。
+		Array<InternedString> m_internedStrings;
+
+		/// @brief 文字列のハッシュ値から文字列表の ID への対応
+		HashTable<uint64, uint32> m_internedStringIDs;
+
+		/// @brief 文字列の並びをパック形式で m_sendBuffer に書き込みます。
+		/// @remark 文字列表を使える送信方法の場合、繰り返し現れる文字列は ID で書き込みます。
+		template <class StringType>
+		void writeStrings(detail::WireContainer container, Size size, const StringType* values, size_t count, const NetworkSystem::SendOptions& options);
+
+		/// @brief 文字列表の登録をすべて指定したプレイヤーに送信します。
+		/// @param playerID ルームに参加したプレイヤーの ID
+		/// @remark 参加した人は、それまでの登録を受け取っていません。参加の通知を処理するより前に送信した参照も解決できるよう、表をそのまま送ります。
+		void raiseStringTable(int32 playerID);
+
+		/// @brief 文字列表を空にします。以降に送信する文字列はすべて登録し直します。
+		/// @remark 自分がルームに参加したときに呼びます。まとめて送信する途中のイベントは先に送信します。
+		void resetStringTable();
+
+		/// @brief 1 フレームに送信するイベントをまとめて送信するか
+		bool m_eventBatching = false;
+
+		NetworkSystem::TickRate m_tickRate;
+
+		/// @brief イベントコードごとの送信量
+		std::array<NetworkSystem::EventTraffic, 256> m_sentEventTraffic{};
+
+		/// @brief イベントコードごとのイベントハンドラ
+		NetworkSystem::EventHandlerTable m_eventHandlers;
+
+		/// @brief まとめて送信するイベント
+		struct EventBatch
+		{
+			Array<uint8> bytes;
+
+			/// @brief まとめたイベントの送信方法
+			NetworkSystem::SendOptions options;
+		};
+
+		/// @brief まとめて送信するイベント (信頼性のない送信, 信頼性のある送信)
+		std::array<EventBatch, 2> m_eventBatches;
+
+		/// @brief Array, Grid をパック形式で送信するかを返します。
+		[[nodiscard]]
+		bool isPackedEncoding() const noexcept;
+
+		/// @brief 単一の値をパック形式で送信するかを返します。
+		[[nodiscard]]
+		bool isPackedValueEncoding() const noexcept;
+
+		/// @brief イベントコードごとの送信量に加算します。
+		void recordSentEvent(uint8 eventCode, size_t size) noexcept;
+
+		/// @brief パック形式のイベントを送信します。ネットワークスレッドを使う場合は送信キューに入れます。
+		void sendPackedEvent(uint8 eventCode, const Array<uint8>& bytes, const NetworkSystem::SendOptions& options);
+
+		/// @brief ネットワークスレッドを使う場合、m_client を操作する間ネットワークスレッドを止めるロックを返します。
+		[[nodiscard]]
+		std::unique_lock<std::recursive_mutex> lockClient() const;
+
+		/// @brief m_sendBuffer に書き込んだパック形式のイベントを送信します。
+		/// @param eventCode イベントコード
+		/// @param options 送信方法
+		/// @remark イベントをまとめて送信する場合は、送信せずにまとめるイベントに追加します。
+		void raisePackedEvent(uint8 eventCode, const NetworkSystem::SendOptions& options);
+
+		/// @brief まとめたイベントを送信します。
+		void flushEventBatches();
+
+		/// @brief 購読しているインタレストグループ
+		std::bitset<256> m_interestGroups;
+
+		/// @brief インタレストグループの購読を変更します。
+		void changeGroups(std::bitset<256> groupsToRemove, std::bitset<256> groupsToAdd);
+
+		/// @brief 量子化の設定 (イベントコードごと)
+		std::array<NetworkSystem::QuantizationProfile, 256> m_quantizationProfiles;
+
+		/// @brief Grid の差分送信の送信側の状態
+		struct GridReplication
+		{
+			bool enabled = false;
+
+			/// @brief 最後に送信した Grid の要素の型 (detail::WireElement の値), 未送信の場合は 0
+			uint8 element = 0;
+
+			/// @brief 最後に送信した通し番号
+			uint32 sequence = 0;
+
+			Size size{ 0, 0 };
+
+			/// @brief 最後に送信した Grid の全セルの要素の並び
+			Array<uint8> cells;
+
+			/// @brief 最後に送信したときの送信チャンネル (キーフレームとその再送要求にも使う)
+			uint8 channel = 0;
+
+			/// @brief 最後に送信したときに信頼性のある送信をしたか (キーフレームとその再送要求にも使う)
+			bool reliable = true;
+		};
+
+		/// @brief Grid の差分送信の送信側の状態 (イベントコードごと)
+		std::array<GridReplication, 256> m_gridReplications;
+
+		/// @brief Grid を前回送信した Grid からの差分で送信します。
+		template <class Type>
+		void raiseGridReplication(uint8 eventCode, const Grid<Type>& values, const NetworkSystem::SendOptions& options);
+
+		/// @brief 差分送信中の Grid の全体 (キーフレーム) を指定したプレイヤーに送信します。
+		/// @param eventCode イベントコード
+		/// @param playerID キーフレームを送信するプレイヤーの ID
+		/// @remark 通し番号は進めないため、他のプレイヤーへの差分の送信には影響しません。
+		void raiseGridKeyframe(uint8 eventCode, int32 playerID);
+
+		/// @brief 差分送信中のすべての Grid のキーフレームを指定したプレイヤーに送信します。
+		/// @param playerID キーフレームを送信するプレイヤーの ID
+		void raiseGridKeyframes(int32 playerID);
+
+		/// @brief キーフレームの再送を要求します。
+		/// @param eventCode イベントコード
+		/// @param playerID キーフレームを再送してほしいプレイヤーの ID
+		void raiseKeyframeRequest(uint8 eventCode, int32 playerID);
+
+		/// @brief 差分送信の前回の送信内容を破棄し、次回の送信をキーフレームにします。
+		void resetGridReplications();
+
+		/// @brief 登録された NetworkVar
+		NetworkSystem::NetworkVarRegistry m_networkVars;
+
+		/// @brief 変更された NetworkVar の値をまとめて送信します。
+		void flushNetworkVars();
+
+		/// @brief すべての NetworkVar の値を指定したプレイヤーに送信します。
+		/// @param playerID ルームに参加したプレイヤーの ID
+		/// @remark マスタークライアントのみが送信します。
+		void raiseNetworkVarSnapshot(int32 playerID);
+
+		/// @brief 受信した NetworkVars を、登録された NetworkVar に反映します。
+		void receivedNetworkVars(s3d::detail::WireNetworkVars vars);
+
+		/// @brief 現在のルームのカスタムプロパティのキャッシュ
+		detail::PropertyTable m_roomProperties;
+
+		/// @brief ルームのプレイヤーのカスタムプロパティのキャッシュ (プレイヤー ID ごと)
+		HashTable<int32, detail::PropertyTable> m_playerProperties;
+
+		/// @brief 値をカスタムプロパティの形式 (型を表す ID とパック形式) に変換します。
+		template <class Type>
+		[[nodiscard]]
+		static Array<uint8> PackProperty(const Type& value);
+
+		void setRoomPropertyBytes(StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue);
+
+		void setPlayerPropertyBytes(StringView key, const Array<uint8>& value, const Array<uint8>* expectedValue);
+
+		/// @brief ルームに参加したときに、カスタムプロパティのキャッシュを置き換えます。
+		void joinedRoomProperties(const detail::PropertyTable& roomProperties, const HashTable<int32, detail::PropertyTable>& playerProperties);
+
+		/// @brief 受信したルームのカスタムプロパティの変更をキャッシュに反映します。
+		void updateRoomProperties(const detail::PropertyTable& changes);
+
+		/// @brief 受信したプレイヤーのカスタムプロパティの変更をキャッシュに反映します。
+		void updatePlayerProperties(int32 playerID, const detail::PropertyTable& changes);
+
+		/// @brief カスタムプロパティのキャッシュを空にします。
+		void clearProperties();
+
+		/// @brief ロビーのルームの一覧のキャッシュ
+		Array<NetworkSystem::RoomInfo> m_roomList;
+
+		/// @brief m_roomList を更新した回数
+		uint64 m_roomListVersion = 0;
+
+		/// @brief 受信したルームの一覧でキャッシュを置き換え、roomListUpdated() を呼びます。
+		void updateRoomList(const Array<NetworkSystem::RoomInfo>& rooms);
+
 		/// @brief リスナーの参照を返します。
 		/// @return リスナーの参照
 		[[nodiscard]]
 		ExitGames::LoadBalancing::Client& getClient();
 	};
+
+	template <class Type>
+		requires ((NetworkSystem::CustomType<Type> || std::is_convertible_v<const Type&, StringView>)
+			&& (not std::is_arithmetic_v<Type>))
+	inline void SivPhoton::opRaiseEvent(const uint8 eventCode, const Type& value, const NetworkSystem::SendOptions& options)
+	{
+		if constexpr (std::is_convertible_v<const Type&, StringView>)
+		{
+			// 文字列リテラルが bool のオーバーロードに変換されないようにする
+			opRaiseEvent(eventCode, StringView{ value }, options);
+		}
+		else
+		{
+			detail::WriteCustomType(m_sendBuffer, NetworkSystem::CustomTypeID<Type>(), value);
+			raisePackedEvent(eventCode, options);
+		}
+	}
+
+	template <class Type>
+	inline Array<uint8> SivPhoton::PackProperty(const Type& value)
+	{
+		if constexpr (std::is_convertible_v<const Type&, StringView>)
+		{
+			// 文字列リテラルは文字の配列ではなく String として格納する
+			return detail::WriteProperty(String{ StringView{ value } });
+		}
+		else
+		{
+			return detail::WriteProperty(value);
+		}
+	}
+
+	template <class Type>
+		requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void SivPhoton::setRoomProperty(const StringView key, const Type& value)
+	{
+		setRoomPropertyBytes(key, PackProperty(value), nullptr);
+	}
+
+	template <class Type>
+		requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void SivPhoton::setRoomProperty(const StringView key, const Type& value, const Type& expectedValue)
+	{
+		const Array<uint8> expected = PackProperty(expectedValue);
+		setRoomPropertyBytes(key, PackProperty(value), &expected);
+	}
+
+	template <NetworkSystem::Serializable Type>
+	inline Optional<Type> SivPhoton::getRoomProperty(const StringView key) const
+	{
+		const auto it = m_roomProperties.find(String{ key });
+
+		if (it == m_roomProperties.end())
+		{
+			return none;
+		}
+
+		return detail::ReadProperty<Type>(it->second);
+	}
+
+	template <class Type>
+		requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void SivPhoton::setPlayerProperty(const StringView key, const Type& value)
+	{
+		setPlayerPropertyBytes(key, PackProperty(value), nullptr);
+	}
+
+	template <class Type>
+		requires (NetworkSystem::Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void SivPhoton::setPlayerProperty(const StringView key, const Type& value, const Type& expectedValue)
+	{
+		const Array<uint8> expected = PackProperty(expectedValue);
+		setPlayerPropertyBytes(key, PackProperty(value), &expected);
+	}
+
+	template <NetworkSystem::Serializable Type>
+	inline Optional<Type> SivPhoton::getPlayerProperty(const int32 playerID, const StringView key) const
+	{
+		const auto player = m_playerProperties.find(playerID);
+
+		if (player == m_playerProperties.end())
+		{
+			return none;
+		}
+
+		const auto it = player->second.find(String{ key });
+
+		if (it == player->second.end())
+		{
+			return none;
+		}
+
+		return detail::ReadProperty<Type>(it->second);
+	}
 }
@@ -0,0 +1,132 @@
+﻿
+# pragma once
+# include <Siv3D.hpp>
+
+// SivPhoton のログ
+//
+// SIVPHOTON_LOG(level, ...) で記録したログは、以下の 2 段階で絞り込みます。
+// - コンパイル時: SIVPHOTON_LOG_LEVEL より重要度の低いログは、引数の評価も含めてコードに残りません。
+// - 実行時: Log::SetLevel() で設定した重要度より低いログは、文字列を組み立てずに捨てます。
+//
+// 記録したログは固定長のリングバッファに残り、Log::GetRecent() で取り出せます。
+// Log::SetPrint() で画面への Print を、Log::OpenFile() でファイルへの書き出しを有効にできます。
+
+/// @brief コンパイル時に残すログの最低の重要度 (0: Trace, 1: Debug, 2: Info, 3: Warning, 4: Error, 5: None)
+/// @remark 定義しない場合、Debug ビルドではすべてのログを、Release ビルドでは Info 以上のログを残します。
+# ifndef SIVPHOTON_LOG_LEVEL
+#	if SIV3D_BUILD(DEBUG)
+#		define SIVPHOTON_LOG_LEVEL 0
+#	else
+#		define SIVPHOTON_LOG_LEVEL 2
+#	endif
+# endif
+
+/// @brief ログを記録します。
+/// @param level 重要度 (Trace, Debug, Info, Warning, Error)
+/// @param ... ログの内容 (Format() に渡す引数)
+# define SIVPHOTON_LOG(level, ...) \
+	do \
+	{ \
+		if constexpr (s3d::NetworkSystem::LogLevel::level >= s3d::NetworkSystem::CompiledLogLevel) \
+		{ \
+			if (s3d::NetworkSystem::Log::IsEnabled(s3d::NetworkSystem::LogLevel::level)) \
+			{ \
+				s3d::NetworkSystem::Log::Write(s3d::NetworkSystem::LogLevel::level, s3d::Format(__VA_ARGS__)); \
+			} \
+		} \
+	} while (false)
+
+namespace s3d
+{
+	namespace NetworkSystem
+	{
+		/// @brief ログの重要度
+		enum class LogLevel : uint8
+		{
+			/// @brief 送受信したイベントなど、毎フレーム発生する詳細
+			Trace,
+
+			Debug,
+
+			/// @brief 接続やルームへの参加など、通信の状態の変化
+			Info,
+
+			Warning,
+
+			Error,
+
+			/// @brief ログを記録しない
+			None,
+		};
+
+		/// @brief コンパイル時に残すログの最低の重要度
+		inline constexpr LogLevel CompiledLogLevel = LogLevel{ SIVPHOTON_LOG_LEVEL };
+
+		/// @brief 記録したログ
+		struct LogRecord
+		{
+			LogLevel level = LogLevel::Trace;
+
+			/// @brief 記録した時刻 (Time::GetMicrosec())
+			uint64 timeMicrosec = 0;
+
+			String message;
+		};
+
+		namespace Log
+		{
+			/// @brief リングバッファに残すログの数
+			inline constexpr size_t Capacity = 256;
+
+			/// @brief リングバッファに残すログ 1 つあたりの最大の文字数
+			/// @remark これより長いログは、リングバッファには切り詰めて残します。画面とファイルには切り詰めずに出力します。
+			inline constexpr size_t MaxMessageLength = 120;
+
+			/// @brief 記録するログの最低の重要度を設定します。
+			/// @param level 最低の重要度
+			/// @remark デフォルトは LogLevel::Info です。SIVPHOTON_LOG_LEVEL より低い重要度のログは、この設定にかかわらず記録されません。
+			void SetLevel(LogLevel level) noexcept;
+
+			/// @brief 記録するログの最低の重要度を返します。
+			/// @return 最低の重要度
+			[[nodiscard]]
+			LogLevel GetLevel() noexcept;
+
+			/// @brief 指定した重要度のログを記録するかを返します。
+			/// @param level 重要度
+			/// @return 記録する場合 true, それ以外の場合は false
+			[[nodiscard]]
+			bool IsEnabled(LogLevel level) noexcept;
+
+			/// @brief 記録したログを画面に Print するかを設定します。
+			/// @param enabled Print する場合 true
+			/// @remark デフォルトは true です。Print はメインスレッドから記録したログのみに行います。
+			void SetPrint(bool enabled) noexcept;
+
+			/// @brief 記録したログを画面に Print するかを返します。
+			/// @return Print する場合 true, それ以外の場合は false
+			[[nodiscard]]
+			bool GetPrint() noexcept;
+
+			/// @brief 記録したログをファイルにも書き出します。
+			/// @param path ファイルパス
+			/// @return ファイルを開けた場合 true, それ以外の場合は false
+			bool OpenFile(FilePathView path);
+
+			/// @brief ファイルへの書き出しを終了します。
+			void CloseFile();
+
+			/// @brief リングバッファに残っている最近のログを取得します。
+			/// @param count 取得するログの最大数
+			/// @return 古いものから順に並べたログ
+			[[nodiscard]]
+			Array<LogRecord> GetRecent(size_t count = Capacity);
+
+			/// @brief ログを記録します。
+			/// @param level 重要度
+			/// @param message ログの内容
+			/// @remark 通常は SIVPHOTON_LOG マクロを使います。
+			void Write(LogLevel level, StringView message);
+		}
+	}
+}
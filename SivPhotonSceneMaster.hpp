@@ -7,6 +7,16 @@ namespace s3d::NetworkSystem
 {
 	template <class State, class Data> class SivPhotonSceneMaster;
 
+	/// @brief クロスフェード中に受信したコールバックとイベントを渡すシーン
+	enum class CrossFadeEventTarget : uint8
+	{
+		/// @brief 次のシーンのみに渡す
+		Next,
+
+		/// @brief 現在のシーンと次のシーンの両方に渡す
+		Both,
+	};
+
 	/// @brief シーンのインタフェース
 	/// @tparam State シーンを区別するキーの型
 	/// @tparam Data シーン間で共有するデータの型
@@ -39,7 +49,7 @@ namespace s3d::NetworkSystem
 		SIV3D_NODISCARD_CXX20
 			explicit IScene(const InitData& init);
 
-		virtual ~IScene() = default;
+		virtual ~IScene();
 
 		/// @brief フェードイン時の更新処理です。
 		/// @param t フェードインの進度 [0.0, 1.0]
@@ -76,44 +86,124 @@ namespace s3d::NetworkSystem
 		/// @remark 最大 255, 無料の Photon アカウントの場合は 20
 		void opJoinRandomRoom(int32 maxPlayers);
 
+		/// @brief 条件に合うルームからひとつを選んで参加します。
+		/// @param options マッチメイキングの条件
+		void opJoinRandomRoom(const MatchmakingOptions& options);
+
+		/// @brief 条件に合うルームからひとつを選んで参加し、見つからない場合はルームを作成して参加します。
+		/// @param options マッチメイキングの条件
+		/// @param roomName 作成するルームの名前 (空の場合はサーバが名前を付ける)
+		/// @param createOptions 作成するルームの設定
+		/// @remark 結果は参加と作成のどちらの場合も joinRandomRoomReturn() で通知されます。
+		void opJoinRandomOrCreateRoom(const MatchmakingOptions& options, StringView roomName, const RoomCreateOptions& createOptions);
+
 		void opJoinRoom(StringView roomName, bool rejoin = false);
 
 		void opCreateRoom(StringView roomName, int32 maxPlayers);
 
+		/// @brief ルームを作成して参加します。
+		/// @param roomName ルームの名前 (空の場合はサーバが名前を付ける)
+		/// @param options ルームの設定
+		void opCreateRoom(StringView roomName, const RoomCreateOptions& options);
+
 		void opLeaveRoom();
 
+		/// @brief インタレストグループの購読を変更します。
+		/// @param groupsToRemove 購読をやめるグループ
+		/// @param groupsToAdd 購読するグループ
+		void opChangeGroups(const Array<uint8>& groupsToRemove, const Array<uint8>& groupsToAdd);
+
+		/// @brief 購読するインタレストグループを設定します。
+		/// @param groups 購読するグループの一覧
+		/// @remark 現在の購読との差分のみを送信します。
+		void setInterestGroups(const Array<uint8>& groups);
+
+		/// @brief すべてのインタレストグループの購読をやめます。
+		void clearInterestGroups();
+
+		/// @brief 購読しているインタレストグループの一覧を返します。
+		/// @return 購読しているグループの一覧
+		[[nodiscard]]
+		Array<uint8> getInterestGroups() const;
+
 		template <class T>
-		void opRaiseEvent(uint8 eventCode, const T& value);
+		void opRaiseEvent(uint8 eventCode, const T& value, const SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const int32 value, const SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const double value, const SendOptions& options = {});
+
+		void opRaiseEvent(uint8 eventCode, const float value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const int32 value);
+		void opRaiseEvent(uint8 eventCode, const bool value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const double value);
+		void opRaiseEvent(uint8 eventCode, const StringView value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const float value);
+		void opRaiseEvent(uint8 eventCode, const Array<int32>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const bool value);
+		void opRaiseEvent(uint8 eventCode, const Array<double>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const StringView value);
+		void opRaiseEvent(uint8 eventCode, const Array<float>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<int32>& value);
+		void opRaiseEvent(uint8 eventCode, const Array<bool>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<double>& value);
+		void opRaiseEvent(uint8 eventCode, const Array<String>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<float>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<int32>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<bool>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<double>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Array<String>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<float>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<int32>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<bool>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<double>& value);
+		void opRaiseEvent(uint8 eventCode, const Grid<String>& value, const SendOptions& options = {});
 
-		void opRaiseEvent(uint8 eventCode, const Grid<float>& value);
+		/// @brief 入力を予測した状態に適用し、マスタークライアントに送信します。
+		/// @param eventCode イベントコード
+		/// @param prediction クライアント側予測
+		/// @param input 入力
+		/// @param options 送信の設定
+		/// @remark マスタークライアントは Prediction::InputMessage を受信して状態を進め、Prediction::StateMessage を送り返します。
+		template <class Input, class PredictedState, size_t Capacity>
+		void opRaisePredictedInput(uint8 eventCode, Prediction<Input, PredictedState, Capacity>& prediction, const Input& input, const SendOptions& options = SendOptions::ToMasterClient());
 
-		void opRaiseEvent(uint8 eventCode, const Grid<bool>& value);
+		/// @brief 指定したイベントコードで送受信する Vec2, Circle (および Array, Grid) の量子化を設定します。
+		/// @param eventCode イベントコード
+		/// @param profile 量子化の設定
+		/// @remark 送信側と受信側で同じ設定をする必要があります。
+		void setQuantizationProfile(uint8 eventCode, const QuantizationProfile& profile);
 
-		void opRaiseEvent(uint8 eventCode, const Grid<String>& value);
+		/// @brief 指定したイベントコードで送信する Grid を、前回送信した Grid からの差分で送信するように設定します。
+		/// @param eventCode イベントコード
+		/// @param enabled 差分で送信する場合 true
+		void setGridReplication(uint8 eventCode, bool enabled);
+
+		/// @brief 1 フレームに送信するイベントをまとめて送信するかを設定します。
+		/// @param enabled まとめて送信する場合 true
+		void setEventBatching(bool enabled);
+
+		/// @brief 指定したイベントコードで受信したイベントを、このシーンのメンバ関数で受け取ります。
+		/// @tparam Handler このシーンのメンバ関数 void (SceneType::*)(int32 playerID, Argument eventContent)
+		/// @param eventCode イベントコード
+		/// @remark 受信したイベントの型が Argument と一致する場合、customEventAction の代わりに Handler が呼ばれます。登録はシーンの破棄時に解除されます。
+		template <auto Handler>
+		void setEventHandler(uint8 eventCode);
+
+		/// @brief 指定したイベントコードのハンドラの登録を解除します。
+		/// @param eventCode イベントコード
+		void removeEventHandler(uint8 eventCode);
+
+		/// @brief ロックステップを開始します。
+		/// @param eventCode 入力を送受信するイベントコード
+		/// @param lockstep ロックステップ
+		/// @param playerIDs 参加するプレイヤーの ID (すべてのクライアントで同じである必要があります)
+		/// @remark 以降、シーン管理クラスが毎フレーム Lockstep::update() を呼んで入力だけを送受信し、退室したプレイヤーの入力を待たないようにします。シーンの破棄時に停止します。
+		template <class Input, class LockstepState, size_t Capacity>
+		void startLockstep(uint8 eventCode, Lockstep<Input, LockstepState, Capacity>& lockstep, const Array<int32>& playerIDs);
+
+		/// @brief startLockstep() で開始したロックステップを停止します。
+		void stopLockstep();
 
 		/// @brief サーバに接続したときのユーザ名を返します。
 		/// @return ユーザ名
@@ -131,6 +221,20 @@ namespace s3d::NetworkSystem
 		[[nodiscard]]
 		Array<String> getRoomNameList() const;
 
+		/// @brief ロビーのルームの一覧を返します。
+		/// @return ルームの一覧
+		/// @remark サーバからルームの一覧の変更が通知されたときのみ更新されるキャッシュを返します。
+		[[nodiscard]]
+		const Array<RoomInfo>& getRoomList() const noexcept;
+
+		/// @brief ルームの一覧が更新された回数を返します。
+		[[nodiscard]]
+		uint64 getRoomListVersion() const noexcept;
+
+		/// @brief 現在のルームで、ロビーのルームの一覧に公開するカスタムプロパティのキーを設定します。
+		/// @param keys 公開するキーの一覧
+		void setRoomPropertiesListedInLobby(const Array<String>& keys);
+
 		/// @brief 自分がルームに参加しているかを返します。
 		/// @return ルームに参加している場合 true, それ以外の場合は false
 		[[nodiscard]]
@@ -179,6 +283,73 @@ namespace s3d::NetworkSystem
 		[[nodiscard]]
 		int32 getNumber() const;
 
+		/// @brief サーバ時刻を返します。
+		/// @return サーバ時刻 (ミリ秒)
+		/// @remark SnapshotBuffer に渡す値を送信するときに、NetworkSystem::TimestampedValue に付ける時刻に使います。
+		[[nodiscard]]
+		int32 getServerTime() const;
+
+		/// @brief NetworkVar を登録し、他のクライアントと同期します。
+		/// @param var NetworkVar
+		/// @remark NetworkVar の破棄時に登録は解除されるため、シーンのメンバの NetworkVar はシーンとともに解除されます。
+		void registerNetworkVar(NetworkVarBase& var);
+
+		/// @brief 現在のルームのカスタムプロパティを設定します。
+		/// @param key キー
+		/// @param value 値
+		template <class Type>
+			requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setRoomProperty(StringView key, const Type& value);
+
+		/// @brief 現在のルームのカスタムプロパティを、現在の値が expectedValue と等しい場合のみ設定します。
+		/// @param key キー
+		/// @param value 値
+		/// @param expectedValue サーバでの現在の値の期待値
+		template <class Type>
+			requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setRoomProperty(StringView key, const Type& value, const Type& expectedValue);
+
+		/// @brief 現在のルームのカスタムプロパティをローカルのキャッシュから返します。
+		/// @param key キー
+		/// @return 値, 設定されていない場合や型が一致しない場合は none
+		/// @remark 値に付いた型を表す ID で型を確認します。型 ID を持たない serialize() の型は、サイズが同じ別の型と区別できません。
+		template <Serializable Type>
+		[[nodiscard]]
+		Optional<Type> getRoomProperty(StringView key) const;
+
+		/// @brief 現在のルームのカスタムプロパティのキーの一覧を返します。
+		[[nodiscard]]
+		Array<String> getRoomPropertyKeys() const;
+
+		/// @brief 自分のカスタムプロパティを設定します。
+		/// @param key キー
+		/// @param value 値
+		template <class Type>
+			requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setPlayerProperty(StringView key, const Type& value);
+
+		/// @brief 自分のカスタムプロパティを、現在の値が expectedValue と等しい場合のみ設定します。
+		/// @param key キー
+		/// @param value 値
+		/// @param expectedValue サーバでの現在の値の期待値
+		template <class Type>
+			requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+		void setPlayerProperty(StringView key, const Type& value, const Type& expectedValue);
+
+		/// @brief プレイヤーのカスタムプロパティをローカルのキャッシュから返します。
+		/// @param playerID プレイヤーの ID
+		/// @param key キー
+		/// @return 値, 設定されていない場合や型が一致しない場合は none
+		/// @remark 値に付いた型を表す ID で型を確認します。型 ID を持たない serialize() の型は、サイズが同じ別の型と区別できません。
+		template <Serializable Type>
+		[[nodiscard]]
+		Optional<Type> getPlayerProperty(int32 playerID, StringView key) const;
+
+		/// @brief プレイヤーのカスタムプロパティのキーの一覧を返します。
+		/// @param playerID プレイヤーの ID
+		[[nodiscard]]
+		Array<String> getPlayerPropertyKeys(int32 playerID) const;
+
 		virtual void connectionErrorReturn(int32 errorCode);
 
 		virtual void connectReturn(int32 errorCode, const String& errorString, const String& region, const String& cluster);
@@ -197,6 +368,18 @@ namespace s3d::NetworkSystem
 
 		virtual void createRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString);
 
+		/// @brief ルームのカスタムプロパティが変更されたときに呼ばれます。
+		/// @param keys 変更されたキーの一覧
+		virtual void roomPropertiesChanged(const Array<String>& keys);
+
+		/// @brief プレイヤーのカスタムプロパティが変更されたときに呼ばれます。
+		/// @param playerID プレイヤーの ID
+		/// @param keys 変更されたキーの一覧
+		virtual void playerPropertiesChanged(int32 playerID, const Array<String>& keys);
+
+		/// @brief ロビーのルームの一覧が更新されたときに呼ばれます。
+		virtual void roomListUpdated();
+
 		virtual void customEventAction(const int32 playerID, const int32 eventCode, const int32 eventContent);
 
 		virtual void customEventAction(const int32 playerID, const int32 eventCode, const double eventContent);
@@ -251,6 +434,49 @@ namespace s3d::NetworkSystem
 
 		virtual void customEventAction(const int32 playerID, const int32 eventCode, const Grid<Circle>& eventContent);
 
+		// 以下の std::span, GridView を受け取る customEventAction には、受信したバッファをコピーせずに参照するビューが渡されます。
+		// ビューはこの関数の呼び出し中のみ有効です。既定の実装は Array, Grid にコピーして対応する customEventAction を呼びます。
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const int32> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const double> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const float> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const bool> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Point> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Vec2> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Rect> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Circle> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<int32>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<double>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<float>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<bool>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Point>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Vec2>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Rect>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Circle>& eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, std::span<const StringView> eventContent);
+
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const GridView<StringView>& eventContent);
+
+		/// @brief ユーザ定義型のイベントを受信したときに呼ばれます。
+		/// @param eventContent 受信したイベント。eventContent.get<Type>() で値を復元します。
+		virtual void customEventAction(const int32 playerID, const int32 eventCode, const SerializedValue& eventContent);
+
 	protected:
 
 		/// @brief 現在のステートのキーを取得します。
@@ -289,6 +515,12 @@ namespace s3d::NetworkSystem
 		std::shared_ptr<Data_t> m_data;
 
 		SivPhotonSceneMaster<State_t, Data_t>* m_manager;
+
+		/// @brief setEventHandler() で登録したオブジェクト (派生クラスへのポインタ)
+		const void* m_eventHandlerObject = nullptr;
+
+		/// @brief startLockstep() で開始したロックステップ
+		const void* m_lockstepObject = nullptr;
 	};
 
 	/// @brief シーン遷移管理
@@ -311,6 +543,17 @@ namespace s3d::NetworkSystem
 		SIV3D_NODISCARD_CXX20
 			explicit SivPhotonSceneMaster(const std::shared_ptr<Data>& data, StringView secretPhotonAppID, StringView photonAppVersion);
 
+		/// @brief ループバックの仮想サーバに接続するシーン管理を初期化します。
+		/// @param network 接続する仮想サーバ
+		SIV3D_NODISCARD_CXX20
+			explicit SivPhotonSceneMaster(const std::shared_ptr<LoopbackNetwork>& network);
+
+		/// @brief ループバックの仮想サーバに接続するシーン管理を初期化します。
+		/// @param data 共有データ
+		/// @param network 接続する仮想サーバ
+		SIV3D_NODISCARD_CXX20
+			SivPhotonSceneMaster(const std::shared_ptr<Data>& data, const std::shared_ptr<LoopbackNetwork>& network);
+
 		/// @brief シーンを登録します。
 		/// @tparam SceneType シーンの型
 		/// @param state シーンのキー
@@ -370,10 +613,56 @@ namespace s3d::NetworkSystem
 		[[nodiscard]]
 		const ColorF& getFadeColor() const noexcept;
 
+		/// @brief 受信キューから 1 フレームに処理するイベントの量の上限を設定します。
+		/// @param budget 1 フレームに処理する量の上限
+		/// @return *this
+		/// @remark setReceiveQueue(true) で受信キューを使う場合のみ有効です。処理しきれなかったイベントは次のフレームに持ち越します。
+		SivPhotonSceneMaster& setReceiveBudget(const ReceiveBudget& budget) noexcept;
+
+		/// @brief 受信キューから 1 フレームに処理するイベントの量の上限を返します。
+		/// @return 1 フレームに処理する量の上限
+		[[nodiscard]]
+		const ReceiveBudget& getReceiveBudget() const noexcept;
+
+		/// @brief 通信の統計を画面に重ねて表示するかを設定します。
+		/// @param enabled 表示する場合 true
+		/// @return *this
+		/// @remark 往復時間、送受信量、キューの長さ、service() にかかった時間と、送受信量の多いイベントコードを表示します。
+		SivPhotonSceneMaster& setNetworkStatsOverlay(bool enabled) noexcept;
+
+		/// @brief 通信の統計を画面に重ねて表示するかを返します。
+		/// @return 表示する場合 true, それ以外の場合は false
+		[[nodiscard]]
+		bool getNetworkStatsOverlay() const noexcept;
+
+		/// @brief クロスフェード中に受信したコールバックとイベントを渡すシーンを設定します。
+		/// @param target 渡すシーン
+		/// @return *this
+		/// @remark クロスフェードしないシーンの変更では、フェードアウト中に受信したものを保留し、次のシーンのフェードイン開始後に渡します。
+		SivPhotonSceneMaster& setCrossFadeEventTarget(CrossFadeEventTarget target) noexcept;
+
+		/// @brief クロスフェード中に受信したコールバックとイベントを渡すシーンを返します。
+		/// @return 渡すシーン
+		[[nodiscard]]
+		CrossFadeEventTarget getCrossFadeEventTarget() const noexcept;
+
 		/// @brief エラーの発生を通知します。
 		/// @return この関数を呼ぶと、以降のこのクラスの `SivPhotonSceneMaster::update()` が false を返します。
 		void notifyError() noexcept;
 
+		/// @brief ロックステップを開始し、以降、毎フレーム tick を進めて入力を送信します。
+		/// @param eventCode 入力を送受信するイベントコード
+		/// @param lockstep ロックステップ
+		/// @param playerIDs 参加するプレイヤーの ID (すべてのクライアントで同じである必要があります)
+		/// @remark 開始中のロックステップは停止します。ルームに参加していない場合は開始しません。
+		template <class Input, class LockstepState, size_t Capacity>
+		void startLockstep(uint8 eventCode, Lockstep<Input, LockstepState, Capacity>& lockstep, const Array<int32>& playerIDs);
+
+		/// @brief ロックステップを停止します。
+		/// @param lockstep 停止するロックステップ (開始中のものと異なる場合は何もしません)
+		/// @remark 入力の送受信と tick の進行をやめるだけで、lockstep には触れません (破棄中のシーンから呼ぶため)。
+		void stopLockstep(const void* lockstep) noexcept;
+
 	private:
 		// 通信関係のあれこれ
 		void connectionErrorReturn(int32 errorCode);
@@ -394,6 +683,12 @@ namespace s3d::NetworkSystem
 
 		void createRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString);
 
+		void roomPropertiesChanged(const Array<String>& keys);
+
+		void playerPropertiesChanged(int32 playerID, const Array<String>& keys);
+
+		void roomListUpdated();
+
 		void customEventAction(const int32 playerID, const int32 eventCode, const int32 eventContent);
 
 		void customEventAction(const int32 playerID, const int32 eventCode, const double eventContent);
@@ -448,6 +743,44 @@ namespace s3d::NetworkSystem
 
 		void customEventAction(const int32 playerID, const int32 eventCode, const Grid<Circle>& eventContent);
 
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const int32> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const double> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const float> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const bool> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Point> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Vec2> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Rect> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const Circle> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<int32>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<double>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<float>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<bool>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Point>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Vec2>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Rect>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<Circle>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, std::span<const StringView> eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const GridView<StringView>& eventContent);
+
+		void customEventAction(const int32 playerID, const int32 eventCode, const SerializedValue& eventContent);
+
 	private:
 
 		using Scene_t = std::shared_ptr<IScene<State, Data>>;
@@ -488,8 +821,33 @@ namespace s3d::NetworkSystem
 
 		ColorF m_fadeColor = Palette::Black;
 
+		ReceiveBudget m_receiveBudget;
+
 		CrossFade m_crossFade = CrossFade::No;
 
+		CrossFadeEventTarget m_crossFadeEventTarget = CrossFadeEventTarget::Next;
+
+		bool m_networkStatsOverlay = false;
+
+		/// @brief 前回受信したコマンドを処理してからの時間 (秒)
+		double m_dispatchAccumulator = 0.0;
+
+		/// @brief 前回送信してからの時間 (秒)
+		double m_sendAccumulator = 0.0;
+
+		/// @brief startLockstep() で開始したロックステップ (型に依らずに進めるための関数を持つ)
+		struct LockstepDriver
+		{
+			void* object = nullptr;
+
+			uint8 eventCode = 0;
+
+			void (*update)(SivPhotonSceneMaster& manager, void* object, uint8 eventCode, double deltaTime) = nullptr;
+
+			void (*removePlayer)(void* object, int32 playerID) = nullptr;
+
+		} m_lockstep;
+
 		bool m_error = false;
 
 		[[nodiscard]]
@@ -498,6 +856,23 @@ namespace s3d::NetworkSystem
 		[[nodiscard]]
 		bool updateCross();
 
+		/// @brief 通信の統計を画面に重ねて表示します。
+		void drawNetworkStats() const;
+
+		/// @brief 画面遷移の状態にかかわらず、getTickRate() の頻度で通信します。
+		void updateNetwork();
+
+		/// @brief 経過時間を加算し、このフレームで通信するかを返します。
+		/// @param accumulator 前回通信してからの時間 (秒)
+		/// @param rate 通信の頻度 (Hz, 0 の場合は毎フレーム)
+		/// @param deltaTime 前のフレームからの経過時間 (秒)
+		[[nodiscard]]
+		static bool StepTick(double& accumulator, double rate, double deltaTime) noexcept;
+
+		/// @brief 受信したコールバックとイベントを渡すシーンそれぞれに対して function を呼びます。
+		template <class Function>
+		void forEachEventScene(Function function);
+
 		[[nodiscard]]
 		bool hasError() const noexcept;
 	};
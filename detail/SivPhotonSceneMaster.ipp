@@ -14,6 +14,20 @@ namespace s3d::NetworkSystem
 		, m_data{ init._s }
 		, m_manager{ init._m } {}
 
+	template <class State, class Data>
+	inline IScene<State, Data>::~IScene()
+	{
+		if (m_eventHandlerObject)
+		{
+			m_manager->removeEventHandlers(m_eventHandlerObject);
+		}
+
+		if (m_lockstepObject)
+		{
+			m_manager->stopLockstep(m_lockstepObject);
+		}
+	}
+
 	template <class State, class Data>
 	inline void IScene<State, Data>::drawFadeIn(const double t) const
 	{
@@ -81,6 +95,21 @@ namespace s3d::NetworkSystem
 		: m_data{ data }
 		, SivPhoton(secretPhotonAppID, photonAppVersion){}
 
+	template <class State, class Data>
+	inline SivPhotonSceneMaster<State, Data>::SivPhotonSceneMaster(const std::shared_ptr<LoopbackNetwork>& network)
+		: SivPhoton(network)
+	{
+		if constexpr (not std::is_void_v<Data>)
+		{
+			m_data = std::make_shared<Data>();
+		}
+	}
+
+	template <class State, class Data>
+	inline SivPhotonSceneMaster<State, Data>::SivPhotonSceneMaster(const std::shared_ptr<Data>& data, const std::shared_ptr<LoopbackNetwork>& network)
+		: SivPhoton(network)
+		, m_data{ data } {}
+
 	template <class State, class Data>
 	template <class SceneType>
 	inline SivPhotonSceneMaster<State, Data>& SivPhotonSceneMaster<State, Data>::add(const State& state)
@@ -161,14 +190,15 @@ namespace s3d::NetworkSystem
 			}
 		}
 
-		if (m_crossFade)
-		{
-			return updateCross();
-		}
-		else
+		if (not (m_crossFade ? updateCross() : updateSingle()))
 		{
-			return updateSingle();
+			return false;
 		}
+
+		// フェードイン・アウト中も通信を止めない
+		updateNetwork();
+
+		return (not hasError());
 	}
 
 	template <class State, class Data>
@@ -205,6 +235,11 @@ namespace s3d::NetworkSystem
 				m_next->drawFadeIn(t);
 			}
 		}
+
+		if (m_networkStatsOverlay)
+		{
+			drawNetworkStats();
+		}
 	}
 
 	template <class State, class Data>
@@ -261,6 +296,9 @@ namespace s3d::NetworkSystem
 
 			m_transitionState = TransitionState::FadeInOut;
 
+			// 受信したものは次のシーンにすぐ渡せる
+			this->setHoldCallbacks(false);
+
 			m_next = m_factories[m_nextState]();
 
 			if (hasError())
@@ -278,6 +316,9 @@ namespace s3d::NetworkSystem
 
 			m_transitionState = TransitionState::FadeOut;
 
+			// フェードアウト中に受信したものは、次のシーンに渡す
+			this->setHoldCallbacks(true);
+
 			m_stopwatch.restart();
 		}
 
@@ -298,12 +339,109 @@ namespace s3d::NetworkSystem
 		return m_fadeColor;
 	}
 
+	template <class State, class Data>
+	inline SivPhotonSceneMaster<State, Data>& SivPhotonSceneMaster<State, Data>::setReceiveBudget(const ReceiveBudget& budget) noexcept
+	{
+		m_receiveBudget = budget;
+
+		return *this;
+	}
+
+	template <class State, class Data>
+	inline const ReceiveBudget& SivPhotonSceneMaster<State, Data>::getReceiveBudget() const noexcept
+	{
+		return m_receiveBudget;
+	}
+
+	template <class State, class Data>
+	inline SivPhotonSceneMaster<State, Data>& SivPhotonSceneMaster<State, Data>::setNetworkStatsOverlay(const bool enabled) noexcept
+	{
+		m_networkStatsOverlay = enabled;
+
+		return *this;
+	}
+
+	template <class State, class Data>
+	inline bool SivPhotonSceneMaster<State, Data>::getNetworkStatsOverlay() const noexcept
+	{
+		return m_networkStatsOverlay;
+	}
+
+	template <class State, class Data>
+	inline SivPhotonSceneMaster<State, Data>& SivPhotonSceneMaster<State, Data>::setCrossFadeEventTarget(const CrossFadeEventTarget target) noexcept
+	{
+		m_crossFadeEventTarget = target;
+
+		return *this;
+	}
+
+	template <class State, class Data>
+	inline CrossFadeEventTarget SivPhotonSceneMaster<State, Data>::getCrossFadeEventTarget() const noexcept
+	{
+		return m_crossFadeEventTarget;
+	}
+
 	template <class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::notifyError() noexcept
 	{
 		m_error = true;
 	}
 
+	template <class State, class Data>
+	template <class Input, class LockstepState, size_t Capacity>
+	inline void SivPhotonSceneMaster<State, Data>::startLockstep(const uint8 eventCode, Lockstep<Input, LockstepState, Capacity>& lockstep, const Array<int32>& playerIDs)
+	{
+		using LockstepType = Lockstep<Input, LockstepState, Capacity>;
+
+		stopLockstep(m_lockstep.object);
+
+		const Optional<int32> localPlayerID = this->localPlayerID();
+
+		if (not localPlayerID)
+		{
+			SIVPHOTON_LOG(Warning, U"SivPhotonSceneMaster::startLockstep() ルームに参加していません");
+			return;
+		}
+
+		lockstep.start(playerIDs, *localPlayerID);
+
+		if (not lockstep.isRunning())
+		{
+			return;
+		}
+
+		this->template setEventHandler<&LockstepType::receive>(eventCode, &lockstep);
+
+		m_lockstep = LockstepDriver{
+			.object = &lockstep,
+			.eventCode = eventCode,
+			.update = [](SivPhotonSceneMaster& manager, void* object, const uint8 eventCode, const double deltaTime)
+			{
+				for (const auto& message : static_cast<LockstepType*>(object)->update(deltaTime))
+				{
+					manager.opRaiseEvent(eventCode, message);
+				}
+			},
+			.removePlayer = [](void* object, const int32 playerID)
+			{
+				static_cast<LockstepType*>(object)->removePlayer(playerID);
+			},
+		};
+	}
+
+	template <class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::stopLockstep(const void* lockstep) noexcept
+	{
+		if ((not lockstep)
+			|| (m_lockstep.object != lockstep))
+		{
+			return;
+		}
+
+		this->removeEventHandlers(lockstep);
+		m_lockstep = LockstepDriver{};
+	}
+
 	template <class State, class Data>
 	inline bool SivPhotonSceneMaster<State, Data>::updateSingle()
 	{
@@ -323,6 +461,8 @@ namespace s3d::NetworkSystem
 
 			m_currentState = m_nextState;
 
+			this->setHoldCallbacks(false);
+
 			m_transitionState = TransitionState::FadeIn;
 
 			m_stopwatch.restart();
@@ -347,10 +487,6 @@ namespace s3d::NetworkSystem
 			break;
 		case TransitionState::Active:
 			m_current->update();
-			if (this->isUsePhoton())
-			{
-				SivPhoton::update();
-			}
 			break;
 		case TransitionState::FadeOut:
 			m_current->updateFadeOut(t);
@@ -402,6 +538,141 @@ namespace s3d::NetworkSystem
 		return (not hasError());
 	}
 
+	template <class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::drawNetworkStats() const
+	{
+		// 表示するイベントコードの数
+		constexpr size_t MaxEventCodes = 5;
+
+		static const Font font{ 14 };
+
+		const NetworkStats stats = this->getNetworkStats();
+
+		String text = U"RTT: {} ms (±{} ms)\n"_fmt(stats.roundTripTime, stats.roundTripTimeVariance);
+		text += U"In: {} bytes, {} packets\n"_fmt(stats.bytesIn, stats.packetsIn);
+		text += U"Out: {} bytes, {} packets\n"_fmt(stats.bytesOut, stats.packetsOut);
+		text += U"Resent: {}, Queued: {} in / {} out, Receive queue: {}\n"_fmt(stats.resentReliableCommands, stats.queuedIncomingCommands, stats.queuedOutgoingCommands, stats.receiveQueueBacklog);
+		text += U"service(): {:.2f} ms (total {:.1f} s)"_fmt((stats.lastServiceTime.count() * 1000.0), stats.totalServiceTime.count());
+
+		// 送受信したバイト数 (旧形式のイベントのみの場合は数) の多い順に表示する
+		Array<uint8> eventCodes;
+
+		for (size_t eventCode = 0; eventCode < stats.sentEvents.size(); ++eventCode)
+		{
+			if (stats.sentEvents[eventCode].count || stats.receivedEvents[eventCode].count)
+			{
+				eventCodes << static_cast<uint8>(eventCode);
+			}
+		}
+
+		const auto usage = [&](const uint8 eventCode)
+		{
+			const auto& sent = stats.sentEvents[eventCode];
+			const auto& received = stats.receivedEvents[eventCode];
+			return std::pair{ (sent.bytes + received.bytes), (sent.count + received.count) };
+		};
+
+		const size_t count = Min(eventCodes.size(), MaxEventCodes);
+
+		std::partial_sort(eventCodes.begin(), (eventCodes.begin() + count), eventCodes.end(),
+			[&](const uint8 a, const uint8 b) { return (usage(b) < usage(a)); });
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint8 eventCode = eventCodes[i];
+			const auto& sent = stats.sentEvents[eventCode];
+			const auto& received = stats.receivedEvents[eventCode];
+
+			text += U"\n#{}: sent {} ({} bytes), received {} ({} bytes)"_fmt(eventCode, sent.count, sent.bytes, received.count, received.bytes);
+		}
+
+		Transformer2D transform{ Mat3x2::Identity(), Transformer2D::Target::SetLocal };
+
+		const RectF region = font(text).region(Vec2{ 10, 10 });
+
+		region.stretched(6).draw(ColorF{ 0.0, 0.6 });
+
+		font(text).draw(region.pos, Palette::White);
+	}
+
+	template <class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::updateNetwork()
+	{
+		if (not this->isUsePhoton())
+		{
+			return;
+		}
+
+		const double deltaTime = s3d::Scene::DeltaTime();
+		const TickRate& tickRate = this->getTickRate();
+
+		if (StepTick(m_dispatchAccumulator, tickRate.dispatchIncoming, deltaTime))
+		{
+			this->dispatchIncomingCommands();
+		}
+
+		// 保留している間は、受信キューのイベントも次のシーンまで残す
+		if (this->getReceiveQueue()
+			&& (not this->getHoldCallbacks()))
+		{
+			this->dispatchReceivedEvents(m_receiveBudget);
+		}
+
+		// 受信した入力を反映してから tick を進め、読み取った入力を同じフレームで送信する
+		if (m_lockstep.object)
+		{
+			m_lockstep.update(*this, m_lockstep.object, m_lockstep.eventCode, deltaTime);
+		}
+
+		// コールバックの中で送信したイベントも同じフレームで送信する
+		if (StepTick(m_sendAccumulator, tickRate.sendOutgoing, deltaTime))
+		{
+			this->sendOutgoingCommands();
+		}
+	}
+
+	template <class State, class Data>
+	inline bool SivPhotonSceneMaster<State, Data>::StepTick(double& accumulator, const double rate, const double deltaTime) noexcept
+	{
+		if (rate <= 0.0)
+		{
+			return true;
+		}
+
+		const double interval = (1.0 / rate);
+
+		accumulator += deltaTime;
+
+		if (accumulator < interval)
+		{
+			return false;
+		}
+
+		// フレームレートが通信の頻度より低い場合は毎フレーム通信し、遅れた分をまとめて取り戻そうとはしない
+		accumulator = Min((accumulator - interval), interval);
+
+		return true;
+	}
+
+	template <class State, class Data>
+	template <class Function>
+	inline void SivPhotonSceneMaster<State, Data>::forEachEventScene(Function function)
+	{
+		if ((m_transitionState == TransitionState::FadeInOut) && m_next)
+		{
+			if ((m_crossFadeEventTarget == CrossFadeEventTarget::Both) && m_current)
+			{
+				function(*m_current);
+			}
+
+			function(*m_next);
+		}
+		else if (m_current)
+		{
+			function(*m_current);
+		}
+	}
+
 	template <class State, class Data>
 	inline bool SivPhotonSceneMaster<State, Data>::hasError() const noexcept
 	{
@@ -428,6 +699,18 @@ namespace s3d::NetworkSystem
 		m_manager->opJoinRandomRoom(maxPlayers);
 	}
 
+	template<class State, class Data>
+	inline void IScene<State, Data>::opJoinRandomRoom(const MatchmakingOptions& options)
+	{
+		m_manager->opJoinRandomRoom(options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opJoinRandomOrCreateRoom(const MatchmakingOptions& options, const StringView roomName, const RoomCreateOptions& createOptions)
+	{
+		m_manager->opJoinRandomOrCreateRoom(options, roomName, createOptions);
+	}
+
 	template<class State, class Data>
 	inline void IScene<State, Data>::opJoinRoom(const StringView roomName, const bool rejoin)
 	{
@@ -440,107 +723,200 @@ namespace s3d::NetworkSystem
 		m_manager->opCreateRoom(roomName, maxPlayers);
 	}
 
+	template<class State, class Data>
+	inline void IScene<State, Data>::opCreateRoom(const StringView roomName, const RoomCreateOptions& options)
+	{
+		m_manager->opCreateRoom(roomName, options);
+	}
+
 	template<class State, class Data>
 	inline void IScene<State, Data>::opLeaveRoom()
 	{
 		m_manager->opLeaveRoom();
 	}
 
+	template<class State, class Data>
+	inline void IScene<State, Data>::opChangeGroups(const Array<uint8>& groupsToRemove, const Array<uint8>& groupsToAdd)
+	{
+		m_manager->opChangeGroups(groupsToRemove, groupsToAdd);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::setInterestGroups(const Array<uint8>& groups)
+	{
+		m_manager->setInterestGroups(groups);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::clearInterestGroups()
+	{
+		m_manager->clearInterestGroups();
+	}
+
+	template<class State, class Data>
+	inline Array<uint8> IScene<State, Data>::getInterestGroups() const
+	{
+		return m_manager->getInterestGroups();
+	}
+
 	template<class State, class Data>
 	template<class T>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const T& value)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const T& value, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, value, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const int32 value, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, value, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const double value, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, value, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const float value, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, value, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const bool value, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, value, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const StringView value, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, value, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<int32>& values, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, values, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<double>& values, const SendOptions& options)
+	{
+		m_manager->opRaiseEvent(eventCode, values, options);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<float>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, value);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const int32 value)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<bool>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, value);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const double value)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<String>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, value);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const float value)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<int32>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, value);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const bool value)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<double>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, value);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(const uint8 eventCode, const StringView value)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<float>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, value);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<int32>& values)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<bool>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<double>& values)
+	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<String>& values, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->opRaiseEvent(eventCode, values, options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<float>& values)
+	template <class Input, class PredictedState, size_t Capacity>
+	inline void IScene<State, Data>::opRaisePredictedInput(const uint8 eventCode, Prediction<Input, PredictedState, Capacity>& prediction, const Input& input, const SendOptions& options)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->opRaiseEvent(eventCode, prediction.predict(input), options);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<bool>& values)
+	inline void IScene<State, Data>::setQuantizationProfile(const uint8 eventCode, const QuantizationProfile& profile)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->setQuantizationProfile(eventCode, profile);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Array<String>& values)
+	inline void IScene<State, Data>::setGridReplication(const uint8 eventCode, const bool enabled)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->setGridReplication(eventCode, enabled);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<int32>& values)
+	inline void IScene<State, Data>::setEventBatching(const bool enabled)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->setEventBatching(enabled);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<double>& values)
+	template <auto Handler>
+	inline void IScene<State, Data>::setEventHandler(const uint8 eventCode)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		using SceneType = typename s3d::detail::EventHandlerTraits<decltype(Handler)>::Object;
+
+		static_assert(std::is_base_of_v<IScene, SceneType>, "Handler はシーンのメンバ関数である必要があります。");
+
+		SceneType* scene = static_cast<SceneType*>(this);
+		m_eventHandlerObject = scene;
+		m_manager->template setEventHandler<Handler>(eventCode, scene);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<float>& values)
+	inline void IScene<State, Data>::removeEventHandler(const uint8 eventCode)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->removeEventHandler(eventCode);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<bool>& values)
+	template <class Input, class LockstepState, size_t Capacity>
+	inline void IScene<State, Data>::startLockstep(const uint8 eventCode, Lockstep<Input, LockstepState, Capacity>& lockstep, const Array<int32>& playerIDs)
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->startLockstep(eventCode, lockstep, playerIDs);
+
+		if (lockstep.isRunning())
+		{
+			m_lockstepObject = &lockstep;
+		}
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::opRaiseEvent(uint8 eventCode, const Grid<String>& values)
+	inline void IScene<State, Data>::stopLockstep()
 	{
-		m_manager->opRaiseEvent(eventCode, values);
+		m_manager->stopLockstep(m_lockstepObject);
+		m_lockstepObject = nullptr;
 	}
 
 	template<class State, class Data>
@@ -561,6 +937,24 @@ namespace s3d::NetworkSystem
 		return m_manager->getRoomNameList();
 	}
 
+	template<class State, class Data>
+	inline const Array<RoomInfo>& IScene<State, Data>::getRoomList() const noexcept
+	{
+		return m_manager->getRoomList();
+	}
+
+	template<class State, class Data>
+	inline uint64 IScene<State, Data>::getRoomListVersion() const noexcept
+	{
+		return m_manager->getRoomListVersion();
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::setRoomPropertiesListedInLobby(const Array<String>& keys)
+	{
+		m_manager->setRoomPropertiesListedInLobby(keys);
+	}
+
 	template<class State, class Data>
 	inline bool IScene<State, Data>::isInRoom() const
 	{
@@ -646,545 +1040,1070 @@ namespace s3d::NetworkSystem
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::connectionErrorReturn(const int32 errorCode)
+	inline int32 IScene<State, Data>::getServerTime() const
 	{
-		Print << U"IScene<State, Data>::connectionErrorReturn() [サーバへの接続が失敗したときに呼ばれる]";
-		Print << U"errorCode: " << errorCode;
+		return m_manager->getServerTime();
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::connectReturn(const int32 errorCode, const String& errorString, const String& region, const String& cluster)
+	inline void IScene<State, Data>::registerNetworkVar(NetworkVarBase& var)
 	{
-		Print << U"IScene<State, Data>::connectReturn()";
-		Print << U"error: " << errorString;
-		Print << U"region: " << region;
-		Print << U"cluster: " << cluster;
+		m_manager->registerNetworkVar(var);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::disconnectReturn()
+	template <class Type>
+		requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void IScene<State, Data>::setRoomProperty(const StringView key, const Type& value)
 	{
-		Print << U"IScene<State, Data>::disconnectReturn() [サーバから切断されたときに呼ばれる]";
+		m_manager->setRoomProperty(key, value);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::leaveRoomReturn(const int32 errorCode, const String& errorString)
+	template <class Type>
+		requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void IScene<State, Data>::setRoomProperty(const StringView key, const Type& value, const Type& expectedValue)
 	{
-		Print << U"IScene<State, Data>::leaveRoomReturn() [ルームから退室した結果を処理する]";
-		Print << U"- errorCode:" << errorCode;
-		Print << U"- errorString:" << errorString;
+		m_manager->setRoomProperty(key, value, expectedValue);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::joinRandomRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
+	template <Serializable Type>
+	inline Optional<Type> IScene<State, Data>::getRoomProperty(const StringView key) const
 	{
-		Print << U"IScene<State, Data>::joinRandomRoomReturn()";
-		Print << U"localPlayerID:" << localPlayerID;
-		Print << U"errorCode:" << errorCode;
-		Print << U"errorString:" << errorString;
+		return m_manager->template getRoomProperty<Type>(key);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::joinRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString)
+	inline Array<String> IScene<State, Data>::getRoomPropertyKeys() const
 	{
-		Print << U"IScene<State, Data>::joinRoomReturn()";
-		Print << U"localPlayerID:" << localPlayerID;
-		Print << U"errorCode:" << errorCode;
-		Print << U"errorString:" << errorString;
+		return m_manager->getRoomPropertyKeys();
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::joinRoomEventAction(const int32 localPlayerID, const Array<int32>& playerIDs, const bool isSelf)
+	template <class Type>
+		requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void IScene<State, Data>::setPlayerProperty(const StringView key, const Type& value)
 	{
-		Print << U"IScene<State, Data>::joinRoomEventAction() [自分を含め、プレイヤーが参加したら呼ばれる]";
-		Print << U"localPlayerID [参加した人の ID]:" << localPlayerID;
-		Print << U"playerIDs: [ルームの参加者一覧]" << playerIDs;
-		Print << U"isSelf [自分自身の参加？]:" << isSelf;
+		m_manager->setPlayerProperty(key, value);
 	}
 
 	template<class State, class Data>
-	inline void IScene<State, Data>::leaveRoomEventAction(const int32 playerID, const bool isInactive)
+	template <class Type>
+		requires (Serializable<Type> || std::is_convertible_v<const Type&, StringView>)
+	inline void IScene<State, Data>::setPlayerProperty(const StringView key, const Type& value, const Type& expectedValue)
 	{
-		Print << U"IScene<State, Data>::leaveRoomEventAction()";
-		Print << U"playerID: " << playerID;
-		Print << U"isInactive: " << isInactive;
+		m_manager->setPlayerProperty(key, value, expectedValue);
+	}
 
-		if (m_manager->isMasterClient())
-		{
-			Print << U"I am now the master client";
-		}
-		else
-		{
-			Print << U"I am still not the master client";
+	template<class State, class Data>
+	template <Serializable Type>
+	inline Optional<Type> IScene<State, Data>::getPlayerProperty(const int32 playerID, const StringView key) const
+	{
+		return m_manager->template getPlayerProperty<Type>(playerID, key);
+	}
+
+	template<class State, class Data>
+	inline Array<String> IScene<State, Data>::getPlayerPropertyKeys(const int32 playerID) const
+	{
+		return m_manager->getPlayerPropertyKeys(playerID);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::connectionErrorReturn(const int32 errorCode)
+	{
+		SIVPHOTON_LOG(Error, U"IScene<State, Data>::connectionErrorReturn() [サーバへの接続が失敗したときに呼ばれる]");
+		SIVPHOTON_LOG(Error, U"errorCode: ", errorCode);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::connectReturn(const int32 errorCode, const String& errorString, const String& region, const String& cluster)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::connectReturn()");
+		SIVPHOTON_LOG(Info, U"error: ", errorString);
+		SIVPHOTON_LOG(Info, U"region: ", region);
+		SIVPHOTON_LOG(Info, U"cluster: ", cluster);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::disconnectReturn()
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::disconnectReturn() [サーバから切断されたときに呼ばれる]");
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::leaveRoomReturn(const int32 errorCode, const String& errorString)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::leaveRoomReturn() [ルームから退室した結果を処理する]");
+		SIVPHOTON_LOG(Info, U"- errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"- errorString:", errorString);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::joinRandomRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::joinRandomRoomReturn()");
+		SIVPHOTON_LOG(Info, U"localPlayerID:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"errorString:", errorString);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::joinRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::joinRoomReturn()");
+		SIVPHOTON_LOG(Info, U"localPlayerID:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"errorString:", errorString);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::joinRoomEventAction(const int32 localPlayerID, const Array<int32>& playerIDs, const bool isSelf)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::joinRoomEventAction() [自分を含め、プレイヤーが参加したら呼ばれる]");
+		SIVPHOTON_LOG(Info, U"localPlayerID [参加した人の ID]:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"playerIDs: [ルームの参加者一覧]", playerIDs);
+		SIVPHOTON_LOG(Info, U"isSelf [自分自身の参加？]:", isSelf);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::leaveRoomEventAction(const int32 playerID, const bool isInactive)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::leaveRoomEventAction()");
+		SIVPHOTON_LOG(Info, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Info, U"isInactive: ", isInactive);
+
+		if (m_manager->isMasterClient())
+		{
+			SIVPHOTON_LOG(Info, U"I am now the master client");
+		}
+		else
+		{
+			SIVPHOTON_LOG(Info, U"I am still not the master client");
 		}
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::createRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
 	{
-		Print << U"IScene<State, Data>::createRoomReturn() [ルームを新規作成した結果を処理する]";
-		Print << U"- localPlayerID:" << localPlayerID;
-		Print << U"- errorCode:" << errorCode;
-		Print << U"- errorString:" << errorString;
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::createRoomReturn() [ルームを新規作成した結果を処理する]");
+		SIVPHOTON_LOG(Info, U"- localPlayerID:", localPlayerID);
+		SIVPHOTON_LOG(Info, U"- errorCode:", errorCode);
+		SIVPHOTON_LOG(Info, U"- errorString:", errorString);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::roomPropertiesChanged(const Array<String>& keys)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::roomPropertiesChanged() [ルームのカスタムプロパティが変更されたら呼ばれる]");
+		SIVPHOTON_LOG(Info, U"- keys:", keys);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::playerPropertiesChanged(const int32 playerID, const Array<String>& keys)
+	{
+		SIVPHOTON_LOG(Info, U"IScene<State, Data>::playerPropertiesChanged() [プレイヤーのカスタムプロパティが変更されたら呼ばれる]");
+		SIVPHOTON_LOG(Info, U"- playerID:", playerID);
+		SIVPHOTON_LOG(Info, U"- keys:", keys);
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::roomListUpdated()
+	{
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::roomListUpdated() [ロビーのルームの一覧が更新されたら呼ばれる]");
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const int32 eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(int32)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(int32)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const double eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(double)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(double)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const float eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(float)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(float)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const bool eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(bool)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(bool)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const String& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(String)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(String)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<int32>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<int32>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<int32>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<double>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<double>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<double>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<float>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<float>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<float>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<bool>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<bool>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<bool>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<String>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<String>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<String>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<int32>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<int32>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<int32>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<double>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<double>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<double>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<float>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<float>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<float>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<bool>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<bool>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<bool>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<String>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<String>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<String>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Point& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Point)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Point)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Vec2& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Vec2)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Vec2)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Rect& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Rect)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Rect)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Circle& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Circle)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Circle)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Point>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<Point>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<Point>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Vec2>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<Vec2>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<Vec2>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Rect>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<Rect>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<Rect>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Circle>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<Circle>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<Circle>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Point>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<Point>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<Point>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Vec2>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<Vec2>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<Vec2>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Rect>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Grid<Rect>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Grid<Rect>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
 	}
 
 	template<class State, class Data>
 	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Circle>& eventContent)
 	{
-		Print << U"IScene<State, Data>::customEventAction(Array<Circle>)";
-		Print << U"playerID: " << playerID;
-		Print << U"eventCode: " << eventCode;
-		Print << U"eventContent: " << eventContent;
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(Array<Circle>)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"eventContent: ", eventContent);
+	}
+
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const int32> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<int32>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const double> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<double>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const float> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<float>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const bool> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<bool>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Point> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<Point>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Vec2> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<Vec2>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Rect> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<Rect>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Circle> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<Circle>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<int32>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<double>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<float>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<bool>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Point>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Vec2>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Rect>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Circle>& eventContent)
+	{
+		customEventAction(playerID, eventCode, eventContent.toGrid());
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const StringView> eventContent)
+	{
+		customEventAction(playerID, eventCode, Array<String>(eventContent.begin(), eventContent.end()));
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<StringView>& eventContent)
+	{
+		customEventAction(playerID, eventCode, Grid<String>{ eventContent.size(), Array<String>(eventContent.begin(), eventContent.end()) });
+	}
+
+	template<class State, class Data>
+	inline void IScene<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const SerializedValue& eventContent)
+	{
+		SIVPHOTON_LOG(Trace, U"IScene<State, Data>::customEventAction(SerializedValue)");
+		SIVPHOTON_LOG(Trace, U"playerID: ", playerID);
+		SIVPHOTON_LOG(Trace, U"eventCode: ", eventCode);
+		SIVPHOTON_LOG(Trace, U"typeID: ", eventContent.typeID());
 	}
 
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::connectionErrorReturn(const int32 errorCode)
 	{
-		m_current->connectionErrorReturn(errorCode);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.connectionErrorReturn(errorCode);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::connectReturn(const int32 errorCode, const String& errorString, const String& region, const String& cluster)
 	{
-		m_current->connectReturn(errorCode, errorString, region, cluster);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.connectReturn(errorCode, errorString, region, cluster);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::disconnectReturn()
 	{
-		m_current->disconnectReturn();
+		stopLockstep(m_lockstep.object);
+
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.disconnectReturn();
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::leaveRoomReturn(const int32 errorCode, const String& errorString)
 	{
-		m_current->leaveRoomReturn(errorCode, errorString);
+		stopLockstep(m_lockstep.object);
+
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.leaveRoomReturn(errorCode, errorString);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::joinRandomRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
 	{
-		m_current->joinRandomRoomReturn(localPlayerID, errorCode, errorString);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.joinRandomRoomReturn(localPlayerID, errorCode, errorString);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::joinRoomReturn(int32 localPlayerID, int32 errorCode, const String& errorString)
 	{
-		m_current->joinRoomReturn(localPlayerID, errorCode, errorString);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.joinRoomReturn(localPlayerID, errorCode, errorString);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::joinRoomEventAction(const int32 localPlayerID, const Array<int32>& playerIDs, const bool isSelf)
 	{
-		m_current->joinRoomEventAction(localPlayerID, playerIDs, isSelf);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.joinRoomEventAction(localPlayerID, playerIDs, isSelf);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::leaveRoomEventAction(const int32 playerID, const bool isInactive)
 	{
-		m_current->leaveRoomEventAction(playerID, isInactive);
+		// 再参加できるプレイヤーも、戻るまで入力を送らないため待たない
+		if (m_lockstep.object)
+		{
+			m_lockstep.removePlayer(m_lockstep.object, playerID);
+		}
+
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.leaveRoomEventAction(playerID, isInactive);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::createRoomReturn(const int32 localPlayerID, const int32 errorCode, const String& errorString)
 	{
-		m_current->createRoomReturn(localPlayerID, errorCode, errorString);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.createRoomReturn(localPlayerID, errorCode, errorString);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::roomPropertiesChanged(const Array<String>& keys)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.roomPropertiesChanged(keys);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::playerPropertiesChanged(const int32 playerID, const Array<String>& keys)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.playerPropertiesChanged(playerID, keys);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::roomListUpdated()
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.roomListUpdated();
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const int32 eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const double eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const float eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const bool eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const String& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<int32>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<double>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<float>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<bool>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<String>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<int32>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<double>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<float>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<bool>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<String>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Point& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Vec2& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Rect& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Circle& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Point>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Vec2>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Rect>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Array<Circle>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Point>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Vec2>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Rect>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 
 	template<class State, class Data>
 	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const Grid<Circle>& eventContent)
 	{
-		m_current->customEventAction(playerID, eventCode, eventContent);
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const int32> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const double> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const float> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const bool> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Point> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Vec2> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Rect> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const Circle> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<int32>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<double>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<float>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<bool>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Point>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Vec2>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Rect>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<Circle>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const std::span<const StringView> eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const GridView<StringView>& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
+	}
+
+	template<class State, class Data>
+	inline void SivPhotonSceneMaster<State, Data>::customEventAction(const int32 playerID, const int32 eventCode, const SerializedValue& eventContent)
+	{
+		forEachEventScene([&](Scene& scene)
+		{
+			scene.customEventAction(playerID, eventCode, eventContent);
+		});
 	}
 }
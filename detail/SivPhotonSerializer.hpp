@@ -0,0 +1,472 @@
+﻿# pragma once
+# include <type_traits>
+# include "SivPhotonWireFormat.hpp"
+
+// ユーザ定義型をパック形式で送受信するためのシリアライザ
+//
+// [型タグ 1 byte][可変長整数の型 ID][メンバの並び]
+//
+// メンバは serialize(Archive&) に列挙された順に、以下の形式で隙間なく並べます。
+// - String: UTF-8 のバイト数 (可変長整数) と UTF-8 のバイト列
+// - Array: 要素数 (可変長整数) と要素の並び
+// - Grid: 幅と高さ (可変長整数) と要素の並び
+// - Optional: 値を持つかどうか 1 byte と値
+// - serialize(Archive&) を持つ型: メンバの並び
+// - 算術型、列挙型、IsPackedTrivial の型: メモリ上の表現そのまま
+//
+// それ以外のクラス型は、ポインタや StringView, std::span のメンバがアドレスのまま送られたり、パディングのバイトが送られたりしないよう、serialize(Archive&) が必要です。
+namespace s3d::detail
+{
+	class PackedWriter;
+
+	template <class Type>
+	concept HasSerializeFunction = requires (Type& value, PackedWriter& archive)
+	{
+		value.serialize(archive);
+	};
+
+	/// @brief serialize(Archive&) を持たなくても、メモリ上の表現をそのまま送受信できるクラス型か
+	/// @remark パディングを含まず、ポインタを持たないトリビアルにコピー可能な型のみを特殊化します。
+	template <class Type>
+	struct IsPackedTrivial : std::false_type {};
+
+	template <>
+	struct IsPackedTrivial<Point> : std::true_type {};
+
+	template <>
+	struct IsPackedTrivial<Vec2> : std::true_type {};
+
+	template <>
+	struct IsPackedTrivial<Rect> : std::true_type {};
+
+	template <>
+	struct IsPackedTrivial<RectF> : std::true_type {};
+
+	template <>
+	struct IsPackedTrivial<Circle> : std::true_type {};
+
+	template <>
+	struct IsPackedTrivial<ColorF> : std::true_type {};
+
+	static_assert((sizeof(Point) == (sizeof(int32) * 2))
+		&& (sizeof(Vec2) == (sizeof(double) * 2))
+		&& (sizeof(Rect) == (sizeof(int32) * 4))
+		&& (sizeof(RectF) == (sizeof(double) * 4))
+		&& (sizeof(Circle) == (sizeof(double) * 3))
+		&& (sizeof(ColorF) == (sizeof(double) * 4)), "IsPackedTrivial の型がパディングを含んでいます。");
+
+	/// @brief メモリ上の表現をそのまま送受信できる型か
+	/// @remark クラス型は IsPackedTrivial の型に限ります。std::has_unique_object_representations_v はポインタのメンバを区別できないため使いません。
+	template <class Type>
+	inline constexpr bool IsPackedMemcpyable = (std::is_arithmetic_v<Type>
+		|| std::is_enum_v<Type>
+		|| (IsPackedTrivial<Type>::value && std::is_trivially_copyable_v<Type>));
+
+	/// @brief パック形式で送受信できる型か
+	template <class Type>
+	struct IsPackedSerializable : std::bool_constant<(HasSerializeFunction<Type> || IsPackedMemcpyable<Type>)> {};
+
+	template <>
+	struct IsPackedSerializable<String> : std::true_type {};
+
+	template <class Type>
+	struct IsPackedSerializable<Array<Type>> : IsPackedSerializable<Type> {};
+
+	template <class Type>
+	struct IsPackedSerializable<Grid<Type>> : IsPackedSerializable<Type> {};
+
+	template <class Type>
+	struct IsPackedSerializable<Optional<Type>> : IsPackedSerializable<Type> {};
+
+	/// @brief 値をパック形式でバッファの末尾に書き込むアーカイブ
+	class PackedWriter
+	{
+	public:
+
+		explicit PackedWriter(Array<uint8>& buffer) noexcept
+			: m_buffer{ buffer } {}
+
+		template <class... Args>
+		void operator()(const Args&... args)
+		{
+			(write(args), ...);
+		}
+
+	private:
+
+		Array<uint8>& m_buffer;
+
+		void write(const String& value)
+		{
+			const std::string utf8 = Unicode::ToUTF8(value);
+
+			WriteVarint(m_buffer, utf8.size());
+			WritePayload(m_buffer, reinterpret_cast<const uint8*>(utf8.data()), utf8.size());
+		}
+
+		template <class Type>
+		void write(const Array<Type>& values)
+		{
+			WriteVarint(m_buffer, values.size());
+			writeElements(values.data(), values.size());
+		}
+
+		template <class Type>
+		void write(const Grid<Type>& values)
+		{
+			WriteVarint(m_buffer, static_cast<uint32>(values.width()));
+			WriteVarint(m_buffer, static_cast<uint32>(values.height()));
+			writeElements(values.data(), values.num_elements());
+		}
+
+		template <class Type>
+		void write(const Optional<Type>& value)
+		{
+			m_buffer << static_cast<uint8>(value.has_value());
+
+			if (value)
+			{
+				write(*value);
+			}
+		}
+
+		template <class Type>
+		void write(const Type& value)
+		{
+			static_assert(IsPackedSerializable<Type>::value, "SivPhoton で送信できない型です。serialize(Archive&) でメンバを列挙してください。");
+
+			if constexpr (HasSerializeFunction<Type>)
+			{
+				// serialize() は読み書き兼用のため const が付いていない
+				const_cast<Type&>(value).serialize(*this);
+			}
+			else
+			{
+				WritePayload(m_buffer, &value, 1);
+			}
+		}
+
+		template <class Type>
+		void writeElements(const Type* values, const size_t count)
+		{
+			if constexpr (IsPackedMemcpyable<Type> && (not HasSerializeFunction<Type>))
+			{
+				WritePayload(m_buffer, values, count);
+			}
+			else
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					write(values[i]);
+				}
+			}
+		}
+	};
+
+	/// @brief パック形式のバイト列から値を読み取るアーカイブ
+	/// @remark バイト列が途中で終わっている場合や不正な場合は isValid() が false になり、以降の読み取りは何もしません。
+	class PackedReader
+	{
+	public:
+
+		PackedReader(const uint8* const begin, const uint8* const end) noexcept
+			: m_it{ begin }
+			, m_end{ end } {}
+
+		template <class... Args>
+		void operator()(Args&... args)
+		{
+			(read(args), ...);
+		}
+
+		/// @brief ここまでの読み取りがすべて成功したかを返します。
+		[[nodiscard]]
+		bool isValid() const noexcept
+		{
+			return m_valid;
+		}
+
+		/// @brief バイト列を最後まで読み取ったかを返します。
+		[[nodiscard]]
+		bool isEnd() const noexcept
+		{
+			return (m_it == m_end);
+		}
+
+	private:
+
+		const uint8* m_it;
+
+		const uint8* m_end;
+
+		bool m_valid = true;
+
+		[[nodiscard]]
+		size_t remaining() const noexcept
+		{
+			return static_cast<size_t>(m_end - m_it);
+		}
+
+		/// @brief 要素数を読み取ります。
+		/// @param minElementSize 要素 1 つあたりの最小のバイト数
+		/// @remark 残りのバイト列に収まらない要素数は不正とみなします。
+		[[nodiscard]]
+		bool readCount(size_t& count, const size_t minElementSize)
+		{
+			uint64 value = 0;
+
+			if ((not m_valid)
+				|| (not ReadVarint(m_it, m_end, value))
+				|| (minElementSize && ((remaining() / minElementSize) < value)))
+			{
+				m_valid = false;
+				return false;
+			}
+
+			count = static_cast<size_t>(value);
+			return true;
+		}
+
+		void readBytes(void* const dst, const size_t size)
+		{
+			if ((not m_valid)
+				|| (remaining() < size))
+			{
+				m_valid = false;
+				return;
+			}
+
+			if (size)
+			{
+				std::memcpy(dst, m_it, size);
+				m_it += size;
+			}
+		}
+
+		void read(String& value)
+		{
+			size_t length = 0;
+
+			if (not readCount(length, 1))
+			{
+				return;
+			}
+
+			value = Unicode::FromUTF8(std::string_view{ reinterpret_cast<const char*>(m_it), length });
+			m_it += length;
+		}
+
+		void read(bool& value)
+		{
+			uint8 byte = 0;
+			readBytes(&byte, 1);
+
+			// 0 と 1 以外のバイトを bool として読むと未定義動作になる
+			if (1 < byte)
+			{
+				m_valid = false;
+				return;
+			}
+
+			value = (byte != 0);
+		}
+
+		template <class Type>
+		void read(Array<Type>& values)
+		{
+			size_t count = 0;
+
+			if (not readCount(count, MinElementSize<Type>()))
+			{
+				return;
+			}
+
+			values.resize(count);
+			readElements(values.data(), count);
+		}
+
+		template <class Type>
+		void read(Grid<Type>& values)
+		{
+			size_t width = 0, height = 0;
+
+			if ((not readCount(width, 0))
+				|| (not readCount(height, 0)))
+			{
+				return;
+			}
+
+			if ((Largest<int32> < width)
+				|| (Largest<int32> < height)
+				|| (width && height && ((remaining() / MinElementSize<Type>() / width) < height)))
+			{
+				m_valid = false;
+				return;
+			}
+
+			values.resize(static_cast<int32>(width), static_cast<int32>(height));
+			readElements(values.data(), values.num_elements());
+		}
+
+		template <class Type>
+		void read(Optional<Type>& value)
+		{
+			uint8 hasValue = 0;
+			readBytes(&hasValue, 1);
+
+			if ((not m_valid) || (not hasValue))
+			{
+				value.reset();
+				return;
+			}
+
+			value.emplace();
+			read(*value);
+		}
+
+		template <class Type>
+		void read(Type& value)
+		{
+			static_assert(IsPackedSerializable<Type>::value, "SivPhoton で受信できない型です。serialize(Archive&) でメンバを列挙してください。");
+
+			if constexpr (HasSerializeFunction<Type>)
+			{
+				value.serialize(*this);
+			}
+			else
+			{
+				readBytes(&value, sizeof(Type));
+			}
+		}
+
+		template <class Type>
+		void readElements(Type* values, const size_t count)
+		{
+			if constexpr (IsPackedMemcpyable<Type> && (not HasSerializeFunction<Type>) && (not std::is_same_v<Type, bool>))
+			{
+				readBytes(values, (sizeof(Type) * count));
+			}
+			else
+			{
+				for (size_t i = 0; ((i < count) && m_valid); ++i)
+				{
+					read(values[i]);
+				}
+			}
+		}
+
+		/// @brief 要素 1 つあたりの最小のバイト数 (不正な要素数で巨大な確保をしないための検査に使う)
+		template <class Type>
+		[[nodiscard]]
+		static constexpr size_t MinElementSize() noexcept
+		{
+			if constexpr (IsPackedMemcpyable<Type> && (not HasSerializeFunction<Type>))
+			{
+				return sizeof(Type);
+			}
+			else
+			{
+				return 1;
+			}
+		}
+	};
+
+	/// @brief パック形式のバイト列から値を復元します。
+	/// @return 復元した値, バイト列が不正な場合や余りがある場合は none
+	template <class Type>
+	[[nodiscard]]
+	inline Optional<Type> ReadPackedValue(const uint8* const begin, const uint8* const end)
+	{
+		Type value{};
+		PackedReader reader{ begin, end };
+		reader(value);
+
+		if ((not reader.isValid())
+			|| (not reader.isEnd()))
+		{
+			return none;
+		}
+
+		return value;
+	}
+
+	/// @brief 値をパック形式にしたバイト列の FNV-1a ハッシュを返します。
+	/// @remark クラス型は serialize(Archive&) のメンバごとに書き込まれるため (IsPackedTrivial の型はパディングを含まない)、パディングのバイトはハッシュに含まれません。
+	template <class Type>
+	[[nodiscard]]
+	inline uint64 PackedChecksum(const Type& value)
+	{
+		Array<uint8> bytes;
+		PackedWriter{ bytes }(value);
+
+		uint64 hash = 14695981039346656037ull;
+
+		for (const uint8 byte : bytes)
+		{
+			hash ^= byte;
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	/// @brief 2 つの値をパック形式にしたバイト列が等しいかを返します。
+	/// @remark operator== を持たない型の比較に使います。PackedChecksum() と同様に、パディングのバイトは比較に含まれません。
+	template <class Type>
+	[[nodiscard]]
+	inline bool PackedEquals(const Type& a, const Type& b)
+	{
+		Array<uint8> bytesA, bytesB;
+		PackedWriter{ bytesA }(a);
+		PackedWriter{ bytesB }(b);
+		return (bytesA == bytesB);
+	}
+
+	/// @brief カスタムプロパティの表 (キーと、型を表す ID に続くパック形式の値)
+	using PropertyTable = HashTable<String, Array<uint8>>;
+
+	/// @brief パック形式のユーザ定義型を読み取った結果
+	struct WireCustomType
+	{
+		/// @brief 型 ID
+		uint32 typeID;
+
+		const uint8* begin;
+
+		const uint8* end;
+	};
+
+	/// @brief ユーザ定義型の値をパック形式でバッファの末尾に書き込みます。
+	/// @param typeID 型 ID
+	template <class Type>
+	inline void WriteCustomType(Array<uint8>& buffer, const uint32 typeID, const Type& value)
+	{
+		buffer << MakeWireTag(WireContainer::CustomType, WireElement{ 0 });
+		WriteVarint(buffer, typeID);
+		PackedWriter{ buffer }(value);
+	}
+
+	/// @brief パック形式のユーザ定義型のヘッダを読み取ります。
+	/// @return 読み取った結果, ユーザ定義型ではない場合は none
+	[[nodiscard]]
+	inline Optional<WireCustomType> ReadCustomTypeHeader(const uint8* const data, const size_t size) noexcept
+	{
+		if ((size == 0)
+			|| (static_cast<WireContainer>(data[0] >> 4) != WireContainer::CustomType))
+		{
+			return none;
+		}
+
+		const uint8* it = (data + 1);
+		const uint8* const end = (data + size);
+		uint64 typeID = 0;
+
+		if ((not ReadVarint(it, end, typeID))
+			|| (Largest<uint32> < typeID))
+		{
+			return none;
+		}
+
+		return WireCustomType{ static_cast<uint32>(typeID), it, end };
+	}
+}
@@ -0,0 +1,78 @@
+﻿# pragma once
+# include <atomic>
+# include <Siv3D.hpp>
+
+namespace s3d::detail
+{
+	/// @brief 1 つの書き込みスレッドと 1 つの読み取りスレッドの間で値を受け渡す、ロックフリーの固定長キュー
+	/// @tparam Type 要素の型
+	/// @remark 要素は作成時にすべて確保し、以降は同じ要素を使い回します。Array などのメンバは確保済みの容量が再利用されます。
+	template <class Type>
+	class SpscQueue
+	{
+	public:
+
+		/// @param capacity キューに入れられる要素の最大数
+		explicit SpscQueue(const size_t capacity)
+			: m_slots(capacity + 1) {}
+
+		/// @brief 書き込む要素を返します。書き込みスレッドから呼びます。
+		/// @return 書き込む要素, キューがいっぱいの場合は nullptr
+		/// @remark 要素に値を書き込んだ後、push() で読み取りスレッドに渡します。
+		[[nodiscard]]
+		Type* back() noexcept
+		{
+			const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+			if (next(tail) == m_head.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+
+			return &m_slots[tail];
+		}
+
+		/// @brief back() で書き込んだ要素を読み取りスレッドに渡します。書き込みスレッドから呼びます。
+		void push() noexcept
+		{
+			m_tail.store(next(m_tail.load(std::memory_order_relaxed)), std::memory_order_release);
+		}
+
+		/// @brief 最も古い要素を返します。読み取りスレッドから呼びます。
+		/// @return 最も古い要素, キューが空の場合は nullptr
+		[[nodiscard]]
+		Type* front() noexcept
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+
+			if (head == m_tail.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+
+			return &m_slots[head];
+		}
+
+		/// @brief front() で読み取った要素を書き込みスレッドに返します。読み取りスレッドから呼びます。
+		void pop() noexcept
+		{
+			m_head.store(next(m_head.load(std::memory_order_relaxed)), std::memory_order_release);
+		}
+
+	private:
+
+		Array<Type> m_slots;
+
+		/// @brief 読み取りスレッドが次に読み取る位置
+		alignas(64) std::atomic<size_t> m_head{ 0 };
+
+		/// @brief 書き込みスレッドが次に書き込む位置
+		alignas(64) std::atomic<size_t> m_tail{ 0 };
+
+		[[nodiscard]]
+		size_t next(const size_t index) const noexcept
+		{
+			return (((index + 1) == m_slots.size()) ? 0 : (index + 1));
+		}
+	};
+}
@@ -0,0 +1,1212 @@
+﻿# pragma once
+# include <bit>
+# include <Siv3D.hpp>
+
+// Array, Grid をひとつのバイト列に詰めて送受信するためのパック形式
+//
+// [型タグ 1 byte][可変長整数のサイズ][パディング][要素の並び]
+//
+// - 型タグ: 上位 4 bit がコンテナの種類 (WireContainer), 下位 4 bit が要素の型 (WireElement)
+// - 量子化の形式: 量子化された要素の場合のみ、型タグの直後に 1 byte (NetworkSystem::QuantizationFormat の値)
+// - サイズ: Array は要素数、Grid は幅と高さを LEB128 形式の可変長整数で格納 (Value は省略)
+// - パディング: 要素の並びの先頭が要素型のアラインメントに揃うように 0 を詰める
+// - 要素の並び: 要素をリトルエンディアンのまま隙間なく並べたもの
+//
+// Grid の差分送信 (GridKeyframe, GridDelta) ではサイズの前に通し番号を可変長整数で格納します。
+// GridDelta はサイズの後に [区間の数][(変化しなかったセルの数, 変化したセルの数) の並び] を格納し、
+// 要素の並びには変化したセルのみを並べます。
+//
+// String の要素の並びは、要素ごとに可変長整数のトークンと続くデータを並べます。
+// - トークンの最下位 bit が 1: 送信者の文字列表の ID (トークン >> 1) の文字列を参照
+// - 下位 2 bit が 10: 文字列表への登録。ID (可変長整数) と UTF-8 のバイト列 (トークン >> 2 バイト) が続く
+// - 下位 2 bit が 00: 登録しない文字列。UTF-8 のバイト列 (トークン >> 2 バイト) が続く
+// StringTable は Array と同じ形式で、参加した人に送信者の文字列表の登録だけを並べたものです (イベントとしては渡しません)。
+//
+// Batch は型タグの後に [イベントコード 1 byte][可変長整数のバイト数][イベントのバイト列] を送信した順に並べます。
+//
+// NetworkVars は型タグの後に [可変長整数の個数][(可変長整数の ID, 可変長整数のバイト数, 値のバイト列) の並び] を格納します。
+// 値は SivPhotonSerializer.hpp の形式で書き込みます。
+namespace s3d::detail
+{
+	static_assert(std::endian::native == std::endian::little, "SivPhoton のパック形式はリトルエンディアン環境のみ対応しています。");
+
+	/// @brief パック形式のコンテナの種類
+	enum class WireContainer : uint8
+	{
+		Array	= 0x1,
+
+		Grid	= 0x2,
+
+		/// @brief 要素ひとつ
+		Value	= 0x3,
+
+		/// @brief Grid の差分送信のキーフレーム
+		GridKeyframe	= 0x4,
+
+		/// @brief Grid の差分送信の差分
+		GridDelta		= 0x5,
+
+		/// @brief Grid の差分送信のキーフレームの再送要求
+		KeyframeRequest	= 0x6,
+
+		/// @brief ユーザ定義型 (SivPhotonSerializer.hpp)
+		CustomType		= 0x7,
+
+		/// @brief 1 フレームに送信したイベントをまとめたもの
+		Batch			= 0x8,
+
+		/// @brief NetworkVar の値 (変更されたもの、またはすべて)
+		NetworkVars		= 0x9,
+
+		/// @brief 参加した人に送る、送信者の文字列表の登録
+		StringTable		= 0xA,
+	};
+
+	/// @brief パック形式の要素の型
+	enum class WireElement : uint8
+	{
+		Int32	= 0x1,
+
+		Double	= 0x2,
+
+		Float	= 0x3,
+
+		Bool	= 0x4,
+
+		Point	= 0x5,
+
+		Vec2	= 0x6,
+
+		Rect	= 0x7,
+
+		Circle	= 0x8,
+
+		/// @brief 量子化された Vec2
+		QuantizedVec2	= 0x9,
+
+		/// @brief 量子化された Circle
+		QuantizedCircle	= 0xA,
+
+		/// @brief UTF-8 の文字列 (要素ごとにバイト数が異なる)
+		String	= 0xB,
+	};
+
+	template <class Type>
+	struct WireElementOf;
+
+	template <>
+	struct WireElementOf<int32> { static constexpr WireElement value = WireElement::Int32; };
+
+	template <>
+	struct WireElementOf<double> { static constexpr WireElement value = WireElement::Double; };
+
+	template <>
+	struct WireElementOf<float> { static constexpr WireElement value = WireElement::Float; };
+
+	template <>
+	struct WireElementOf<bool> { static constexpr WireElement value = WireElement::Bool; };
+
+	template <>
+	struct WireElementOf<Point> { static constexpr WireElement value = WireElement::Point; };
+
+	template <>
+	struct WireElementOf<Vec2> { static constexpr WireElement value = WireElement::Vec2; };
+
+	template <>
+	struct WireElementOf<Rect> { static constexpr WireElement value = WireElement::Rect; };
+
+	template <>
+	struct WireElementOf<Circle> { static constexpr WireElement value = WireElement::Circle; };
+
+	template <class Type>
+	inline constexpr WireElement WireElementOf_v = WireElementOf<Type>::value;
+
+	/// @brief 要素 1 つあたりのバイト数を返します。
+	/// @param element 要素の型
+	/// @return 要素 1 つあたりのバイト数、不明な型の場合は 0
+	[[nodiscard]]
+	constexpr size_t WireElementSize(const WireElement element) noexcept
+	{
+		switch (element)
+		{
+		case WireElement::Int32:
+			return sizeof(int32);
+		case WireElement::Double:
+			return sizeof(double);
+		case WireElement::Float:
+			return sizeof(float);
+		case WireElement::Bool:
+			return sizeof(bool);
+		case WireElement::Point:
+			return sizeof(Point);
+		case WireElement::Vec2:
+			return sizeof(Vec2);
+		case WireElement::Rect:
+			return sizeof(Rect);
+		case WireElement::Circle:
+			return sizeof(Circle);
+		default:
+			return 0;
+		}
+	}
+
+	/// @brief 要素の並びの先頭を揃えるアラインメントを返します。
+	/// @param element 要素の型
+	/// @return アラインメント、不明な型の場合は 1
+	[[nodiscard]]
+	constexpr size_t WireElementAlignment(const WireElement element) noexcept
+	{
+		switch (element)
+		{
+		case WireElement::Int32:
+			return alignof(int32);
+		case WireElement::Double:
+			return alignof(double);
+		case WireElement::Float:
+			return alignof(float);
+		case WireElement::Point:
+			return alignof(Point);
+		case WireElement::Vec2:
+			return alignof(Vec2);
+		case WireElement::Rect:
+			return alignof(Rect);
+		case WireElement::Circle:
+			return alignof(Circle);
+		default:
+			return 1;
+		}
+	}
+
+	/// @brief 受信した要素の並びが、その型の値として読める内容かを返します。
+	/// @param element 要素の型
+	/// @param payload 要素の並びの先頭
+	/// @param byteCount 要素の並びのバイト数
+	/// @return 読める場合 true, それ以外の場合は false
+	/// @remark bool は 0 と 1 以外のバイトを bool として読むと未定義動作になるため、1 バイトずつ確認します。
+	[[nodiscard]]
+	inline bool IsValidWirePayload(const WireElement element, const uint8* const payload, const size_t byteCount) noexcept
+	{
+		if (element != WireElement::Bool)
+		{
+			return true;
+		}
+
+		return std::all_of(payload, (payload + byteCount), [](const uint8 byte) { return (byte <= 1); });
+	}
+
+	/// @brief 量子化された要素かを返します。
+	[[nodiscard]]
+	constexpr bool IsQuantizedElement(const WireElement element) noexcept
+	{
+		return ((element == WireElement::QuantizedVec2)
+			|| (element == WireElement::QuantizedCircle));
+	}
+
+	/// @brief 量子化された座標 1 つあたりのバイト数を返します。
+	/// @param format 量子化の形式 (NetworkSystem::QuantizationFormat の値)
+	/// @return 座標 1 つあたりのバイト数、不明な形式の場合は 0
+	[[nodiscard]]
+	constexpr size_t WireCoordinateSize(const uint8 format) noexcept
+	{
+		switch (format)
+		{
+		case 1: // Float32
+			return 4;
+		case 2: // Float16
+			return 2;
+		case 3: // Fixed16
+			return 2;
+		case 4: // Fixed24
+			return 3;
+		default:
+			return 0;
+		}
+	}
+
+	/// @brief 量子化された要素 1 つあたりのバイト数を返します。
+	/// @param element 要素の型
+	/// @param format 量子化の形式 (NetworkSystem::QuantizationFormat の値)
+	/// @return 要素 1 つあたりのバイト数、不明な型や形式の場合は 0
+	[[nodiscard]]
+	constexpr size_t WireQuantizedElementSize(const WireElement element, const uint8 format) noexcept
+	{
+		switch (element)
+		{
+		case WireElement::QuantizedVec2:
+			return (2 * WireCoordinateSize(format));
+		case WireElement::QuantizedCircle:
+			return (3 * WireCoordinateSize(format));
+		default:
+			return 0;
+		}
+	}
+
+	[[nodiscard]]
+	constexpr uint8 MakeWireTag(const WireContainer container, const WireElement element) noexcept
+	{
+		return static_cast<uint8>((static_cast<uint8>(container) << 4) | static_cast<uint8>(element));
+	}
+
+	/// @brief パック形式のヘッダを読み取った結果
+	struct WireHeader
+	{
+		WireContainer container;
+
+		WireElement element;
+
+		/// @brief 量子化の形式 (NetworkSystem::QuantizationFormat の値), 量子化されていない場合は 0
+		uint8 format;
+
+		/// @brief Grid の場合は幅と高さ、Array の場合は (要素数, 1), Value の場合は (1, 1)
+		Size size;
+
+		/// @brief 要素数
+		size_t count;
+
+		/// @brief バイト列の先頭から要素の並びまでのバイト数
+		size_t payloadOffset;
+	};
+
+	/// @brief 可変長整数 (LEB128) を書き込みます。
+	inline void WriteVarint(Array<uint8>& buffer, uint64 value)
+	{
+		while (0x80 <= value)
+		{
+			buffer << static_cast<uint8>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+
+		buffer << static_cast<uint8>(value);
+	}
+
+	/// @brief 可変長整数 (LEB128) を読み取ります。
+	/// @param it 読み取り位置。読み取った分だけ進みます。
+	/// @param end バイト列の終端
+	/// @param value 読み取った値
+	/// @return 読み取りに成功した場合 true, バイト列が途中で終わっている場合は false
+	[[nodiscard]]
+	inline bool ReadVarint(const uint8*& it, const uint8* const end, uint64& value) noexcept
+	{
+		value = 0;
+
+		for (uint32 shift = 0; ((it != end) && (shift < 64)); shift += 7)
+		{
+			const uint8 byte = *it++;
+
+			value |= (static_cast<uint64>(byte & 0x7F) << shift);
+
+			if (not (byte & 0x80))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/// @brief 要素の並びを先頭 begin からのアラインメントに揃えるための 0 を書き込みます。
+	inline void WritePadding(Array<uint8>& buffer, const size_t begin, const size_t alignment)
+	{
+		while ((buffer.size() - begin) % alignment)
+		{
+			buffer << uint8{ 0 };
+		}
+	}
+
+	template <class Type>
+	inline void WritePayload(Array<uint8>& buffer, const Type* values, const size_t count)
+	{
+		const size_t offset = buffer.size();
+
+		buffer.resize(offset + (sizeof(Type) * count));
+
+		if (count)
+		{
+			std::memcpy(buffer.data() + offset, values, (sizeof(Type) * count));
+		}
+	}
+
+	/// @brief Array をパック形式でバッファの末尾に書き込みます。
+	template <class Type>
+	inline void WriteArray(Array<uint8>& buffer, const Array<Type>& values)
+	{
+		const size_t begin = buffer.size();
+
+		buffer << MakeWireTag(WireContainer::Array, WireElementOf_v<Type>);
+		WriteVarint(buffer, values.size());
+		WritePadding(buffer, begin, alignof(Type));
+		WritePayload(buffer, values.data(), values.size());
+	}
+
+	/// @brief Grid をパック形式でバッファの末尾に書き込みます。
+	template <class Type>
+	inline void WriteGrid(Array<uint8>& buffer, const Grid<Type>& values)
+	{
+		const size_t begin = buffer.size();
+
+		buffer << MakeWireTag(WireContainer::Grid, WireElementOf_v<Type>);
+		WriteVarint(buffer, static_cast<uint64>(values.width()));
+		WriteVarint(buffer, static_cast<uint64>(values.height()));
+		WritePadding(buffer, begin, alignof(Type));
+		WritePayload(buffer, values.data(), values.num_elements());
+	}
+
+	/// @brief 要素ひとつをパック形式でバッファの末尾に書き込みます。
+	template <class Type>
+	inline void WriteValue(Array<uint8>& buffer, const Type& value)
+	{
+		const size_t begin = buffer.size();
+
+		buffer << MakeWireTag(WireContainer::Value, WireElementOf_v<Type>);
+		WritePadding(buffer, begin, alignof(Type));
+		WritePayload(buffer, &value, 1);
+	}
+
+	/// @brief 量子化された要素の並びのヘッダをバッファの末尾に書き込みます。
+	/// @remark 続けて要素の座標を WireCoordinateSize(format) バイトずつ書き込みます。
+	inline void WriteQuantizedHeader(Array<uint8>& buffer, const WireContainer container, const WireElement element, const uint8 format, const Size size)
+	{
+		buffer << MakeWireTag(container, element);
+		buffer << format;
+
+		if (container == WireContainer::Array)
+		{
+			WriteVarint(buffer, static_cast<uint64>(size.x));
+		}
+		else if (container == WireContainer::Grid)
+		{
+			WriteVarint(buffer, static_cast<uint64>(size.x));
+			WriteVarint(buffer, static_cast<uint64>(size.y));
+		}
+	}
+
+	/// @brief パック形式のヘッダを読み取ります。
+	/// @param data バイト列の先頭
+	/// @param size バイト列のバイト数
+	/// @return ヘッダ。形式が不正な場合や要素の並びの長さが合わない場合は none
+	[[nodiscard]]
+	inline Optional<WireHeader> ReadWireHeader(const uint8* const data, const size_t size) noexcept
+	{
+		if (size == 0)
+		{
+			return none;
+		}
+
+		const uint8* it = data;
+		const uint8* const end = (data + size);
+
+		const uint8 tag = *it++;
+		const auto container = static_cast<WireContainer>(tag >> 4);
+		const auto element = static_cast<WireElement>(tag & 0xF);
+
+		uint8 format = 0;
+
+		if (IsQuantizedElement(element))
+		{
+			if (it == end)
+			{
+				return none;
+			}
+
+			format = *it++;
+		}
+
+		const size_t elementSize = (format ? WireQuantizedElementSize(element, format) : WireElementSize(element));
+
+		if (elementSize == 0)
+		{
+			return none;
+		}
+
+		uint64 width = 1;
+		uint64 height = 1;
+
+		if (container == WireContainer::Value)
+		{
+			// サイズは省略されている
+		}
+		else if (container == WireContainer::Array)
+		{
+			if (not ReadVarint(it, end, width))
+			{
+				return none;
+			}
+		}
+		else if (container == WireContainer::Grid)
+		{
+			if ((not ReadVarint(it, end, width))
+				|| (not ReadVarint(it, end, height)))
+			{
+				return none;
+			}
+		}
+		else
+		{
+			return none;
+		}
+
+		constexpr uint64 MaxExtent = static_cast<uint64>(std::numeric_limits<int32>::max());
+
+		if ((MaxExtent < width) || (MaxExtent < height))
+		{
+			return none;
+		}
+
+		const size_t alignment = (format ? 1 : WireElementAlignment(element));
+		const size_t payloadOffset = (((static_cast<size_t>(it - data) + alignment - 1) / alignment) * alignment);
+		const uint64 count = (width * height);
+
+		if ((size < payloadOffset)
+			|| (((size - payloadOffset) % elementSize) != 0)
+			|| (((size - payloadOffset) / elementSize) != count)
+			|| (not IsValidWirePayload(element, (data + payloadOffset), (size - payloadOffset))))
+		{
+			return none;
+		}
+
+		return WireHeader{ container, element, format, Size{ static_cast<int32>(width), static_cast<int32>(height) }, static_cast<size_t>(count), payloadOffset };
+	}
+
+	/// @brief Grid の差分送信のヘッダを読み取った結果
+	struct WireGridUpdate
+	{
+		/// @brief GridKeyframe または GridDelta
+		WireContainer container;
+
+		WireElement element;
+
+		/// @brief 通し番号
+		uint32 sequence;
+
+		Size size;
+
+		/// @brief バイト列の先頭
+		const uint8* begin;
+
+		/// @brief サイズの直後の読み取り位置
+		const uint8* it;
+
+		/// @brief バイト列の終端
+		const uint8* end;
+
+		/// @brief セルの数
+		[[nodiscard]]
+		size_t num_elements() const noexcept
+		{
+			return (static_cast<size_t>(size.x) * size.y);
+		}
+	};
+
+	/// @brief Grid の差分送信のキーフレームをバッファの末尾に書き込みます。
+	/// @param cells 全セルの要素の並び
+	inline void WriteGridKeyframe(Array<uint8>& buffer, const WireElement element, const uint32 sequence, const Size size, const uint8* cells)
+	{
+		const size_t begin = buffer.size();
+		const size_t byteCount = (static_cast<size_t>(size.x) * size.y * WireElementSize(element));
+
+		buffer << MakeWireTag(WireContainer::GridKeyframe, element);
+		WriteVarint(buffer, sequence);
+		WriteVarint(buffer, static_cast<uint64>(size.x));
+		WriteVarint(buffer, static_cast<uint64>(size.y));
+		WritePadding(buffer, begin, WireElementAlignment(element));
+		WritePayload(buffer, cells, byteCount);
+	}
+
+	/// @brief Grid の差分送信の差分をバッファの末尾に書き込みます。
+	/// @param previous 前回送信した全セルの要素の並び
+	/// @param current 今回送信する全セルの要素の並び
+	/// @return 差分を書き込んだ場合 true, 差分がキーフレーム以上の大きさになるため何も書き込まなかった場合は false
+	inline bool WriteGridDelta(Array<uint8>& buffer, const WireElement element, const uint32 sequence, const Size size, const uint8* previous, const uint8* current)
+	{
+		const size_t begin = buffer.size();
+		const size_t elementSize = WireElementSize(element);
+		const size_t cellCount = (static_cast<size_t>(size.x) * size.y);
+
+		// (変化しなかったセルの数, 変化したセルの数) の並び
+		Array<std::pair<size_t, size_t>> runs;
+		size_t changedCount = 0;
+
+		for (size_t i = 0; i < cellCount;)
+		{
+			const size_t unchangedBegin = i;
+
+			while ((i < cellCount) && (std::memcmp(previous + (i * elementSize), current + (i * elementSize), elementSize) == 0))
+			{
+				++i;
+			}
+
+			if (i == cellCount)
+			{
+				break;
+			}
+
+			const size_t changedBegin = i;
+
+			while ((i < cellCount) && (std::memcmp(previous + (i * elementSize), current + (i * elementSize), elementSize) != 0))
+			{
+				++i;
+			}
+
+			runs.emplace_back((changedBegin - unchangedBegin), (i - changedBegin));
+			changedCount += (i - changedBegin);
+		}
+
+		buffer << MakeWireTag(WireContainer::GridDelta, element);
+		WriteVarint(buffer, sequence);
+		WriteVarint(buffer, static_cast<uint64>(size.x));
+		WriteVarint(buffer, static_cast<uint64>(size.y));
+		WriteVarint(buffer, runs.size());
+
+		for (const auto& [unchanged, changed] : runs)
+		{
+			WriteVarint(buffer, unchanged);
+			WriteVarint(buffer, changed);
+		}
+
+		WritePadding(buffer, begin, WireElementAlignment(element));
+
+		if ((cellCount * elementSize) <= ((buffer.size() - begin) + (changedCount * elementSize)))
+		{
+			buffer.resize(begin);
+			return false;
+		}
+
+		size_t cell = 0;
+
+		for (const auto& [unchanged, changed] : runs)
+		{
+			cell += unchanged;
+			WritePayload(buffer, (current + (cell * elementSize)), (changed * elementSize));
+			cell += changed;
+		}
+
+		return true;
+	}
+
+	/// @brief Grid の差分送信のヘッダを読み取ります。
+	/// @param data バイト列の先頭
+	/// @param size バイト列のバイト数
+	/// @return ヘッダ。GridKeyframe, GridDelta 以外や形式が不正な場合は none
+	[[nodiscard]]
+	inline Optional<WireGridUpdate> ReadGridUpdateHeader(const uint8* const data, const size_t size) noexcept
+	{
+		if (size == 0)
+		{
+			return none;
+		}
+
+		const uint8* it = data;
+		const uint8* const end = (data + size);
+
+		const uint8 tag = *it++;
+		const auto container = static_cast<WireContainer>(tag >> 4);
+		const auto element = static_cast<WireElement>(tag & 0xF);
+
+		if (((container != WireContainer::GridKeyframe) && (container != WireContainer::GridDelta))
+			|| (WireElementSize(element) == 0))
+		{
+			return none;
+		}
+
+		uint64 sequence = 0;
+		uint64 width = 0;
+		uint64 height = 0;
+
+		if ((not ReadVarint(it, end, sequence))
+			|| (not ReadVarint(it, end, width))
+			|| (not ReadVarint(it, end, height)))
+		{
+			return none;
+		}
+
+		constexpr uint64 MaxExtent = static_cast<uint64>(std::numeric_limits<int32>::max());
+
+		if ((MaxExtent < width) || (MaxExtent < height))
+		{
+			return none;
+		}
+
+		return WireGridUpdate{ container, element, static_cast<uint32>(sequence), Size{ static_cast<int32>(width), static_cast<int32>(height) }, data, it, end };
+	}
+
+	/// @brief Grid の差分送信のキーフレームを確認し、全セルの要素の並びを返します。
+	/// @param update ReadGridUpdateHeader() で読み取ったヘッダ
+	/// @return 全セルの要素の並びの先頭 (バイト数は update.num_elements() * WireElementSize(update.element)), 形式が不正な場合は nullptr
+	/// @remark 幅と高さは送信者が決めるため、セルの数が実際に受信したバイト数と一致することを、オーバーフローしない除算で確認します。
+	/// 受信側はこの確認の後で書き込み先を確保してください。
+	[[nodiscard]]
+	inline const uint8* ReadGridKeyframe(const WireGridUpdate& update) noexcept
+	{
+		const size_t elementSize = WireElementSize(update.element);
+		const size_t alignment = WireElementAlignment(update.element);
+		const size_t payloadOffset = (((static_cast<size_t>(update.it - update.begin) + alignment - 1) / alignment) * alignment);
+		const size_t size = static_cast<size_t>(update.end - update.begin);
+
+		// 幅と高さはそれぞれ INT32_MAX 以下のため、積は uint64 に収まる
+		const uint64 cellCount = (static_cast<uint64>(update.size.x) * static_cast<uint64>(update.size.y));
+
+		if ((size < payloadOffset)
+			|| (((size - payloadOffset) % elementSize) != 0)
+			|| (((size - payloadOffset) / elementSize) != cellCount)
+			|| (not IsValidWirePayload(update.element, (update.begin + payloadOffset), (size - payloadOffset))))
+		{
+			return nullptr;
+		}
+
+		return (update.begin + payloadOffset);
+	}
+
+	/// @brief Grid の差分送信の差分を適用します。
+	/// @param update ReadGridUpdateHeader() で読み取ったヘッダ
+	/// @param cells 前回までの全セルの要素の並び。変化したセルが書き換えられます。
+	/// @return 適用に成功した場合 true, 形式が不正な場合は cells を変更せずに false
+	[[nodiscard]]
+	inline bool ApplyGridDelta(const WireGridUpdate& update, uint8* cells) noexcept
+	{
+		const size_t elementSize = WireElementSize(update.element);
+		const size_t cellCount = update.num_elements();
+
+		const uint8* it = update.it;
+		uint64 runCount = 0;
+
+		if (not ReadVarint(it, update.end, runCount))
+		{
+			return false;
+		}
+
+		// 1 回目: 区間がセルの数に収まっているかを確認する
+		const uint8* const runsBegin = it;
+		uint64 cell = 0;
+		uint64 changedCount = 0;
+
+		for (uint64 i = 0; i < runCount; ++i)
+		{
+			uint64 unchanged = 0;
+			uint64 changed = 0;
+
+			if ((not ReadVarint(it, update.end, unchanged))
+				|| (not ReadVarint(it, update.end, changed))
+				|| ((cellCount - cell) < unchanged)
+				|| ((cellCount - cell - unchanged) < changed))
+			{
+				return false;
+			}
+
+			cell += (unchanged + changed);
+			changedCount += changed;
+		}
+
+		const size_t alignment = WireElementAlignment(update.element);
+		const size_t payloadOffset = (((static_cast<size_t>(it - update.begin) + alignment - 1) / alignment) * alignment);
+		const size_t size = static_cast<size_t>(update.end - update.begin);
+
+		if ((size < payloadOffset)
+			|| ((size - payloadOffset) != (changedCount * elementSize))
+			|| (not IsValidWirePayload(update.element, (update.begin + payloadOffset), (changedCount * elementSize))))
+		{
+			return false;
+		}
+
+		// 2 回目: 変化したセルを書き換える
+		const uint8* values = (update.begin + payloadOffset);
+		it = runsBegin;
+		cell = 0;
+
+		for (uint64 i = 0; i < runCount; ++i)
+		{
+			uint64 unchanged = 0;
+			uint64 changed = 0;
+
+			(void)ReadVarint(it, update.end, unchanged);
+			(void)ReadVarint(it, update.end, changed);
+
+			cell += unchanged;
+			std::memcpy((cells + (cell * elementSize)), values, (changed * elementSize));
+			values += (changed * elementSize);
+			cell += changed;
+		}
+
+		return true;
+	}
+
+	/// @brief Grid の差分送信のキーフレームの再送要求をバッファの末尾に書き込みます。
+	/// @param playerID キーフレームを再送してほしいプレイヤーの ID
+	inline void WriteKeyframeRequest(Array<uint8>& buffer, const int32 playerID)
+	{
+		buffer << MakeWireTag(WireContainer::KeyframeRequest, WireElement{ 0 });
+		WriteVarint(buffer, static_cast<uint32>(playerID));
+	}
+
+	/// @brief Grid の差分送信のキーフレームの再送要求を読み取ります。
+	/// @return キーフレームを再送してほしいプレイヤーの ID, 再送要求ではない場合は none
+	[[nodiscard]]
+	inline Optional<int32> ReadKeyframeRequest(const uint8* const data, const size_t size) noexcept
+	{
+		if ((size == 0)
+			|| (static_cast<WireContainer>(data[0] >> 4) != WireContainer::KeyframeRequest))
+		{
+			return none;
+		}
+
+		const uint8* it = (data + 1);
+		uint64 playerID = 0;
+
+		if (not ReadVarint(it, (data + size), playerID))
+		{
+			return none;
+		}
+
+		return static_cast<int32>(playerID);
+	}
+
+	/// @brief キーフレームの再送要求に応答がないときに、再び要求するまでに受信する差分の数
+	/// @remark 信頼性のない送信では、再送要求やキーフレームが失われることがあるため
+	inline constexpr uint32 WireKeyframeRequestRetry = 30;
+
+	/// @brief バイト列が Grid の差分送信に関するものかを返します。
+	[[nodiscard]]
+	inline bool IsGridReplication(const uint8* const data, const size_t size) noexcept
+	{
+		if (size == 0)
+		{
+			return false;
+		}
+
+		const auto container = static_cast<WireContainer>(data[0] >> 4);
+
+		return ((container == WireContainer::GridKeyframe)
+			|| (container == WireContainer::GridDelta)
+			|| (container == WireContainer::KeyframeRequest));
+	}
+
+	/// @brief Batch を送信するときのイベントコード
+	/// @remark 受信側は型タグで Batch を判別するため、この値は受信したイベントのイベントコードとしては使われません。
+	inline constexpr uint8 WireBatchEventCode = 0;
+
+	/// @brief Batch がこのバイト数を超えたら、フレームの途中でも送信します。
+	/// @remark 信頼性のない送信で、分割されたパケットのひとつが失われてイベントがまとめて失われるのを避けるため。
+	inline constexpr size_t WireBatchFlushSize = 1024;
+
+	/// @brief Batch にイベントを追加します。
+	/// @param batch Batch。空の場合は型タグを書き込んでから追加します。
+	/// @param eventCode イベントコード
+	/// @param event パック形式のイベントのバイト列
+	inline void AppendBatchEntry(Array<uint8>& batch, const uint8 eventCode, const Array<uint8>& event)
+	{
+		if (batch.isEmpty())
+		{
+			batch << MakeWireTag(WireContainer::Batch, WireElement{ 0 });
+		}
+
+		batch << eventCode;
+		WriteVarint(batch, event.size());
+		batch.insert(batch.end(), event.begin(), event.end());
+	}
+
+	/// @brief バイト列が Batch かを返します。
+	[[nodiscard]]
+	inline bool IsWireBatch(const uint8* const data, const size_t size) noexcept
+	{
+		return ((size != 0)
+			&& (static_cast<WireContainer>(data[0] >> 4) == WireContainer::Batch));
+	}
+
+	/// @brief Batch に含まれるイベントをひとつ読み取ります。
+	/// @param it 読み取り位置。最初は Batch の型タグの直後を指定します。読み取った分だけ進みます。
+	/// @param end バイト列の終端
+	/// @param eventCode イベントコード
+	/// @param event イベントのバイト列の先頭
+	/// @param eventSize イベントのバイト数
+	/// @return 読み取りに成功した場合 true, 終端に達した場合や形式が不正な場合は false
+	[[nodiscard]]
+	inline bool ReadBatchEntry(const uint8*& it, const uint8* const end, uint8& eventCode, const uint8*& event, size_t& eventSize) noexcept
+	{
+		if (it == end)
+		{
+			return false;
+		}
+
+		eventCode = *it++;
+
+		uint64 size = 0;
+
+		if ((not ReadVarint(it, end, size))
+			|| (static_cast<uint64>(end - it) < size))
+		{
+			return false;
+		}
+
+		event = it;
+		eventSize = static_cast<size_t>(size);
+		it += eventSize;
+		return true;
+	}
+
+	/// @brief NetworkVars を送信するときのイベントコード
+	/// @remark 受信側は型タグで NetworkVars を判別するため、この値は受信したイベントのイベントコードとしては使われません。
+	inline constexpr uint8 WireNetworkVarsEventCode = 0;
+
+	/// @brief NetworkVars の読み取り位置
+	struct WireNetworkVars
+	{
+		/// @brief 値の個数
+		size_t count;
+
+		/// @brief 最初の値の読み取り位置
+		const uint8* it;
+
+		const uint8* end;
+	};
+
+	/// @brief NetworkVars の型タグと個数をバッファの末尾に書き込みます。
+	/// @param count 値の個数
+	inline void WriteNetworkVarsHeader(Array<uint8>& buffer, const size_t count)
+	{
+		buffer << MakeWireTag(WireContainer::NetworkVars, WireElement{ 0 });
+		WriteVarint(buffer, count);
+	}
+
+	/// @brief NetworkVars に値をひとつ追加します。
+	/// @param id NetworkVar の ID
+	/// @param value 値のバイト列
+	inline void AppendNetworkVar(Array<uint8>& buffer, const uint32 id, const Array<uint8>& value)
+	{
+		WriteVarint(buffer, id);
+		WriteVarint(buffer, value.size());
+		buffer.insert(buffer.end(), value.begin(), value.end());
+	}
+
+	/// @brief NetworkVars の型タグと個数を読み取ります。
+	/// @return 読み取り位置, NetworkVars ではない場合は none
+	[[nodiscard]]
+	inline Optional<WireNetworkVars> ReadNetworkVarsHeader(const uint8* const data, const size_t size) noexcept
+	{
+		if ((size == 0)
+			|| (static_cast<WireContainer>(data[0] >> 4) != WireContainer::NetworkVars))
+		{
+			return none;
+		}
+
+		const uint8* it = (data + 1);
+		const uint8* const end = (data + size);
+		uint64 count = 0;
+
+		if (not ReadVarint(it, end, count))
+		{
+			return none;
+		}
+
+		return WireNetworkVars{ static_cast<size_t>(count), it, end };
+	}
+
+	/// @brief NetworkVars に含まれる値をひとつ読み取ります。
+	/// @param vars 読み取り位置。読み取った分だけ進みます。
+	/// @param id NetworkVar の ID
+	/// @param value 値のバイト列の先頭
+	/// @param valueSize 値のバイト数
+	/// @return 読み取りに成功した場合 true, 形式が不正な場合は false
+	[[nodiscard]]
+	inline bool ReadNetworkVar(WireNetworkVars& vars, uint32& id, const uint8*& value, size_t& valueSize) noexcept
+	{
+		uint64 id64 = 0, size = 0;
+
+		if ((not ReadVarint(vars.it, vars.end, id64))
+			|| (Largest<uint32> < id64)
+			|| (not ReadVarint(vars.it, vars.end, size))
+			|| (static_cast<uint64>(vars.end - vars.it) < size))
+		{
+			return false;
+		}
+
+		id = static_cast<uint32>(id64);
+		value = vars.it;
+		valueSize = static_cast<size_t>(size);
+		vars.it += valueSize;
+		return true;
+	}
+
+	/// @brief 送信者ごとの文字列表に登録する文字列の最大数
+	inline constexpr size_t WireMaxInternedStrings = 4096;
+
+	/// @brief 文字列表に登録する文字列の UTF-8 での最大バイト数
+	inline constexpr size_t WireMaxInternedStringLength = 256;
+
+	/// @brief StringTable を送信するときのイベントコード
+	/// @remark 受信側は型タグで StringTable を判別するため、この値は受信したイベントのイベントコードとしては使われません。
+	inline constexpr uint8 WireStringTableEventCode = 0;
+
+	/// @brief StringTable ひとつに含める文字列の UTF-8 での合計バイト数の目安
+	/// @remark 文字列表が大きい場合は、このバイト数ごとに分けて送信します。
+	inline constexpr size_t WireStringTableChunkSize = 8192;
+
+	/// @brief 文字列表の登録を待つ間、送信者ごとに保留するイベントの最大数
+	inline constexpr size_t WireMaxPendingStringEvents = 256;
+
+	/// @brief 文字列を UTF-8 にしたときのバイト数を返します。
+	[[nodiscard]]
+	inline size_t UTF8Length(const StringView s) noexcept
+	{
+		size_t length = 0;
+
+		for (const char32 ch : s)
+		{
+			length += ((ch < 0x80) ? 1 : (ch < 0x800) ? 2 : (ch < 0x10000) ? 3 : 4);
+		}
+
+		return length;
+	}
+
+	/// @brief 文字列を UTF-8 でバッファの末尾に書き込みます。
+	/// @param length UTF8Length(s) の値
+	inline void WriteUTF8(Array<uint8>& buffer, const StringView s, const size_t length)
+	{
+		const size_t offset = buffer.size();
+
+		buffer.resize(offset + length);
+
+		uint8* out = (buffer.data() + offset);
+
+		for (const char32 ch : s)
+		{
+			if (ch < 0x80)
+			{
+				*out++ = static_cast<uint8>(ch);
+			}
+			else if (ch < 0x800)
+			{
+				*out++ = static_cast<uint8>(0xC0 | (ch >> 6));
+				*out++ = static_cast<uint8>(0x80 | (ch & 0x3F));
+			}
+			else if (ch < 0x10000)
+			{
+				*out++ = static_cast<uint8>(0xE0 | (ch >> 12));
+				*out++ = static_cast<uint8>(0x80 | ((ch >> 6) & 0x3F));
+				*out++ = static_cast<uint8>(0x80 | (ch & 0x3F));
+			}
+			else
+			{
+				*out++ = static_cast<uint8>(0xF0 | ((ch >> 18) & 0x07));
+				*out++ = static_cast<uint8>(0x80 | ((ch >> 12) & 0x3F));
+				*out++ = static_cast<uint8>(0x80 | ((ch >> 6) & 0x3F));
+				*out++ = static_cast<uint8>(0x80 | (ch & 0x3F));
+			}
+		}
+	}
+
+	/// @brief UTF-8 のバイト列を文字列の末尾に追加します。
+	/// @remark 不正なバイト列は U+FFFD に置き換えます。
+	inline void AppendUTF8(String& s, const uint8* it, const uint8* const end)
+	{
+		while (it != end)
+		{
+			const uint8 lead = *it++;
+
+			if (lead < 0x80)
+			{
+				s.push_back(static_cast<char32>(lead));
+				continue;
+			}
+
+			const size_t trailing = ((lead & 0xE0) == 0xC0) ? 1 : ((lead & 0xF0) == 0xE0) ? 2 : ((lead & 0xF8) == 0xF0) ? 3 : 0;
+
+			if ((trailing == 0)
+				|| (static_cast<size_t>(end - it) < trailing))
+			{
+				s.push_back(U'\uFFFD');
+				continue;
+			}
+
+			char32 ch = (lead & (0x3F >> trailing));
+			bool valid = true;
+
+			for (size_t i = 0; i < trailing; ++i)
+			{
+				if ((it[i] & 0xC0) != 0x80)
+				{
+					valid = false;
+					break;
+				}
+
+				ch = ((ch << 6) | (it[i] & 0x3F));
+			}
+
+			if (not valid)
+			{
+				s.push_back(U'\uFFFD');
+				continue;
+			}
+
+			it += trailing;
+			s.push_back(ch);
+		}
+	}
+
+	/// @brief String の要素の並びのヘッダをバッファの末尾に書き込みます。
+	/// @remark 続けて要素ごとに WriteStringLiteral, WriteStringDefinition, WriteStringReference のいずれかで書き込みます。
+	inline void WriteStringHeader(Array<uint8>& buffer, const WireContainer container, const Size size)
+	{
+		buffer << MakeWireTag(container, WireElement::String);
+
+		if ((container == WireContainer::Array)
+			|| (container == WireContainer::StringTable))
+		{
+			WriteVarint(buffer, static_cast<uint64>(size.x));
+		}
+		else if (container == WireContainer::Grid)
+		{
+			WriteVarint(buffer, static_cast<uint64>(size.x));
+			WriteVarint(buffer, static_cast<uint64>(size.y));
+		}
+	}
+
+	/// @brief 文字列表に登録しない文字列を書き込みます。
+	inline void WriteStringLiteral(Array<uint8>& buffer, const StringView s, const size_t length)
+	{
+		WriteVarint(buffer, (static_cast<uint64>(length) << 2));
+		WriteUTF8(buffer, s, length);
+	}
+
+	/// @brief 文字列を文字列表に登録して書き込みます。
+	inline void WriteStringDefinition(Array<uint8>& buffer, const uint32 id, const StringView s, const size_t length)
+	{
+		WriteVarint(buffer, ((static_cast<uint64>(length) << 2) | 0b10));
+		WriteVarint(buffer, id);
+		WriteUTF8(buffer, s, length);
+	}
+
+	/// @brief 文字列表に登録済みの文字列を参照します。
+	inline void WriteStringReference(Array<uint8>& buffer, const uint32 id)
+	{
+		WriteVarint(buffer, ((static_cast<uint64>(id) << 1) | 0b1));
+	}
+
+	/// @brief String の要素の並びのヘッダを読み取った結果
+	struct WireStringHeader
+	{
+		WireContainer container;
+
+		/// @brief Grid の場合は幅と高さ、Array の場合は (要素数, 1), Value の場合は (1, 1)
+		Size size;
+
+		/// @brief 要素数
+		size_t count;
+
+		/// @brief 最初の要素の読み取り位置
+		const uint8* it;
+
+		/// @brief バイト列の終端
+		const uint8* end;
+	};
+
+	/// @brief String の要素の並びのヘッダを読み取ります。
+	/// @return 読み取った結果, String の要素の並びではない場合や形式が不正な場合は none
+	[[nodiscard]]
+	inline Optional<WireStringHeader> ReadStringHeader(const uint8* const data, const size_t size) noexcept
+	{
+		if ((size == 0)
+			|| (static_cast<WireElement>(data[0] & 0xF) != WireElement::String))
+		{
+			return none;
+		}
+
+		const auto container = static_cast<WireContainer>(data[0] >> 4);
+		const uint8* it = (data + 1);
+		const uint8* const end = (data + size);
+
+		uint64 width = 1;
+		uint64 height = 1;
+
+		if ((container == WireContainer::Array)
+			|| (container == WireContainer::StringTable))
+		{
+			if (not ReadVarint(it, end, width))
+			{
+				return none;
+			}
+		}
+		else if (container == WireContainer::Grid)
+		{
+			if ((not ReadVarint(it, end, width))
+				|| (not ReadVarint(it, end, height)))
+			{
+				return none;
+			}
+		}
+		else if (container != WireContainer::Value)
+		{
+			return none;
+		}
+
+		// 要素は最低 1 バイト
+		const uint64 remaining = static_cast<uint64>(end - it);
+
+		if ((remaining < width)
+			|| (remaining < height)
+			|| (width && ((remaining / width) < height)))
+		{
+			return none;
+		}
+
+		return WireStringHeader{ container, Size{ static_cast<int32>(width), static_cast<int32>(height) }, static_cast<size_t>(width * height), it, end };
+	}
+
+	/// @brief String の要素ひとつを読み取った結果
+	struct WireStringToken
+	{
+		/// @brief 文字列表の ID を参照しているか
+		bool isReference;
+
+		/// @brief 文字列表に登録するか
+		bool isDefinition;
+
+		/// @brief 文字列表の ID
+		uint32 id;
+
+		/// @brief UTF-8 のバイト列の先頭 (参照の場合は nullptr)
+		const uint8* begin;
+
+		/// @brief UTF-8 のバイト列の終端 (参照の場合は nullptr)
+		const uint8* end;
+	};
+
+	/// @brief String の要素をひとつ読み取ります。
+	/// @param it 読み取り位置。読み取った分だけ進みます。
+	/// @return 読み取った結果, 形式が不正な場合は none
+	[[nodiscard]]
+	inline Optional<WireStringToken> ReadStringToken(const uint8*& it, const uint8* const end) noexcept
+	{
+		uint64 token = 0;
+
+		if (not ReadVarint(it, end, token))
+		{
+			return none;
+		}
+
+		if (token & 0b1)
+		{
+			const uint64 id = (token >> 1);
+
+			if (WireMaxInternedStrings <= id)
+			{
+				return none;
+			}
+
+			return WireStringToken{ true, false, static_cast<uint32>(id), nullptr, nullptr };
+		}
+
+		const bool isDefinition = ((token & 0b10) != 0);
+		const uint64 length = (token >> 2);
+		uint64 id = 0;
+
+		if ((isDefinition && ((not ReadVarint(it, end, id)) || (WireMaxInternedStrings <= id)))
+			|| (static_cast<uint64>(end - it) < length))
+		{
+			return none;
+		}
+
+		const uint8* begin = it;
+		it += length;
+
+		return WireStringToken{ false, isDefinition, static_cast<uint32>(id), begin, it };
+	}
+}